@@ -4,6 +4,7 @@
 #include <locale>
 
 #include <benchmark.hpp>
+#include <test_contracts.hpp>
 
 namespace eosio::benchmark {
 
@@ -15,7 +16,10 @@ std::map<std::string, std::function<void()>> features {
    { "key", key_benchmarking },
    { "hash", hash_benchmarking },
    { "blake2", blake2_benchmarking },
-   { "bls", bls_benchmarking }
+   { "bls", bls_benchmarking },
+   { "wasm", wasm_benchmarking },
+   { "db", db_benchmarking },
+   { "transaction", transaction_benchmarking }
 };
 
 // values to control cout format
@@ -25,6 +29,7 @@ constexpr auto time_width = 12;
 constexpr auto ns_width = 2;
 
 uint32_t num_runs = 1;
+uint32_t trx_batch_size = 100;
 
 std::map<std::string, std::function<void()>> get_features() {
    return features;
@@ -34,6 +39,18 @@ void set_num_runs(uint32_t runs) {
    num_runs = runs;
 }
 
+uint32_t get_num_runs() {
+   return num_runs;
+}
+
+void set_trx_batch_size(uint32_t size) {
+   trx_batch_size = size;
+}
+
+uint32_t get_trx_batch_size() {
+   return trx_batch_size;
+}
+
 void print_header() {
    std::cout << std::left << std::setw(name_width) << "function"
       << std::setw(runs_width) << "runs"
@@ -57,6 +74,52 @@ void print_results(std::string name, uint32_t runs, uint64_t total, uint64_t min
       << std::endl;
 }
 
+action_in_benchmark::action_in_benchmark(const configure_t& configure, const char* wast) {
+   using namespace eosio::chain;
+   using namespace eosio::testing;
+
+   // prevent logging from intertwining with the output of benchmark results
+   fc::logger::get(DEFAULT_LOGGER).set_log_level(fc::log_level::off);
+
+   // create a chain
+   auto conf_genesis = tester::default_config( tempdir );
+   if (configure)
+      configure(conf_genesis.first, conf_genesis.second);
+   chain = std::make_unique<tester>(conf_genesis.first, conf_genesis.second);
+   chain->execute_setup_policy( setup_policy::full );
+
+   // create account and deploy contract for a temp transaction
+   chain->create_accounts( {receiver()} );
+   if (wast) {
+      chain->set_code( receiver(), wast );
+   } else {
+      chain->set_code( receiver(), test_contracts::payloadless_wasm() );
+      chain->set_abi( receiver(), test_contracts::payloadless_abi() );
+   }
+   chain->produce_block();
+
+   // construct a signed transaction
+   signed_transaction trx;
+   trx.actions.emplace_back( vector<permission_level>{{receiver(), config::active_name}}, receiver(), "doit"_n, bytes{} );
+   chain->set_transaction_headers(trx);
+   trx.sign( chain->get_private_key( receiver(), "active" ), chain->control->get_chain_id() );
+   ptrx = std::make_unique<packed_transaction>(trx, packed_transaction::compression_type::none);
+
+   // build transaction context from the packed transaction
+   timer = std::make_unique<platform_timer>();
+   trx_timer = std::make_unique<transaction_checktime_timer>(*timer);
+   trx_ctx = std::make_unique<transaction_context>(*chain->control, *ptrx, ptrx->id(), std::move(*trx_timer));
+   trx_ctx->max_transaction_time_subjective = fc::microseconds::maximum();
+   trx_ctx->init_for_input_trx( ptrx->get_unprunable_size(), ptrx->get_prunable_size() );
+   trx_ctx->exec(); // this is required to generate action traces to be used by apply_context constructor
+
+   new_apply_context();
+}
+
+void action_in_benchmark::new_apply_context() {
+   apply_ctx = std::make_unique<eosio::chain::apply_context>(*chain->control, *trx_ctx, 1);
+}
+
 bytes to_bytes(const std::string& source) {
    bytes output(source.length()/2);
    fc::from_hex(source, output.data(), output.size());
@@ -6,11 +6,38 @@
 #include <limits>
 
 #include <fc/crypto/hex.hpp>
+#include <eosio/chain/apply_context.hpp>
+#include <eosio/testing/tester.hpp>
 
 namespace eosio::benchmark {
 using bytes = std::vector<char>;
 
+// A chain with the payloadless contract deployed, and the transaction_context and apply_context of a
+// transaction calling it, to benchmark what runs in the context of an action, e.g. host functions.
+struct action_in_benchmark {
+   using configure_t = std::function<void(eosio::chain::controller::config&, eosio::chain::genesis_state&)>;
+
+   // configure adjusts the chain before it is created, wast replaces the payloadless contract when given
+   explicit action_in_benchmark(const configure_t& configure = {}, const char* wast = nullptr);
+
+   // replaces apply_ctx with the context of a next action, which has not done anything yet
+   void new_apply_context();
+
+   eosio::chain::name receiver() const { return eosio::chain::string_to_name("payloadless"); }
+
+   fc::temp_directory                                          tempdir;
+   std::unique_ptr<eosio::testing::tester>                     chain;
+   std::unique_ptr<eosio::chain::packed_transaction>           ptrx;
+   std::unique_ptr<eosio::chain::platform_timer>               timer;
+   std::unique_ptr<eosio::chain::transaction_checktime_timer>  trx_timer;
+   std::unique_ptr<eosio::chain::transaction_context>          trx_ctx;
+   std::unique_ptr<eosio::chain::apply_context>                apply_ctx;
+};
+
 void set_num_runs(uint32_t runs);
+uint32_t get_num_runs();
+void set_trx_batch_size(uint32_t size);
+uint32_t get_trx_batch_size();
 std::map<std::string, std::function<void()>> get_features();
 void print_header();
 bytes to_bytes(const std::string& source);
@@ -21,6 +48,9 @@ void key_benchmarking();
 void hash_benchmarking();
 void blake2_benchmarking();
 void bls_benchmarking();
+void wasm_benchmarking();
+void db_benchmarking();
+void transaction_benchmarking();
 
 void benchmarking(const std::string& name, const std::function<void()>& func); 
 
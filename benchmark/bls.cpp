@@ -23,72 +23,18 @@ namespace eosio::benchmark {
 // because host functions are implemented in
 // eosio::chain::webassembly::interface class.
 struct interface_in_benchmark {
-   interface_in_benchmark() {
-      // prevent logging from interwined with output benchmark results
-      fc::logger::get(DEFAULT_LOGGER).set_log_level(fc::log_level::off);
-
-      // create a chain
-      fc::temp_directory tempdir;
-      auto conf_genesis = tester::default_config( tempdir );
-      auto& cfg = conf_genesis.second.initial_configuration;
-      // configure large cpu usgaes so expensive BLS functions like pairing
-      // can finish within a trasaction time
-      cfg.max_block_cpu_usage        = 999'999'999;
-      cfg.max_transaction_cpu_usage  = 999'999'990;
-      cfg.min_transaction_cpu_usage  = 1;
-      chain = std::make_unique<tester>(conf_genesis.first, conf_genesis.second);
-      chain->execute_setup_policy( setup_policy::full );
-
-      // create account and deploy contract for a temp transaction
-      chain->create_accounts( {"payloadless"_n} );
-      chain->set_code( "payloadless"_n, test_contracts::payloadless_wasm() );
-      chain->set_abi( "payloadless"_n, test_contracts::payloadless_abi() );
-
-      // construct a signed transaction
-      fc::variant pretty_trx = fc::mutable_variant_object()
-         ("actions", fc::variants({
-            fc::mutable_variant_object()
-               ("account", name("payloadless"_n))
-               ("name", "doit")
-               ("authorization", fc::variants({
-                  fc::mutable_variant_object()
-                     ("actor", name("payloadless"_n))
-                     ("permission", name(config::active_name))
-               }))
-               ("data", fc::mutable_variant_object()
-               )
-            })
-        );
-      trx = std::make_unique<signed_transaction>();
-      abi_serializer::from_variant(pretty_trx, *trx, chain->get_resolver(), abi_serializer::create_yield_function( chain->abi_serializer_max_time ));
-      chain->set_transaction_headers(*trx);
-      trx->sign( chain->get_private_key( "payloadless"_n, "active" ), chain->control.get()->get_chain_id() );
-
-      // construct a packed transaction
-      ptrx = std::make_unique<packed_transaction>(*trx, eosio::chain::packed_transaction::compression_type::zlib);
-
-      // build transaction context from the packed transaction
-      timer = std::make_unique<platform_timer>();
-      trx_timer = std::make_unique<transaction_checktime_timer>(*timer);
-      trx_ctx = std::make_unique<transaction_context>(*chain->control.get(), *ptrx, ptrx->id(), std::move(*trx_timer));
-      trx_ctx->max_transaction_time_subjective = fc::microseconds::maximum();
-      trx_ctx->init_for_input_trx( ptrx->get_unprunable_size(), ptrx->get_prunable_size() );
-      trx_ctx->exec(); // this is required to generate action traces to be used by apply_context constructor
-
-      // build apply context from the control and transaction context
-      apply_ctx = std::make_unique<apply_context>(*chain->control.get(), *trx_ctx, 1);
-
-      // finally construct the interface
-      interface = std::make_unique<webassembly::interface>(*apply_ctx);
-   }
-
-   std::unique_ptr<tester>                      chain;
-   std::unique_ptr<signed_transaction>          trx;
-   std::unique_ptr<packed_transaction>          ptrx;
-   std::unique_ptr<platform_timer>              timer;
-   std::unique_ptr<transaction_checktime_timer> trx_timer;
-   std::unique_ptr<transaction_context>         trx_ctx;
-   std::unique_ptr<apply_context>               apply_ctx;
+   interface_in_benchmark()
+   : action([](controller::config&, genesis_state& genesis) {
+        auto& cfg = genesis.initial_configuration;
+        // configure large cpu usgaes so expensive BLS functions like pairing
+        // can finish within a trasaction time
+        cfg.max_block_cpu_usage        = 999'999'999;
+        cfg.max_transaction_cpu_usage  = 999'999'990;
+        cfg.min_transaction_cpu_usage  = 1;
+     })
+   , interface(std::make_unique<webassembly::interface>(*action.apply_ctx)) {}
+
+   action_in_benchmark                          action;
    std::unique_ptr<webassembly::interface>      interface;
 };
 
@@ -0,0 +1,86 @@
+#include <benchmark.hpp>
+#include <eosio/chain/apply_context.hpp>
+#include <eosio/testing/tester.hpp>
+
+using namespace eosio;
+using namespace eosio::chain;
+using namespace eosio::testing;
+
+// Benchmark the database intrinsics of contracts as called by the host functions,
+// directly on an apply_context, over a table of rows_per_table rows. Each run does one
+// operation on every row of the table.
+//
+// The first lookup of a table or a row in an action goes to chainbase, a later one
+// of the same action is served from what the action already looked up; the "first"
+// variants measure the former by running each pass in a new apply_context, whose
+// construction is included in their time.
+//
+// To run a benchmarking session, in the build directory, type
+//    benchmark/benchmark -f db
+
+namespace eosio::benchmark {
+
+namespace {
+
+constexpr uint64_t rows_per_table = 1000;
+constexpr name     bench_table    = "rows"_n;
+
+struct db_in_benchmark : action_in_benchmark {
+   db_in_benchmark() {
+      const std::vector<char> value(64, 'v');
+      for (uint64_t id = 0; id < rows_per_table; ++id)
+         apply_ctx->db_store_i64( receiver(), bench_table, receiver(), id, value.data(), value.size() );
+   }
+};
+
+} // anonymous namespace
+
+void db_benchmarking() {
+   db_in_benchmark b;
+   const name code = b.receiver();
+   const name scope = b.receiver();
+
+   auto find_all = [&]() {
+      for (uint64_t id = 0; id < rows_per_table; ++id)
+         b.apply_ctx->db_find_i64( code, scope, bench_table, id );
+   };
+   auto find_all_missing = [&]() {
+      for (uint64_t id = rows_per_table; id < 2 * rows_per_table; ++id)
+         b.apply_ctx->db_find_i64( code, scope, bench_table, id );
+   };
+
+   benchmarking("db_find_i64 x1000 first", [&]() { b.new_apply_context(); find_all(); });
+   benchmarking("db_find_i64 x1000 repeated", find_all);
+   benchmarking("db_find_i64 missing x1000 first", [&]() { b.new_apply_context(); find_all_missing(); });
+   benchmarking("db_find_i64 missing x1000 repeated", find_all_missing);
+
+   benchmarking("db_lowerbound_i64 x1000", [&]() {
+      for (uint64_t id = 0; id < rows_per_table; ++id)
+         b.apply_ctx->db_lowerbound_i64( code, scope, bench_table, id );
+   });
+
+   benchmarking("db_end_i64 x1000", [&]() {
+      for (uint64_t i = 0; i < rows_per_table; ++i)
+         b.apply_ctx->db_end_i64( code, scope, bench_table );
+   });
+
+   benchmarking("db_next_i64 scan of 1000", [&]() {
+      uint64_t primary = 0;
+      for (int itr = b.apply_ctx->db_lowerbound_i64( code, scope, bench_table, 0 ); itr >= 0; )
+         itr = b.apply_ctx->db_next_i64( itr, primary );
+   });
+
+   benchmarking("db_get_i64 x1000", [&]() {
+      char buffer[64];
+      for (uint64_t id = 0; id < rows_per_table; ++id)
+         b.apply_ctx->db_get_i64( b.apply_ctx->db_find_i64( code, scope, bench_table, id ), buffer, sizeof(buffer) );
+   });
+
+   benchmarking("db_update_i64 x1000", [&]() {
+      const std::vector<char> value(64, 'u');
+      for (uint64_t id = 0; id < rows_per_table; ++id)
+         b.apply_ctx->db_update_i64( b.apply_ctx->db_find_i64( code, scope, bench_table, id ), b.receiver(), value.data(), value.size() );
+   });
+}
+
+} // benchmark
@@ -4,8 +4,11 @@
 #include <fc/crypto/sha256.hpp>
 #include <fc/crypto/sha512.hpp>
 #include <fc/crypto/ripemd160.hpp>
+#include <fc/io/raw.hpp>
 #include <fc/utility.hpp>
 
+#include <eosio/chain/merkle.hpp>
+
 #include <benchmark.hpp>
 
 using namespace fc;
@@ -84,6 +87,32 @@ void hash_benchmarking() {
    };
    benchmarking("keccak256 (" + std::to_string(large_message.length()) + " bytes)", keccak_large_msg);
 
+   // pairs of digests, as hashed by each level of a merkle tree
+   constexpr size_t num_pairs = 1024;
+   std::vector<fc::sha256> digests;
+   for (size_t i = 0; i < 2 * num_pairs; ++i) {
+      digests.push_back(fc::sha256::hash(std::to_string(i)));
+   }
+   std::vector<fc::sha256> pair_hashes(num_pairs);
+
+   auto sha256_pairs_one_at_a_time = [&]() {
+      for (size_t i = 0; i < num_pairs; ++i) {
+         pair_hashes[i] = fc::sha256::hash(std::make_pair(digests[2 * i], digests[2 * i + 1]));
+      }
+   };
+   benchmarking("sha256 one at a time (" + std::to_string(num_pairs) + " pairs)", sha256_pairs_one_at_a_time);
+
+   auto sha256_pairs_batched = [&]() {
+      fc::sha256::hash_pairs(digests.data(), num_pairs, pair_hashes.data());
+   };
+   benchmarking("sha256 hash_pairs (" + std::to_string(num_pairs) + " pairs)", sha256_pairs_batched);
+
+   const eosio::chain::deque<eosio::chain::digest_type> leaves(digests.begin(), digests.end());
+   auto merkle_root = [&]() {
+      eosio::chain::merkle(leaves);
+   };
+   benchmarking("merkle (" + std::to_string(leaves.size()) + " digests)", merkle_root);
+
 }
 
 } // benchmark
@@ -10,6 +10,7 @@ using bpo::variables_map;
 
 int main(int argc, char* argv[]) {
    uint32_t num_runs = 1;
+   uint32_t trx_batch_size = 100;
    std::string feature_name;
 
    auto features = eosio::benchmark::get_features();
@@ -19,6 +20,7 @@ int main(int argc, char* argv[]) {
       ("feature,f", bpo::value<std::string>(), "feature to be benchmarked; if this option is not present, all features are benchmarked.")
       ("list,l", "list of supported features")
       ("runs,r", bpo::value<uint32_t>(&num_runs)->default_value(1000), "the number of times running a function during benchmarking")
+      ("transactions,t", bpo::value<uint32_t>(&trx_batch_size)->default_value(100), "the number of transactions pushed into each block by the transaction feature")
       ("help,h", "benchmark functions, and report average, minimum, and maximum execution time in nanoseconds");
 
    variables_map vmap;
@@ -62,6 +64,7 @@ int main(int argc, char* argv[]) {
    }
 
    eosio::benchmark::set_num_runs(num_runs);
+   eosio::benchmark::set_trx_batch_size(trx_batch_size);
    eosio::benchmark::print_header();
 
    if (feature_name.empty()) {
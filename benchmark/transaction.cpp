@@ -0,0 +1,202 @@
+#include <benchmark.hpp>
+#include <eosio/chain/wasm_interface.hpp>
+#include <eosio/testing/tester.hpp>
+#include <test_contracts.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+
+using namespace eosio;
+using namespace eosio::chain;
+using namespace eosio::testing;
+
+// Benchmark whole transactions, from signature recovery to the receipt, pushed in
+// batches into the blocks of an in-process chain, for contract workloads under
+// every available wasm runtime.
+//
+// Each run pushes a batch of transactions (`--transactions`) into one block. Reported
+// are the transactions per second over the time spent pushing, and percentiles of the
+// time of the action of each transaction as measured by the chain.
+//
+// To run a benchmarking session, in the build directory, type
+//    benchmark/benchmark -f transaction -r 100 -t 200
+
+namespace eosio::benchmark {
+
+namespace {
+
+constexpr auto workload_width = 40;
+constexpr auto trxs_width     = 10;
+constexpr auto tps_width      = 12;
+constexpr auto latency_width  = 10;
+
+// the p-th percentile of values sorted in ascending order
+uint64_t percentile(const std::vector<uint64_t>& sorted, uint32_t p) {
+   if (sorted.empty())
+      return 0;
+   return sorted[std::min<size_t>(sorted.size() - 1, sorted.size() * p / 100)];
+}
+
+struct workload {
+   std::string name;
+   // creates the accounts and deploys the contract, once per chain
+   std::function<void(tester&)> setup;
+   // the action of the n-th transaction, which makes it unique
+   std::function<action(tester&, uint64_t n)> make_action;
+};
+
+std::vector<workload> workloads() {
+   std::vector<workload> result;
+
+   // the smallest possible action, dominated by the cost of getting in and out of the contract
+   result.push_back({"payloadless::doit",
+      [](tester& chain) {
+         chain.create_accounts( {"payloadless"_n} );
+         chain.set_code( "payloadless"_n, test_contracts::payloadless_wasm() );
+         chain.set_abi( "payloadless"_n, test_contracts::payloadless_abi() );
+      },
+      [](tester& chain, uint64_t n) {
+         // the data is not read by the contract, it only makes the transaction unique
+         return action( vector<permission_level>{{"payloadless"_n, config::active_name}}, "payloadless"_n, "doit"_n, fc::raw::pack(n) );
+      }});
+
+   // database reads and writes, and a notification of each account
+   result.push_back({"eosio.token::transfer",
+      [](tester& chain) {
+         chain.create_accounts( {"eosio.token"_n, "alice"_n, "bob"_n} );
+         chain.set_code( "eosio.token"_n, test_contracts::eosio_token_wasm() );
+         chain.set_abi( "eosio.token"_n, test_contracts::eosio_token_abi() );
+         chain.push_action( "eosio.token"_n, "create"_n, "eosio.token"_n, fc::mutable_variant_object()
+                            ("issuer", "eosio.token")("maximum_supply", "1000000000.0000 TOK") );
+         chain.push_action( "eosio.token"_n, "issue"_n, "eosio.token"_n, fc::mutable_variant_object()
+                            ("to", "eosio.token")("quantity", "1000000000.0000 TOK")("memo", "") );
+         chain.push_action( "eosio.token"_n, "transfer"_n, "eosio.token"_n, fc::mutable_variant_object()
+                            ("from", "eosio.token")("to", "alice")("quantity", "1000000.0000 TOK")("memo", "") );
+      },
+      [](tester& chain, uint64_t n) {
+         const auto from = n % 2 ? "bob"_n : "alice"_n;
+         const auto to   = n % 2 ? "alice"_n : "bob"_n;
+         // alternate directions so that both accounts keep a balance, the memo makes the transaction unique
+         return chain.get_action( "eosio.token"_n, "transfer"_n, vector<permission_level>{{from, config::active_name}},
+                                  fc::mutable_variant_object()("from", from)("to", to)("quantity", "0.0001 TOK")("memo", std::to_string(n)) );
+      }});
+
+   // host functions doing real work: sha256 of a few messages
+   result.push_back({"test_api::test_sha256",
+      [](tester& chain) {
+         chain.create_accounts( {"testapi"_n} );
+         chain.set_code( "testapi"_n, test_contracts::test_api_wasm() );
+      },
+      [](tester& chain, uint64_t n) {
+         // test_api dispatches on the hashes of the class and method names
+         auto djbh = [](const char* cp) {
+            uint32_t hash = 5381;
+            while (*cp)
+               hash = 33 * hash ^ (unsigned char) *cp++;
+            return hash;
+         };
+         const name act_name( static_cast<uint64_t>(djbh("test_crypto")) << 32 | static_cast<uint64_t>(djbh("test_sha256")) );
+         return action( vector<permission_level>{{"testapi"_n, config::active_name}}, "testapi"_n, act_name, fc::raw::pack(n) );
+      }});
+
+   return result;
+}
+
+void benchmark_workload(const workload& w, const std::string& runtime_name, wasm_interface::vm_type runtime) {
+   fc::temp_directory tempdir;
+   auto conf_genesis = tester::default_config( tempdir );
+   conf_genesis.first.wasm_runtime = runtime;
+   conf_genesis.first.contracts_console = false;
+   // let a block take as many transactions as a batch has, billed by their actual cpu time
+   auto& cfg = conf_genesis.second.initial_configuration;
+   cfg.max_block_cpu_usage        = 999'999'999;
+   cfg.max_transaction_cpu_usage  = 999'999'990;
+   cfg.min_transaction_cpu_usage  = 1;
+   cfg.max_block_net_usage        = 1024*1024*1024;
+   tester chain(conf_genesis.first, conf_genesis.second);
+   chain.execute_setup_policy( setup_policy::full );
+   w.setup(chain);
+   chain.produce_block();
+
+   const uint32_t batch_size = get_trx_batch_size();
+   uint64_t nonce = 0;
+
+   auto make_batch = [&]() {
+      std::vector<signed_transaction> batch(batch_size);
+      for (auto& trx : batch) {
+         trx.actions.push_back( w.make_action(chain, nonce++) );
+         chain.set_transaction_headers( trx );
+         for (const auto& auth : trx.actions.front().authorization)
+            trx.sign( chain.get_private_key( auth.actor, "active" ), chain.control->get_chain_id() );
+      }
+      return batch;
+   };
+
+   // the first batch instantiates the contract, which is cached for later transactions
+   for (auto& trx : make_batch())
+      chain.push_transaction( trx, fc::time_point::maximum(), 0 );
+   chain.produce_block();
+
+   std::vector<uint64_t> action_us;
+   action_us.reserve( get_num_runs() * batch_size );
+   uint64_t total_ns = 0;
+   for (uint32_t run = 0; run < get_num_runs(); ++run) {
+      // signing is not part of what is measured
+      auto batch = make_batch();
+
+      auto start_time = std::chrono::high_resolution_clock::now();
+      for (auto& trx : batch) {
+         auto trace = chain.push_transaction( trx, fc::time_point::maximum(), 0 );
+         action_us.push_back( trace->action_traces.front().elapsed.count() );
+      }
+      auto end_time = std::chrono::high_resolution_clock::now();
+      total_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(end_time - start_time).count();
+
+      chain.produce_block();
+   }
+
+   std::sort(action_us.begin(), action_us.end());
+   const double tps = total_ns ? action_us.size() * 1e9 / total_ns : 0;
+
+   std::cout.imbue(std::locale(""));
+   std::cout
+      << std::setw(workload_width) << std::left << (w.name + " " + runtime_name)
+      << std::right << std::fixed << std::setprecision(0)
+      << std::setw(trxs_width) << action_us.size()
+      << std::setw(tps_width) << tps
+      << std::setw(latency_width) << percentile(action_us, 50) << " us"
+      << std::setw(latency_width) << percentile(action_us, 90) << " us"
+      << std::setw(latency_width) << percentile(action_us, 99) << " us"
+      << std::setw(latency_width) << (action_us.empty() ? 0 : action_us.back()) << " us"
+      << std::endl;
+}
+
+} // anonymous namespace
+
+void transaction_benchmarking() {
+   // prevent logging from interwined with output benchmark results
+   fc::logger::get(DEFAULT_LOGGER).set_log_level(fc::log_level::off);
+
+   std::cout << std::left << std::setw(workload_width) << "workload"
+      << std::right << std::setw(trxs_width) << "trxs"
+      << std::setw(tps_width) << "trx/s"
+      << std::setw(latency_width + 3) << "p50"
+      << std::setw(latency_width + 3) << "p90"
+      << std::setw(latency_width + 3) << "p99"
+      << std::setw(latency_width + 3) << "maximum"
+      << std::endl;
+
+   for (const auto& w : workloads()) {
+      benchmark_workload(w, "eos-vm", wasm_interface::vm_type::eos_vm);
+#ifdef EOSIO_EOS_VM_JIT_RUNTIME_ENABLED
+      benchmark_workload(w, "eos-vm-jit", wasm_interface::vm_type::eos_vm_jit);
+#endif
+#ifdef EOSIO_EOS_VM_OC_RUNTIME_ENABLED
+      benchmark_workload(w, "eos-vm-oc", wasm_interface::vm_type::eos_vm_oc);
+#endif
+   }
+}
+
+} // benchmark
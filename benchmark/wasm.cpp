@@ -0,0 +1,105 @@
+#include <benchmark.hpp>
+#include <eosio/chain/account_object.hpp>
+#include <eosio/chain/apply_context.hpp>
+#include <eosio/chain/wasm_interface.hpp>
+#include <eosio/testing/tester.hpp>
+
+using namespace eosio;
+using namespace eosio::chain;
+using namespace eosio::testing;
+
+// Benchmark the per-action cost of running a contract through wasm_interface::apply:
+// binding the instantiated module to the thread's backend, resetting linear memory
+// and globals, and calling into an action that does (almost) nothing; and the cost of
+// the memcpy, memmove and memset a contract calls with small lengths.
+//
+// To run a benchmarking session, in the build directory, type
+//    benchmark/benchmark -f wasm
+
+namespace eosio::benchmark {
+
+namespace {
+
+// 1000 rounds of a 32 byte memcpy, a 32 byte memset and an overlapping 16 byte memmove,
+// with the lengths given as constants, or read from memory as when a contract copies
+// buffers of sizes known only at run time
+std::string memory_intrinsics_wast(bool constant_lengths) {
+   const std::string len32 = constant_lengths ? "(i32.const 32)" : "(i32.load (i32.const 0))";
+   const std::string len16 = constant_lengths ? "(i32.const 16)" : "(i32.load (i32.const 4))";
+   return R"=====(
+(module
+ (export "apply" (func $apply))
+ (import "env" "memcpy" (func $memcpy (param i32 i32 i32) (result i32)))
+ (import "env" "memmove" (func $memmove (param i32 i32 i32) (result i32)))
+ (import "env" "memset" (func $memset (param i32 i32 i32) (result i32)))
+ (memory $0 1)
+ (data (i32.const 0) "\20\00\00\00\10\00\00\00")
+ (func $apply (param $0 i64) (param $1 i64) (param $2 i64)
+  (local $i i32)
+  (set_local $i (i32.const 1000))
+  (loop $l
+   (drop (call $memcpy (i32.const 1024) (i32.const 2048) )=====" + len32 + R"=====())
+   (drop (call $memset (i32.const 4096) (get_local $i) )=====" + len32 + R"=====())
+   (drop (call $memmove (i32.const 1032) (i32.const 1024) )=====" + len16 + R"=====())
+   (set_local $i (i32.sub (get_local $i) (i32.const 1)))
+   (br_if $l (get_local $i))
+  )
+ )
+)
+)=====";
+}
+
+} // anonymous namespace
+
+struct apply_in_benchmark {
+   // runs the payloadless contract, or the contract of wast when given
+   explicit apply_in_benchmark(wasm_interface::vm_type runtime, const char* wast = nullptr)
+   : action([runtime](controller::config& cfg, genesis_state&) {
+        // create a chain running the requested runtime
+        cfg.wasm_runtime = runtime;
+        cfg.contracts_console = false; // console output would grow with every run
+     }, wast)
+   , code_hash(action.chain->control->db().get<account_metadata_object, by_name>(action.receiver()).code_hash) {}
+
+   void apply() {
+      action.chain->control->get_wasm_interface().apply( code_hash, 0, 0, *action.apply_ctx );
+   }
+
+   action_in_benchmark action;
+   digest_type         code_hash;
+};
+
+void benchmark_apply(const std::string& runtime_name, wasm_interface::vm_type runtime) {
+   apply_in_benchmark b(runtime);
+
+   // the first apply instantiates the module, which is cached for later actions
+   b.apply();
+   benchmarking("apply " + runtime_name, [&]() { b.apply(); });
+}
+
+void benchmark_memory_intrinsics(const std::string& runtime_name, wasm_interface::vm_type runtime) {
+   apply_in_benchmark constant_lengths(runtime, memory_intrinsics_wast(true).c_str());
+   constant_lengths.apply();
+   benchmarking("memory intrinsics x1000 constant length " + runtime_name, [&]() { constant_lengths.apply(); });
+
+   apply_in_benchmark variable_lengths(runtime, memory_intrinsics_wast(false).c_str());
+   variable_lengths.apply();
+   benchmarking("memory intrinsics x1000 variable length " + runtime_name, [&]() { variable_lengths.apply(); });
+}
+
+void wasm_benchmarking() {
+   benchmark_apply("eos-vm", wasm_interface::vm_type::eos_vm);
+#ifdef EOSIO_EOS_VM_JIT_RUNTIME_ENABLED
+   benchmark_apply("eos-vm-jit", wasm_interface::vm_type::eos_vm_jit);
+#endif
+
+   benchmark_memory_intrinsics("eos-vm", wasm_interface::vm_type::eos_vm);
+#ifdef EOSIO_EOS_VM_JIT_RUNTIME_ENABLED
+   benchmark_memory_intrinsics("eos-vm-jit", wasm_interface::vm_type::eos_vm_jit);
+#endif
+#ifdef EOSIO_EOS_VM_OC_RUNTIME_ENABLED
+   benchmark_memory_intrinsics("eos-vm-oc", wasm_interface::vm_type::eos_vm_oc);
+#endif
+}
+
+} // benchmark
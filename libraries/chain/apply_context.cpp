@@ -11,6 +11,7 @@
 #include <eosio/chain/global_property_object.hpp>
 #include <eosio/chain/deep_mind.hpp>
 #include <boost/container/flat_set.hpp>
+#include <boost/container_hash/hash.hpp>
 
 using boost::container::flat_set;
 
@@ -669,12 +670,28 @@ uint32_t apply_context::schedule_action( action&& act_to_schedule, account_name
    return scheduled_action_ordinal;
 }
 
+size_t apply_context::table_lookup_key_hash::operator()( const table_lookup_key& key ) const {
+   size_t seed = key.code.to_uint64_t();
+   boost::hash_combine( seed, key.scope.to_uint64_t() );
+   boost::hash_combine( seed, key.table.to_uint64_t() );
+   return seed;
+}
+
+size_t apply_context::row_lookup_key_hash::operator()( const row_lookup_key& key ) const {
+   size_t seed = key.table_id;
+   boost::hash_combine( seed, key.primary_key );
+   return seed;
+}
+
 const table_id_object* apply_context::find_table( name code, name scope, name table ) {
-   return db.find<table_id_object, by_code_scope_table>(boost::make_tuple(code, scope, table));
+   auto [itr, inserted] = _table_lookups.try_emplace( table_lookup_key{code, scope, table}, nullptr );
+   if( inserted )
+      itr->second = db.find<table_id_object, by_code_scope_table>(boost::make_tuple(code, scope, table));
+   return itr->second;
 }
 
 const table_id_object& apply_context::find_or_create_table( name code, name scope, name table, const account_name &payer ) {
-   const auto* existing_tid =  db.find<table_id_object, by_code_scope_table>(boost::make_tuple(code, scope, table));
+   const auto* existing_tid = find_table( code, scope, table );
    if (existing_tid != nullptr) {
       return *existing_tid;
    }
@@ -690,7 +707,7 @@ const table_id_object& apply_context::find_or_create_table( name code, name scop
 
    update_db_usage(payer, config::billable_size_v<table_id_object>);
 
-   return db.create<table_id_object>([&](table_id_object &t_id){
+   const auto& tid = db.create<table_id_object>([&](table_id_object &t_id){
       t_id.code = code;
       t_id.scope = scope;
       t_id.table = table;
@@ -700,6 +717,8 @@ const table_id_object& apply_context::find_or_create_table( name code, name scop
          dm_logger->on_create_table(t_id);
       }
    });
+   _table_lookups[table_lookup_key{code, scope, table}] = &tid;
+   return tid;
 }
 
 void apply_context::remove_table( const table_id_object& tid ) {
@@ -718,6 +737,7 @@ void apply_context::remove_table( const table_id_object& tid ) {
       dm_logger->on_remove_table(tid);
    }
 
+   _table_lookups.erase( table_lookup_key{tid.code, tid.scope, tid.table} );
    db.remove(tid);
 }
 
@@ -805,6 +825,7 @@ int apply_context::db_store_i64( name code, name scope, name table, const accoun
       o.value.assign( buffer, buffer_size );
       o.payer       = payer;
    });
+   _row_lookups[row_lookup_key{tableid._id, id}] = &obj;
 
    db.modify( tab, [&]( auto& t ) {
      ++t.count;
@@ -917,6 +938,7 @@ void apply_context::db_remove_i64( int iterator ) {
    db.modify( table_obj, [&]( auto& t ) {
       --t.count;
    });
+   _row_lookups.erase( row_lookup_key{obj.t_id._id, obj.primary_key} );
    db.remove( obj );
 
    if (table_obj.count == 0) {
@@ -993,10 +1015,12 @@ int apply_context::db_find_i64( name code, name scope, name table, uint64_t id )
 
    auto table_end_itr = keyval_cache.cache_table( *tab );
 
-   const key_value_object* obj = db.find<key_value_object, by_scope_primary>( boost::make_tuple( tab->id, id ) );
-   if( !obj ) return table_end_itr;
+   auto [itr, inserted] = _row_lookups.try_emplace( row_lookup_key{tab->id._id, id}, nullptr );
+   if( inserted )
+      itr->second = db.find<key_value_object, by_scope_primary>( boost::make_tuple( tab->id, id ) );
+   if( !itr->second ) return table_end_itr;
 
-   return keyval_cache.add( *obj );
+   return keyval_cache.add( *itr->second );
 }
 
 int apply_context::db_lowerbound_i64( name code, name scope, name table, uint64_t id ) {
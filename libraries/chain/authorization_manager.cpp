@@ -151,6 +151,7 @@ namespace eosio { namespace chain {
          p.last_used = creation_time;
       });
 
+      clear_authorization_cache();
       const auto& perm = _db.create<permission_object>([&](auto& p) {
          p.usage_id     = perm_usage.id;
          p.parent       = parent;
@@ -187,6 +188,7 @@ namespace eosio { namespace chain {
          p.last_used = creation_time;
       });
 
+      clear_authorization_cache();
       const auto& perm = _db.create<permission_object>([&](auto& p) {
          p.usage_id     = perm_usage.id;
          p.parent       = parent;
@@ -207,6 +209,7 @@ namespace eosio { namespace chain {
          EOS_ASSERT(k.key.which() < _db.get<protocol_state_object>().num_supported_key_types, unactivated_key_type,
            "Unactivated key type used when modifying permission");
 
+      clear_authorization_cache();
       _db.modify( permission, [&](permission_object& po) {
          auto dm_logger = _control.get_deep_mind_logger(is_trx_transient);
 
@@ -236,6 +239,7 @@ namespace eosio { namespace chain {
          dm_logger->on_remove_permission(permission);
       }
 
+      clear_authorization_cache();
       _db.remove( permission );
    }
 
@@ -470,12 +474,14 @@ namespace eosio { namespace chain {
                                                const std::function<void()>&         _checktime,
                                                bool                                 allow_unused_keys,
                                                bool                                 check_but_dont_fail,
-                                               const flat_set<permission_level>&    satisfied_authorizations
+                                               const flat_set<permission_level>&    satisfied_authorizations,
+                                               bool                                 cache_result
                                              )const
    {
       const auto& checktime = ( static_cast<bool>(_checktime) ? _checktime : _noop_checktime );
 
       auto delay_max_limit = fc::seconds( _control.get_global_properties().configuration.max_transaction_delay );
+      const uint16_t max_authority_depth = _control.get_global_properties().configuration.max_authority_depth;
 
       auto effective_provided_delay =  (provided_delay >= delay_max_limit) ? fc::microseconds::maximum() : provided_delay;
 
@@ -485,7 +491,7 @@ namespace eosio { namespace chain {
                                           else
                                              return nullptr;
                                         },
-                                        _control.get_global_properties().configuration.max_authority_depth,
+                                        max_authority_depth,
                                         provided_keys,
                                         provided_permissions,
                                         effective_provided_delay,
@@ -541,6 +547,17 @@ namespace eosio { namespace chain {
          }
       }
 
+      // Blocks often carry many transactions declaring the same authorizations signed by the same keys; a cached
+      // outcome stands for evaluating the permissions again, as any permission change clears the cache
+      std::optional<authorization_cache_key> cache_key;
+      if( cache_result && provided_permissions.empty() && !check_but_dont_fail ) {
+         cache_key.emplace( authorization_cache_key{ {permissions_to_satisfy.begin(), permissions_to_satisfy.end()},
+                                                     provided_keys, max_authority_depth } );
+         auto itr = _authorization_cache.find( *cache_key );
+         if( itr != _authorization_cache.end() && (itr->second || allow_unused_keys) )
+            return;
+      }
+
       // Now verify that all the declared authorizations are satisfied:
 
       // Although this can be made parallel (especially for input transactions) with the optimistic assumption that the
@@ -569,6 +586,28 @@ namespace eosio { namespace chain {
                      "transaction bears irrelevant signatures from these keys: ${keys}",
                      ("keys", checker.unused_keys()) );
       }
+
+      if( cache_key ) {
+         if( _authorization_cache.size() >= max_authorization_cache_size )
+            _authorization_cache.clear();
+         _authorization_cache.emplace( std::move(*cache_key), checker.all_keys_used() );
+      }
+   }
+
+   void authorization_manager::clear_authorization_cache() {
+      _authorization_cache.clear();
+   }
+
+   size_t authorization_manager::authorization_cache_key_hash::operator()( const authorization_cache_key& key ) const {
+      // keys only take part in equality, declared authorizations are distinctive enough
+      size_t seed = key.keys.size();
+      boost::hash_combine( seed, key.max_authority_depth );
+      for( const auto& [level, delay] : key.permissions ) {
+         boost::hash_combine( seed, level.actor.to_uint64_t() );
+         boost::hash_combine( seed, level.permission.to_uint64_t() );
+         boost::hash_combine( seed, delay.count() );
+      }
+      return seed;
    }
 
    void
@@ -1605,7 +1605,9 @@ struct controller_impl {
                        trx_context.delay,
                        [&trx_context](){ trx_context.checktime(); },
                        false,
-                       trx->is_dry_run()
+                       trx->is_dry_run(),
+                       {},
+                       !trx->is_read_only() // read-only transactions run in parallel
                );
             }
             trx_context.exec();
@@ -1703,6 +1705,9 @@ struct controller_impl {
    {
       EOS_ASSERT( !pending, block_validate_exception, "pending block already exists" );
 
+      // the permissions of a previous (possibly aborted) block do not carry over
+      authorization.clear_authorization_cache();
+
       emit( self.block_start, head->block_num + 1 );
 
       // at block level, no transaction specific logging is possible
@@ -2454,6 +2459,7 @@ struct controller_impl {
          }
 
          if( permission.auth != auth ) {
+            authorization.clear_authorization_cache();
             db.modify(permission, [&]( auto& po ) {
                po.auth = auth;
             });
@@ -5,6 +5,7 @@
 #include <eosio/chain/contract_table_objects.hpp>
 #include <eosio/chain/deep_mind.hpp>
 #include <fc/utility.hpp>
+#include <boost/unordered/unordered_flat_map.hpp>
 #include <sstream>
 #include <algorithm>
 #include <set>
@@ -28,24 +29,24 @@ class apply_context {
 
             /// Returns end iterator of the table.
             int cache_table( const table_id_object& tobj ) {
-               auto itr = _table_cache.find(tobj.id);
+               auto itr = _table_cache.find(tobj.id._id);
                if( itr != _table_cache.end() )
                   return itr->second.second;
 
                auto ei = index_to_end_iterator(_end_iterator_to_table.size());
                _end_iterator_to_table.push_back( &tobj );
-               _table_cache.emplace( tobj.id, make_pair(&tobj, ei) );
+               _table_cache.emplace( tobj.id._id, make_pair(&tobj, ei) );
                return ei;
             }
 
             const table_id_object& get_table( table_id_object::id_type i )const {
-               auto itr = _table_cache.find(i);
+               auto itr = _table_cache.find(i._id);
                EOS_ASSERT( itr != _table_cache.end(), table_not_in_cache, "an invariant was broken, table should be in cache" );
                return *itr->second.first;
             }
 
             int get_end_iterator_by_table_id( table_id_object::id_type i )const {
-               auto itr = _table_cache.find(i);
+               auto itr = _table_cache.find(i._id);
                EOS_ASSERT( itr != _table_cache.end(), table_not_in_cache, "an invariant was broken, table should be in cache" );
                return itr->second.second;
             }
@@ -89,10 +90,11 @@ class apply_context {
             }
 
          private:
-            map<table_id_object::id_type, pair<const table_id_object*, int>> _table_cache;
+            /// keyed by the table id; iterators are handed out in order of first use, which hashing leaves unchanged
+            boost::unordered_flat_map<int64_t, pair<const table_id_object*, int>> _table_cache;
             vector<const table_id_object*>                  _end_iterator_to_table;
             vector<const T*>                                _iterator_to_object;
-            map<const T*,int>                               _object_to_iterator;
+            boost::unordered_flat_map<const T*,int>         _object_to_iterator;
 
             /// Precondition: std::numeric_limits<int>::min() < ei < -1
             /// Iterator of -1 is reserved for invalid iterators (i.e. when the appropriate table has not yet been created).
@@ -576,6 +578,24 @@ class apply_context {
 
       int  db_store_i64( name code, name scope, name table, const account_name& payer, uint64_t id, const char* buffer, size_t buffer_size );
 
+      struct table_lookup_key {
+         name code;
+         name scope;
+         name table;
+         bool operator==(const table_lookup_key&) const = default;
+      };
+      struct table_lookup_key_hash {
+         size_t operator()(const table_lookup_key& key) const;
+      };
+      struct row_lookup_key {
+         int64_t  table_id;
+         uint64_t primary_key;
+         bool operator==(const row_lookup_key&) const = default;
+      };
+      struct row_lookup_key_hash {
+         size_t operator()(const row_lookup_key& key) const;
+      };
+
 
    /// Misc methods:
    public:
@@ -630,6 +650,10 @@ class apply_context {
    private:
 
       iterator_cache<key_value_object>    keyval_cache;
+      /// Memoized lookups of this action, nullptr for what was found not to exist. Only this context creates or removes
+      /// contract tables and rows while its action runs, so keeping them current on store and remove keeps them exact.
+      boost::unordered_flat_map<table_lookup_key, const table_id_object*, table_lookup_key_hash>  _table_lookups;
+      boost::unordered_flat_map<row_lookup_key, const key_value_object*, row_lookup_key_hash>     _row_lookups;
       vector< std::pair<account_name, uint32_t> > _notified; ///< keeps track of new accounts to be notifed of current message
       vector<uint32_t>                    _inline_actions; ///< action_ordinals of queued inline actions
       vector<uint32_t>                    _cfa_inline_actions; ///< action_ordinals of queued inline context-free actions
@@ -9,6 +9,8 @@
 
 #include <boost/range/algorithm/find.hpp>
 #include <boost/algorithm/cxx11/all_of.hpp>
+#include <boost/container_hash/hash.hpp>
+#include <boost/unordered/unordered_flat_map.hpp>
 
 #include <functional>
 
@@ -19,6 +21,15 @@ namespace detail {
    using meta_permission_value = std::function<uint32_t()>;
    using meta_permission_map = boost::container::flat_multimap<meta_permission_key, meta_permission_value, std::greater<>>;
 
+   struct permission_level_hash {
+      size_t operator()(const permission_level& level) const {
+         size_t seed = 0;
+         boost::hash_combine(seed, level.actor.to_uint64_t());
+         boost::hash_combine(seed, level.permission.to_uint64_t());
+         return seed;
+      }
+   };
+
 } /// namespace detail
 
    /**
@@ -67,7 +78,7 @@ namespace detail {
             permission_satisfied
          };
 
-         typedef map<permission_level, permission_cache_status> permission_cache_type;
+         typedef boost::unordered_flat_map<permission_level, permission_cache_status, detail::permission_level_hash> permission_cache_type;
 
          bool satisfied( const permission_level& permission,
                          fc::microseconds override_provided_delay,
@@ -146,8 +157,9 @@ namespace detail {
 
       private:
          permission_cache_type* initialize_permission_cache( permission_cache_type& cached_permissions ) {
+            cached_permissions.reserve( provided_permissions.size() );
             for( const auto& p : provided_permissions ) {
-               cached_permissions.emplace_hint( cached_permissions.end(), p, permission_satisfied );
+               cached_permissions.emplace( p, permission_satisfied );
             }
             return &cached_permissions;
          }
@@ -223,7 +235,6 @@ namespace detail {
                if( !status ) {
                   if( recursion_depth < checker.recursion_depth_limit ) {
                      bool r = false;
-                     typename permission_cache_type::iterator itr = cached_permissions.end();
 
                      std::invoke_result_t<decltype(checker.permission_to_authority), const permission_level> auth = nullptr;
                      try {
@@ -234,15 +245,15 @@ namespace detail {
                      if(!auth)
                         return total_weight;
 
-                     auto res = cached_permissions.emplace( permission.permission, being_evaluated );
-                     itr = res.first;
+                     cached_permissions.emplace( permission.permission, being_evaluated );
                      r = checker.satisfied( *auth, cached_permissions, recursion_depth + 1 );
 
+                     // evaluating the authority may have grown the cache, invalidating iterators into it
                      if( r ) {
                         total_weight += permission.weight;
-                        itr->second = permission_satisfied;
+                        cached_permissions[permission.permission] = permission_satisfied;
                      } else {
-                        itr->second = permission_unsatisfied;
+                        cached_permissions[permission.permission] = permission_unsatisfied;
                      }
                   }
                } else if( *status == permission_satisfied ) {
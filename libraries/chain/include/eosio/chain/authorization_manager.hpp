@@ -4,6 +4,8 @@
 #include <eosio/chain/permission_object.hpp>
 #include <eosio/chain/snapshot.hpp>
 
+#include <boost/unordered/unordered_flat_map.hpp>
+
 #include <utility>
 #include <functional>
 
@@ -75,6 +77,9 @@ namespace eosio { namespace chain {
           *  @param provided_delay - the delay satisfied by the transaction
           *  @param checktime - the function that can be called to track CPU usage and time during the process of checking authorization
           *  @param allow_unused_keys - true if method should not assert on unused keys
+          *  @param cache_result - true if the outcome may be answered from, and stored in, the authorization cache;
+          *                        only for checks of input transactions outside of any transaction's execution, whose
+          *                        permission changes could be rolled back
           */
          void
          check_authorization( const vector<action>&                actions,
@@ -84,9 +89,17 @@ namespace eosio { namespace chain {
                               const std::function<void()>&         checktime = std::function<void()>(),
                               bool                                 allow_unused_keys = false,
                               bool                                 check_but_dont_fail = false,
-                              const flat_set<permission_level>&    satisfied_authorizations = flat_set<permission_level>()
+                              const flat_set<permission_level>&    satisfied_authorizations = flat_set<permission_level>(),
+                              bool                                 cache_result = false
                             )const;
 
+         /**
+          *  @brief Forget the cached outcomes of authorization checks
+          *
+          *  Called when a block starts and whenever a permission is created, modified or removed.
+          */
+         void clear_authorization_cache();
+
 
          /**
           *  @brief Check authorizations of a permission with provided keys, permission levels, and delay
@@ -118,9 +131,30 @@ namespace eosio { namespace chain {
          static std::function<void()> _noop_checktime;
 
       private:
+         /**
+          * The declared authorizations of a transaction, with the delay each of them is checked under, and the keys
+          * that signed it
+          */
+         struct authorization_cache_key {
+            vector<std::pair<permission_level, fc::microseconds>> permissions;
+            flat_set<public_key_type>                             keys;
+            uint16_t                                              max_authority_depth = 0;
+
+            bool operator==(const authorization_cache_key&) const = default;
+         };
+
+         struct authorization_cache_key_hash {
+            size_t operator()(const authorization_cache_key& key) const;
+         };
+
+         static constexpr size_t max_authorization_cache_size = 64*1024;
+
          const controller&    _control;
          chainbase::database& _db;
 
+         /// transactions whose declared authorizations were satisfied, and whether they used all of their keys
+         mutable boost::unordered_flat_map<authorization_cache_key, bool, authorization_cache_key_hash> _authorization_cache;
+
          void             check_updateauth_authorization( const updateauth& update, const vector<permission_level>& auths )const;
          void             check_deleteauth_authorization( const deleteauth& del, const vector<permission_level>& auths )const;
          void             check_linkauth_authorization( const linkauth& link, const vector<permission_level>& auths )const;
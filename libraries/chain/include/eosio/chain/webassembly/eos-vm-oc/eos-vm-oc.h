@@ -39,6 +39,7 @@ struct eos_vm_oc_control_block {
    unsigned is_running;
    int64_t max_linear_memory_pages;
    void* globals;
+   int64_t linear_memory_pages_high_water; //-1 if memory was not grown (or shrunk)
 };
 
 #ifdef __cplusplus
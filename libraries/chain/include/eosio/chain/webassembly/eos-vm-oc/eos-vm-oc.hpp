@@ -24,17 +24,26 @@ struct intrinsic_ordinal {
 
 using eosvmoc_optional_offset_or_import_t = std::variant<no_offset, code_offset, intrinsic_ordinal>;
 
+//where the compiled code of a wasm function starts; a code's function table is sorted by code_offset
+struct function_table_entry {
+   uint32_t code_offset;
+   uint32_t function_index; //in the wasm function index space, which counts the imports first
+};
+
 struct code_descriptor {
    digest_type code_hash;
    uint8_t vm_version;
    uint8_t codegen_version;
    size_t code_begin;
+   unsigned code_size;
    eosvmoc_optional_offset_or_import_t start;
    unsigned apply_offset;
    int starting_memory_pages;
    size_t initdata_begin;
    unsigned initdata_size;
    unsigned initdata_prologue_size;
+   size_t function_table_begin;
+   unsigned function_table_size; //number of function_table_entry
 };
 
 enum eosvmoc_exitcode : int {
@@ -51,6 +60,6 @@ static constexpr uint8_t current_codegen_version = 1;
 FC_REFLECT(eosio::chain::eosvmoc::no_offset, );
 FC_REFLECT(eosio::chain::eosvmoc::code_offset, (offset));
 FC_REFLECT(eosio::chain::eosvmoc::intrinsic_ordinal, (ordinal));
-FC_REFLECT(eosio::chain::eosvmoc::code_descriptor, (code_hash)(vm_version)(codegen_version)(code_begin)(start)(apply_offset)(starting_memory_pages)(initdata_begin)(initdata_size)(initdata_prologue_size));
+FC_REFLECT(eosio::chain::eosvmoc::code_descriptor, (code_hash)(vm_version)(codegen_version)(code_begin)(code_size)(start)(apply_offset)(starting_memory_pages)(initdata_begin)(initdata_size)(initdata_prologue_size)(function_table_begin)(function_table_size));
 
 #define EOSVMOC_INTRINSIC_INIT_PRIORITY __attribute__((init_priority(198)))
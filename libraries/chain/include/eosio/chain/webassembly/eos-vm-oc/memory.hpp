@@ -9,6 +9,8 @@
 #include <stdint.h>
 #include <stddef.h>
 
+#include <vector>
+
 namespace eosio::chain::eosvmoc {
 
 class memory {
@@ -54,6 +56,25 @@ class memory {
       // Memory uses beyond this limit will be handled by mprotect.
       static constexpr uint32_t sliced_pages_for_ro_thread = 10;
 
+      // Contracts starting with at least this many pages of linear memory have writes to their initial memory
+      // tracked per wasm page, so the next action only zeroes the pages that were written instead of all of them.
+      // The tracking costs a fault per written page, which only pays off for larger memories.
+      static constexpr uint64_t dirty_tracking_min_pages = 16;
+
+      // Zero the first `pages` wasm pages of linear memory, skipping those that were not written since they were
+      // last zeroed
+      void zero_linear_memory(uint64_t pages);
+      // Record that the first `pages` wasm pages of linear memory may have been written
+      void mark_written(uint64_t pages);
+
+      // Write protect the pages in [first_page, pages) of the linear memory, in both the mapping used by wasm code
+      // for a memory of `pages` pages and the full page mapping used by host functions. The first write to each of
+      // them faults into record_write() which marks the page written and lifts the protection.
+      void start_write_tracking(uint64_t first_page, uint64_t pages);
+      // Called from the SEGV handler, returns true if addr is in a page whose writes are tracked
+      bool record_write(uintptr_t addr);
+      void stop_write_tracking();
+
       // Changed from -cb_offset == EOS_VM_OC_CONTROL_BLOCK_OFFSET to get around
       // of compile warning about comparing integers of different signedness
       static_assert(EOS_VM_OC_CONTROL_BLOCK_OFFSET + cb_offset == 0, "EOS VM OC control block offset has slid out of place somehow");
@@ -65,6 +86,11 @@ class memory {
 
       uint8_t* zeropage_base;
       uint8_t* fullpage_base;
+
+      std::vector<uint8_t> written_pages; ///< per wasm page, non-zero if it may have been written since last zeroed
+      uint8_t* tracked_slice = nullptr;   ///< linear memory of the slice whose writes are tracked, if any
+      uint64_t tracked_first_page = 0;
+      uint64_t tracked_end_page = 0;
 };
 
 }
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <eosio/chain/types.hpp>
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <string>
+#include <vector>
+
+namespace eosio::chain::eosvmoc {
+
+struct code_descriptor;
+
+/**
+ * Sampling profiler of the code compiled by EOS VM OC.
+ *
+ * While started, every thread running OC code gets SIGPROF each interval of the cpu time it consumes.
+ * A sample taken while a contract runs records where the thread is in the contract's code, or that it
+ * is outside of it (in a host function, or anywhere else in nodeos). When the action completes, the
+ * samples are mapped to the indices of the wasm functions with the function table of the code and
+ * accumulated per contract. The threads running OC code pick up a start or a stop when they next
+ * execute an action.
+ *
+ * Only the innermost wasm function is sampled, since OC code does not keep frame pointers to walk. A SIGPROF arriving
+ * while no contract is sampled on the thread goes to the handler that was installed before, e.g. that of the eos-vm-jit
+ * profiler of profile-account.
+ */
+class profiler {
+   public:
+      struct profile {
+         bool                     running        = false;
+         uint32_t                 interval_us    = 0;
+         uint64_t                 total_samples  = 0;
+         uint64_t                 dropped        = 0; ///< samples lost to an action outgrowing the per action buffer
+         std::vector<std::string> folded_stacks;     ///< "contract;code hash;wasm-function[index] count", most samples first
+      };
+
+      /// starts sampling, or changes the interval of a running profiler; thread safe
+      static void start(uint32_t interval_us);
+      /// stops sampling, keeping what was sampled; thread safe
+      static void stop();
+      /// what was sampled since the last clear; thread safe
+      static profile get();
+      /// drops what was sampled; thread safe
+      static void clear();
+
+      /// samples the execution of code on the calling thread for the duration of its lifetime, when started
+      class scoped_sampling {
+         public:
+            scoped_sampling(const code_descriptor& code, const uint8_t* code_mapping, account_name receiver);
+            ~scoped_sampling();
+
+            scoped_sampling(const scoped_sampling&) = delete;
+            scoped_sampling& operator=(const scoped_sampling&) = delete;
+
+         private:
+            const code_descriptor& _code;
+            account_name           _receiver;
+            bool                   _sampling = false;
+      };
+};
+
+}
+
+FC_REFLECT(eosio::chain::eosvmoc::profiler::profile, (running)(interval_us)(total_samples)(dropped)(folded_stacks))
@@ -54,6 +54,8 @@ class eos_vm_runtime : public eosio::chain::wasm_runtime_interface {
       // do not rely on others. Safe to be thread_local.
       thread_local static eos_vm_backend_t<Backend> _bkend;
       thread_local static context_t                 _exec_ctx;
+      // id of the instantiated module the thread's backend and exec context are bound to, 0 if none
+      thread_local static uint64_t                  _bound_module_id;
 
    template<typename Impl>
    friend class eos_vm_instantiated_module;
@@ -17,6 +17,14 @@ namespace webassembly {
          inline apply_context& get_context() { return context; }
          inline const apply_context& get_context() const { return context; }
 
+         /**
+          * Call the host function F, accounting the call to the receiver in the intrinsic_profiler
+          * when profiling is enabled on the calling thread. This is what the runtimes register in
+          * place of the host functions of the env module.
+          */
+         template<auto F, typename R, typename... Args>
+         R profiled(Args... args);
+
          /**
           * Retrieve the signed_transaction.context_free_data[index].
           *
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <eosio/chain/types.hpp>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#if defined(__x86_64__)
+#include <x86intrin.h>
+#endif
+
+namespace eosio { namespace chain { namespace webassembly {
+
+   /**
+    * Counts the calls of each host function and the cycles spent in them, per contract.
+    *
+    * Profiling is enabled per thread, and a thread which did not enable it pays a single
+    * thread local test per host function call. The counts accumulate on the thread making
+    * the calls until they are taken.
+    *
+    * Cycles are read from the time stamp counter on x86_64 and are nanoseconds elsewhere.
+    */
+   class intrinsic_profiler {
+      public:
+         struct entry {
+            account_name contract;
+            std::string  intrinsic;
+            uint64_t     calls  = 0;
+            uint64_t     cycles = 0;
+         };
+
+         /// Assigns an id to a host function, called once per host function when the host functions are registered
+         static uint32_t register_intrinsic(const char* name);
+
+         static bool enabled() { return _enabled; }
+         /// Enables or disables profiling of the host functions called on the calling thread
+         static void set_enabled(bool enabled);
+
+         static uint64_t now() {
+#if defined(__x86_64__)
+            return __rdtsc();
+#else
+            return std::chrono::steady_clock::now().time_since_epoch().count();
+#endif
+         }
+
+         /// Accounts one call of the intrinsic with the given id to the contract
+         static void record(account_name contract, uint32_t intrinsic_id, uint64_t cycles) noexcept;
+
+         /// The counts accumulated on the calling thread, most cycles first, and resets them
+         static std::vector<entry> take();
+         /// Drops the counts accumulated on the calling thread
+         static void reset();
+
+      private:
+         inline static thread_local bool _enabled = false;
+   };
+
+}}} // ns eosio::chain::webassembly
+
+FC_REFLECT(eosio::chain::webassembly::intrinsic_profiler::entry, (contract)(intrinsic)(calls)(cycles))
@@ -35,18 +35,24 @@ bool is_canonical_right(const digest_type& val) {
 digest_type merkle(deque<digest_type> ids) {
    if( 0 == ids.size() ) { return digest_type(); }
 
-   while( ids.size() > 1 ) {
-      if( ids.size() % 2 )
-         ids.push_back(ids.back());
+   // each level is hashed as a batch of pairs, which needs the digests to be contiguous
+   vector<digest_type> level( std::make_move_iterator(ids.begin()), std::make_move_iterator(ids.end()) );
+   ids.clear();
 
-      for (size_t i = 0; i < ids.size() / 2; i++) {
-         ids[i] = digest_type::hash(make_canonical_pair(ids[2 * i], ids[(2 * i) + 1]));
+   while( level.size() > 1 ) {
+      if( level.size() % 2 )
+         level.push_back(level.back());
+
+      for (size_t i = 0; i < level.size(); i += 2) {
+         level[i]     = make_canonical_left(level[i]);
+         level[i + 1] = make_canonical_right(level[i + 1]);
       }
+      digest_type::hash_pairs(level.data(), level.size() / 2, level.data());
 
-      ids.resize(ids.size() / 2);
+      level.resize(level.size() / 2);
    }
 
-   return ids.front();
+   return level.front();
 }
 
 } } // eosio::chain
@@ -0,0 +1,67 @@
+#include <eosio/chain/webassembly/intrinsic_profiler.hpp>
+
+#include <boost/unordered/unordered_flat_map.hpp>
+
+#include <algorithm>
+
+namespace eosio { namespace chain { namespace webassembly {
+
+namespace {
+   struct counters {
+      uint64_t calls  = 0;
+      uint64_t cycles = 0;
+   };
+
+   // indexed by intrinsic id, only appended to while the host functions are registered during static initialization
+   std::vector<std::string>& intrinsic_names() {
+      static std::vector<std::string> names;
+      return names;
+   }
+
+   // per contract, the counters of each intrinsic indexed by intrinsic id
+   thread_local boost::unordered_flat_map<uint64_t, std::vector<counters>> contract_counters;
+}
+
+uint32_t intrinsic_profiler::register_intrinsic(const char* name) {
+   auto& names = intrinsic_names();
+   names.emplace_back(name);
+   return names.size() - 1;
+}
+
+void intrinsic_profiler::set_enabled(bool enabled) {
+   _enabled = enabled;
+   if (!enabled)
+      reset();
+}
+
+void intrinsic_profiler::record(account_name contract, uint32_t intrinsic_id, uint64_t cycles) noexcept {
+   try {
+      auto& c = contract_counters[contract.to_uint64_t()];
+      if (c.size() <= intrinsic_id)
+         c.resize(intrinsic_names().size());
+      ++c[intrinsic_id].calls;
+      c[intrinsic_id].cycles += cycles;
+   } catch (...) {
+      // a lost sample is preferable to failing the host function being profiled
+   }
+}
+
+std::vector<intrinsic_profiler::entry> intrinsic_profiler::take() {
+   std::vector<entry> result;
+   const auto& names = intrinsic_names();
+   for (const auto& [contract, c] : contract_counters) {
+      for (uint32_t id = 0; id < c.size(); ++id) {
+         if (c[id].calls)
+            result.push_back(entry{account_name(contract), names[id], c[id].calls, c[id].cycles});
+      }
+   }
+   contract_counters.clear();
+   std::sort(result.begin(), result.end(), [](const entry& a, const entry& b) { return a.cycles > b.cycles; });
+   return result;
+}
+
+void intrinsic_profiler::reset() {
+   contract_counters.clear();
+}
+
+}}} // ns eosio::chain::webassembly
@@ -693,6 +693,12 @@ namespace LLVMJIT
 		// Call operators
 		//
 
+		llvm::Value* emitImportedFunctionPointer(Uptr functionIndex,const FunctionType* calleeType)
+		{
+			llvm::Value* ic = irBuilder.CreateLoad( emitLiteralPointer((void*)(OFFSET_OF_FIRST_INTRINSIC-moduleContext.importedFunctionOffsets[functionIndex]*8), llvmI64Type->getPointerTo(256)) );
+			return irBuilder.CreateIntToPtr(ic, asLLVMType(calleeType)->getPointerTo());
+		}
+
 		void call(CallImm imm)
 		{
 			// Map the callee function index to either an imported function pointer or a function in this module.
@@ -702,8 +708,8 @@ namespace LLVMJIT
 			if(imm.functionIndex < moduleContext.importedFunctionOffsets.size())
 			{
 				calleeType = module.types[module.functions.imports[imm.functionIndex].type.index];
-				llvm::Value* ic = irBuilder.CreateLoad( emitLiteralPointer((void*)(OFFSET_OF_FIRST_INTRINSIC-moduleContext.importedFunctionOffsets[imm.functionIndex]*8), llvmI64Type->getPointerTo(256)) );
-				callee = irBuilder.CreateIntToPtr(ic, asLLVMType(calleeType)->getPointerTo());
+				if(module.functions.imports[imm.functionIndex].moduleName == "env" && emitInlineMemoryIntrinsic(module.functions.imports[imm.functionIndex].exportName,imm.functionIndex,calleeType)) { return; }
+				callee = emitImportedFunctionPointer(imm.functionIndex,calleeType);
 				isExit = module.functions.imports[imm.functionIndex].moduleName == "env" && module.functions.imports[imm.functionIndex].exportName == "eosio_exit";
 			}
 			else
@@ -943,6 +949,111 @@ namespace LLVMJIT
 		EMIT_STORE_OP(i64,store,llvmI64Type,3,identityConversion,LOAD_STORE_ALIGNMENT_PARAM)
 		EMIT_STORE_OP(f32,store,llvmF32Type,2,identityConversion,LOAD_STORE_ALIGNMENT_PARAM) EMIT_STORE_OP(f64,store,llvmF64Type,3,identityConversion,LOAD_STORE_ALIGNMENT_PARAM)
 
+		//
+		// Inline memory intrinsics
+		//
+
+		// Calls to memcpy, memmove and memset with a small constant length are emitted as loads and stores of the bytes
+		// instead. They access exactly the bytes the intrinsics validate, so they fault on the same out of bounds arguments,
+		// and a memcpy of overlapping ranges still calls the intrinsic to fail as it always has. A host call counts as a
+		// level of call depth, so the depth check made on entry to every host function is made here too. The intrinsic's
+		// pointer is only loaded where it is called.
+		bool emitInlineMemoryIntrinsic(const std::string& name,Uptr functionIndex,const FunctionType* calleeType)
+		{
+			static constexpr U64 maxInlineLength = 64;
+
+			const bool isMemcpy = name == "memcpy";
+			const bool isMemset = name == "memset";
+			if(!isMemcpy && !isMemset && name != "memmove") { return false; }
+			if(calleeType != FunctionType::get(ResultType::i32,{ValueType::i32,ValueType::i32,ValueType::i32})) { return false; }
+			// a zero length is left to the intrinsic, which validates the pointers even then
+			auto constantLength = llvm::dyn_cast<llvm::ConstantInt>(getTopValue());
+			if(!constantLength || constantLength->isZero() || constantLength->getZExtValue() > maxInlineLength) { return false; }
+			const U64 length = constantLength->getZExtValue();
+
+			llvm::Value* args[3];
+			popMultiple(args,3);
+			llvm::Value* dest = args[0];
+
+			auto depth = irBuilder.CreateLoad(moduleContext.depthCounter);
+			depth->setVolatile(true);
+			emitConditionalTrapIntrinsic(irBuilder.CreateICmpEQ(depth,emitLiteral((I32)1)),"eosvmoc_internal.depth_assert",FunctionType::get(),{});
+
+#if LLVM_VERSION_MAJOR < 11
+			llvm::Type* llvmI8x16Type = llvm::VectorType::get(llvmI8Type,16);
+#else
+			llvm::Type* llvmI8x16Type = llvm::FixedVectorType::get(llvmI8Type,16);
+#endif
+			// the widest access that fits in what is left, 16 byte vectors first
+			struct chunk { U32 offset; U32 size; llvm::Type* type; };
+			std::vector<chunk> chunks;
+			for(U32 offset = 0;offset < length;)
+			{
+				const U64 left = length - offset;
+				if(left >= 16)     { chunks.push_back({offset,16,llvmI8x16Type}); }
+				else if(left >= 8) { chunks.push_back({offset,8,llvmI64Type}); }
+				else if(left >= 4) { chunks.push_back({offset,4,llvmI32Type}); }
+				else if(left >= 2) { chunks.push_back({offset,2,llvmI16Type}); }
+				else               { chunks.push_back({offset,1,llvmI8Type}); }
+				offset += chunks.back().size;
+			}
+
+			if(isMemset)
+			{
+				auto byte = irBuilder.CreateTrunc(args[1],llvmI8Type);
+				for(const chunk& c : chunks)
+				{
+					llvm::Value* value;
+					if(c.size == 16) { value = irBuilder.CreateVectorSplat(16,byte); }
+					else if(c.size == 1) { value = byte; }
+					else { value = irBuilder.CreateMul(irBuilder.CreateZExt(byte,c.type),llvm::ConstantInt::get(c.type,0x0101010101010101ULL >> (64 - c.size*8))); }
+					auto store = irBuilder.CreateStore(value,coerceByteIndexToPointer(dest,c.offset,c.type));
+					store->setVolatile(true);
+					store->setAlignment(LOAD_STORE_ALIGNMENT_PARAM);
+				}
+			}
+			else
+			{
+				llvm::Value* src = args[1];
+				if(isMemcpy)
+				{
+					auto destI64 = irBuilder.CreateZExt(dest,llvmI64Type);
+					auto srcI64 = irBuilder.CreateZExt(src,llvmI64Type);
+					auto distance = irBuilder.CreateSelect(irBuilder.CreateICmpUGE(destI64,srcI64),irBuilder.CreateSub(destI64,srcI64),irBuilder.CreateSub(srcI64,destI64));
+
+					auto overlapBlock = llvm::BasicBlock::Create(context,"memcpyOverlap",llvmFunction);
+					auto inlineBlock = llvm::BasicBlock::Create(context,"memcpyInline",llvmFunction);
+					irBuilder.CreateCondBr(irBuilder.CreateICmpULT(distance,emitLiteral(length)),overlapBlock,inlineBlock,moduleContext.likelyFalseBranchWeights);
+
+					irBuilder.SetInsertPoint(overlapBlock);
+					createCall(emitImportedFunctionPointer(functionIndex,calleeType),llvm::ArrayRef<llvm::Value*>(args,3));
+					irBuilder.CreateUnreachable();
+
+					irBuilder.SetInsertPoint(inlineBlock);
+				}
+
+				// everything is loaded before anything is stored, which also moves overlapping ranges correctly
+				std::vector<llvm::Value*> values;
+				for(const chunk& c : chunks)
+				{
+					auto load = irBuilder.CreateLoad(coerceByteIndexToPointer(src,c.offset,c.type));
+					load->setAlignment(LOAD_STORE_ALIGNMENT_PARAM);
+					load->setVolatile(true);
+					values.push_back(load);
+				}
+				for(size_t i = 0;i < chunks.size();++i)
+				{
+					auto store = irBuilder.CreateStore(values[i],coerceByteIndexToPointer(dest,chunks[i].offset,chunks[i].type));
+					store->setVolatile(true);
+					store->setAlignment(LOAD_STORE_ALIGNMENT_PARAM);
+				}
+			}
+
+			// the intrinsics return their destination
+			push(dest);
+			return true;
+		}
+
 		//
 		// Numeric operator macros
 		//
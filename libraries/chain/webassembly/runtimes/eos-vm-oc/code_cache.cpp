@@ -26,7 +26,7 @@ namespace eosio { namespace chain { namespace eosvmoc {
 static constexpr size_t header_offset = 512u;
 static constexpr size_t header_size = 512u;
 static constexpr size_t total_header_size = header_offset + header_size;
-static constexpr uint64_t header_id = 0x32434f4d56534f45ULL; //"EOSVMOC2" little endian
+static constexpr uint64_t header_id = 0x33434f4d56534f45ULL; //"EOSVMOC3" little endian
 
 struct code_cache_header {
    uint64_t id = header_id;
@@ -304,6 +304,7 @@ code_cache_base::code_cache_base(const std::filesystem::path& data_dir, const eo
          if(cd.codegen_version != current_codegen_version) {
             allocator->deallocate(code_mapping + cd.code_begin);
             allocator->deallocate(code_mapping + cd.initdata_begin);
+            allocator->deallocate(code_mapping + cd.function_table_begin);
             continue;
          }
          _cache_index.push_back(std::move(cd));
@@ -368,6 +369,7 @@ code_cache_base::~code_cache_base() {
       for(unsigned int i = 0; i < 25 && _cache_index.size(); ++i) {
          allocator->deallocate(code_mapping + _cache_index.back().code_begin);
          allocator->deallocate(code_mapping + _cache_index.back().initdata_begin);
+         allocator->deallocate(code_mapping + _cache_index.back().function_table_begin);
          _cache_index.pop_back();
       }
    }
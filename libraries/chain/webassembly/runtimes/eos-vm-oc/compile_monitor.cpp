@@ -77,6 +77,7 @@ struct compile_monitor_session {
                for(const code_descriptor& cd : evict.codes) {
                   _allocator->deallocate(_code_mapping + cd.code_begin);
                   _allocator->deallocate(_code_mapping + cd.initdata_begin);
+                  _allocator->deallocate(_code_mapping + cd.function_table_begin);
                }
             },
             [&](const auto&) {
@@ -128,32 +129,39 @@ struct compile_monitor_session {
          
          void* code_ptr = nullptr;
          void* mem_ptr = nullptr;
+         void* function_table_ptr = nullptr;
          try {
-            if(success && std::holds_alternative<code_compilation_result_message>(message) && fds.size() == 2) {
+            if(success && std::holds_alternative<code_compilation_result_message>(message) && fds.size() == 3) {
                code_compilation_result_message& result = std::get<code_compilation_result_message>(message);
                code_ptr = _allocator->allocate(get_size_of_fd(fds[0]));
                mem_ptr = _allocator->allocate(get_size_of_fd(fds[1]));
+               function_table_ptr = _allocator->allocate(get_size_of_fd(fds[2]));
 
-               if(code_ptr == nullptr || mem_ptr == nullptr) {
+               if(code_ptr == nullptr || mem_ptr == nullptr || function_table_ptr == nullptr) {
                   _allocator->deallocate(code_ptr);
                   _allocator->deallocate(mem_ptr);
+                  _allocator->deallocate(function_table_ptr);
                   reply.result = compilation_result_toofull();
                }
                else {
                   copy_memfd_contents_to_pointer(code_ptr, fds[0]);
                   copy_memfd_contents_to_pointer(mem_ptr, fds[1]);
+                  copy_memfd_contents_to_pointer(function_table_ptr, fds[2]);
 
                   reply.result = code_descriptor {
                      code.code_id,
                      code.vm_version,
                      current_codegen_version,
                      (uintptr_t)code_ptr - (uintptr_t)_code_mapping,
+                     (unsigned)get_size_of_fd(fds[0]),
                      result.start,
                      result.apply_offset,
                      result.starting_memory_pages,
                      (uintptr_t)mem_ptr - (uintptr_t)_code_mapping,
                      (unsigned)get_size_of_fd(fds[1]),
-                     result.initdata_prologue_size
+                     result.initdata_prologue_size,
+                     (uintptr_t)function_table_ptr - (uintptr_t)_code_mapping,
+                     (unsigned)(get_size_of_fd(fds[2]) / sizeof(function_table_entry))
                   };
                }
             }
@@ -161,6 +169,7 @@ struct compile_monitor_session {
          catch(...) {
             _allocator->deallocate(code_ptr);
             _allocator->deallocate(mem_ptr);
+            _allocator->deallocate(function_table_ptr);
          }
 
          write_message_with_fds(_nodeos_instance_socket, reply);
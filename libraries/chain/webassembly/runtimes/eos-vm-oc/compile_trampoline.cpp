@@ -8,6 +8,8 @@
 #include <signal.h>
 #include <sys/resource.h>
 
+#include <algorithm>
+
 #include "IR/Module.h"
 #include "IR/Validate.h"
 #include "WASM/WASM.h"
@@ -27,6 +29,8 @@ void run_compile(wrapped_fd&& response_sock, wrapped_fd&& wasm_code, uint64_t st
    WASM::scoped_skip_checks no_check;
    WASM::serialize(stream, module);
    module.userSections.clear();
+   //injection may add imports, the profiler reports functions as indexed in the wasm as deployed
+   const size_t deployed_imports = module.functions.imports.size();
    wasm_injections::wasm_binary_injection injector(module);
    injector.inject();
 
@@ -131,9 +135,22 @@ void run_compile(wrapped_fd&& response_sock, wrapped_fd&& wasm_code, uint64_t st
    std::move(prologue_it, prologue.end(), std::back_inserter(initdata_prep));
    std::move(initial_mem.begin(), initial_mem.end(), std::back_inserter(initdata_prep));
 
+   //lets the profiler map an address within the code back to the wasm function it belongs to
+   std::vector<function_table_entry> function_table;
+   function_table.reserve(function_to_offsets.size());
+   for(const auto& [def_index, offset] : function_to_offsets)
+      function_table.push_back({(uint32_t)offset, (uint32_t)(def_index + deployed_imports)});
+   std::sort(function_table.begin(), function_table.end(), [](const function_table_entry& a, const function_table_entry& b) {
+      return a.code_offset < b.code_offset;
+   });
+   std::vector<uint8_t> function_table_bytes(function_table.size() * sizeof(function_table_entry));
+   if(function_table.size())
+      memcpy(function_table_bytes.data(), function_table.data(), function_table_bytes.size());
+
    std::vector<wrapped_fd> fds_to_send;
    fds_to_send.emplace_back(memfd_for_bytearray(code.code));
    fds_to_send.emplace_back(memfd_for_bytearray(initdata_prep));
+   fds_to_send.emplace_back(memfd_for_bytearray(function_table_bytes));
    write_message_with_fds(response_sock, result_message, fds_to_send);
 }
 
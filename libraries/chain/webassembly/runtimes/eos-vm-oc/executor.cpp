@@ -4,6 +4,7 @@
 #include <eosio/chain/webassembly/eos-vm-oc/intrinsic_mapping.hpp>
 #include <eosio/chain/webassembly/eos-vm-oc/intrinsic.hpp>
 #include <eosio/chain/webassembly/eos-vm-oc/eos-vm-oc.h>
+#include <eosio/chain/webassembly/eos-vm-oc/profiler.hpp>
 #include <eosio/chain/wasm_eosio_constraints.hpp>
 #include <eosio/chain/apply_context.hpp>
 #include <eosio/chain/transaction_context.hpp>
@@ -35,6 +36,10 @@ namespace eosio { namespace chain { namespace eosvmoc {
 static constexpr auto signal_sentinel = 0x4D56534F45534559ul;
 
 static void(*chained_handler)(int,siginfo_t*,void*);
+
+//memory of the executing action on this thread whose writes are tracked, if any
+static thread_local memory* write_tracked_memory;
+
 static void segv_handler(int sig, siginfo_t* info, void* ctx)  {
    control_block* cb_in_main_segment;
 
@@ -59,6 +64,10 @@ static void segv_handler(int sig, siginfo_t* info, void* ctx)  {
       (uintptr_t)info->si_addr < cb_in_main_segment->execution_thread_code_start+cb_in_main_segment->execution_thread_code_length)
          siglongjmp(*cb_in_main_segment->jmp, EOSVMOC_EXIT_CHECKTIME_FAIL);
 
+   //was the segfault the first write to a write tracked page? If so let the write proceed
+   if(write_tracked_memory && write_tracked_memory->record_write((uintptr_t)info->si_addr))
+      return;
+
    //was the segfault within data?
    if((uintptr_t)info->si_addr >= cb_in_main_segment->execution_thread_memory_start &&
       (uintptr_t)info->si_addr < cb_in_main_segment->execution_thread_memory_start+cb_in_main_segment->execution_thread_memory_length)
@@ -168,14 +177,17 @@ void executor::execute(const code_descriptor& code, memory& mem, apply_context&
    EOS_ASSERT(code.starting_memory_pages <= (int)max_pages, wasm_execution_error, "Initial memory out of range");
 
    //prepare initial memory, mutable globals, and table data
+   bool track_writes = false;
    if(code.starting_memory_pages > 0 ) {
       uint64_t initial_page_offset = std::min(static_cast<std::size_t>(code.starting_memory_pages), mem.size_of_memory_slice_mapping()/memory::stride - 1);
       if(initial_page_offset < static_cast<uint64_t>(code.starting_memory_pages)) {
          mprotect(mem.full_page_memory_base() + initial_page_offset * eosio::chain::wasm_constraints::wasm_page_size,
                   (code.starting_memory_pages - initial_page_offset) * eosio::chain::wasm_constraints::wasm_page_size, PROT_READ | PROT_WRITE);
       }
+      else
+         track_writes = initial_page_offset >= memory::dirty_tracking_min_pages;
       arch_prctl(ARCH_SET_GS, (unsigned long*)(mem.zero_page_memory_base()+initial_page_offset*memory::stride));
-      memset(mem.full_page_memory_base(), 0, 64u*1024u*code.starting_memory_pages);
+      mem.zero_linear_memory(code.starting_memory_pages);
    }
    else
       arch_prctl(ARCH_SET_GS, (unsigned long*)mem.zero_page_memory_base());
@@ -193,6 +205,10 @@ void executor::execute(const code_descriptor& code, memory& mem, apply_context&
       globals = mem.full_page_memory_base();
    }
 
+   //the pages holding data segments are rewritten by every action, only writes past them are worth tracking
+   const uint64_t initdata_pages = (code.initdata_size - code.initdata_prologue_size + eosio::chain::wasm_constraints::wasm_page_size - 1) / eosio::chain::wasm_constraints::wasm_page_size;
+   mem.mark_written(initdata_pages);
+
    control_block* const cb = mem.get_control_block();
    cb->magic = signal_sentinel;
    cb->execution_thread_code_start = (uintptr_t)code_mapping;
@@ -212,6 +228,7 @@ void executor::execute(const code_descriptor& code, memory& mem, apply_context&
    cb->running_code_base = (uintptr_t)(code_mapping + code.code_begin);
    cb->is_running = true;
    cb->globals = globals;
+   cb->linear_memory_pages_high_water = -1;
 
    context.trx_context.transaction_timer.set_expiration_callback([](void* user) {
       executor* self = (executor*)user;
@@ -220,11 +237,23 @@ void executor::execute(const code_descriptor& code, memory& mem, apply_context&
    }, this);
    context.trx_context.checktime(); //catch any expiration that might have occurred before setting up callback
 
-   auto cleanup = fc::make_scoped_exit([cb, &tt=context.trx_context.transaction_timer, &mem=mem](){
+   //set up after the checktime above so that an action which never starts is not sampled
+   profiler::scoped_sampling sampling(code, code_mapping, context.get_receiver());
+
+   auto cleanup = fc::make_scoped_exit([cb, &tt=context.trx_context.transaction_timer, &mem=mem, track_writes, starting_pages=code.starting_memory_pages](){
       cb->is_running = false;
       cb->bounce_buffers->clear();
       tt.set_expiration_callback(nullptr, nullptr);
 
+      //writes made through the slice of any other memory size are not tracked, so once the memory size changed
+      //every page it had may have been written
+      if(track_writes) {
+         write_tracked_memory = nullptr;
+         mem.stop_write_tracking();
+      }
+      if(!track_writes || cb->linear_memory_pages_high_water >= 0)
+         mem.mark_written(std::max<int64_t>({starting_pages, cb->current_linear_memory_pages, cb->linear_memory_pages_high_water, 0}));
+
       int64_t base_pages = mem.size_of_memory_slice_mapping()/memory::stride - 1;
       if(cb->current_linear_memory_pages > base_pages) {
          mprotect(mem.full_page_memory_base() + base_pages * eosio::chain::wasm_constraints::wasm_page_size,
@@ -232,6 +261,11 @@ void executor::execute(const code_descriptor& code, memory& mem, apply_context&
       }
    });
 
+   if(track_writes) {
+      mem.start_write_tracking(initdata_pages, code.starting_memory_pages);
+      write_tracked_memory = &mem;
+   }
+
    void(*apply_func)(uint64_t, uint64_t, uint64_t) = (void(*)(uint64_t, uint64_t, uint64_t))(cb->running_code_base + code.apply_offset);
 
    switch(sigsetjmp(*cb->jmp, 0)) {
@@ -44,6 +44,10 @@ int32_t eos_vm_oc_grow_memory(int32_t grow, int32_t max) {
    cb_ptr->current_linear_memory_pages += grow_amount;
    cb_ptr->first_invalid_memory_address += grow_amount*64*1024;
 
+   int64_t high_water = (int64_t)previous_page_count > cb_ptr->current_linear_memory_pages ? (int64_t)previous_page_count : cb_ptr->current_linear_memory_pages;
+   if(high_water > cb_ptr->linear_memory_pages_high_water)
+      cb_ptr->linear_memory_pages_high_water = high_water;
+
    if(grow_amount > 0)
       memset(cb_ptr->full_linear_memory_start + previous_page_count*64u*1024u, 0, grow_amount*64u*1024u);
 
@@ -5,6 +5,8 @@
 
 #include <fc/scoped_exit.hpp>
 
+#include <algorithm>
+
 #include <unistd.h>
 #include <sys/mman.h>
 
@@ -47,4 +49,72 @@ memory::~memory() {
    munmap(mapbase, mapsize);
 }
 
+void memory::zero_linear_memory(uint64_t pages) {
+   constexpr uint64_t page_size = wasm_constraints::wasm_page_size;
+   pages = std::min<uint64_t>(pages, written_pages.size());
+
+   // zero runs of written pages with a single memset each
+   for(uint64_t p = 0; p < pages;) {
+      if(!written_pages[p]) {
+         ++p;
+         continue;
+      }
+      uint64_t end = p;
+      while(end < pages && written_pages[end])
+         written_pages[end++] = 0;
+      memset(fullpage_base + p * page_size, 0, (end - p) * page_size);
+      p = end;
+   }
+}
+
+void memory::mark_written(uint64_t pages) {
+   if(written_pages.size() < pages)
+      written_pages.resize(pages);
+   std::fill_n(written_pages.begin(), pages, 1);
+}
+
+void memory::start_write_tracking(uint64_t first_page, uint64_t pages) {
+   constexpr uint64_t page_size = wasm_constraints::wasm_page_size;
+   if(first_page >= pages)
+      return;
+   // record_write() must not allocate
+   if(written_pages.size() < pages)
+      written_pages.resize(pages);
+
+   tracked_slice = zeropage_base + pages * stride;
+   tracked_first_page = first_page;
+   tracked_end_page = pages;
+   mprotect(tracked_slice + first_page * page_size, (pages - first_page) * page_size, PROT_READ);
+   mprotect(fullpage_base + first_page * page_size, (pages - first_page) * page_size, PROT_READ);
+}
+
+bool memory::record_write(uintptr_t addr) {
+   constexpr uint64_t page_size = wasm_constraints::wasm_page_size;
+   if(!tracked_slice)
+      return false;
+
+   for(uint8_t* base : {tracked_slice, fullpage_base}) {
+      if(addr < (uintptr_t)(base + tracked_first_page * page_size) || addr >= (uintptr_t)(base + tracked_end_page * page_size))
+         continue;
+      const uint64_t p = (addr - (uintptr_t)base) / page_size;
+      written_pages[p] = 1;
+      mprotect(tracked_slice + p * page_size, page_size, PROT_READ | PROT_WRITE);
+      mprotect(fullpage_base + p * page_size, page_size, PROT_READ | PROT_WRITE);
+      return true;
+   }
+   return false;
+}
+
+void memory::stop_write_tracking() {
+   constexpr uint64_t page_size = wasm_constraints::wasm_page_size;
+   if(!tracked_slice)
+      return;
+
+   const uint64_t length = (tracked_end_page - tracked_first_page) * page_size;
+   mprotect(tracked_slice + tracked_first_page * page_size, length, PROT_READ | PROT_WRITE);
+   mprotect(fullpage_base + tracked_first_page * page_size, length, PROT_READ | PROT_WRITE);
+   tracked_slice = nullptr;
+   tracked_first_page = tracked_end_page = 0;
+}
+
 }}}
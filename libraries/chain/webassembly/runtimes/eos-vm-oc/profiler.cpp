@@ -0,0 +1,238 @@
+#include <eosio/chain/webassembly/eos-vm-oc/profiler.hpp>
+#include <eosio/chain/webassembly/eos-vm-oc/eos-vm-oc.hpp>
+
+#include <boost/unordered/unordered_flat_map.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+
+#include <signal.h>
+#include <time.h>
+#include <ucontext.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+
+#ifndef sigev_notify_thread_id
+#define sigev_notify_thread_id _sigev_un._tid
+#endif
+
+namespace eosio::chain::eosvmoc {
+
+namespace {
+
+constexpr uint32_t max_samples_per_action = 2048;
+constexpr uint32_t outside_of_code = UINT32_MAX;
+
+//written only by the SIGPROF handler of its thread while active; trivially constructible so that the
+//handler never has to initialize it
+struct sample_buffer {
+   volatile sig_atomic_t active;
+   uintptr_t             code_base;
+   uintptr_t             code_end;
+   uint32_t              count;
+   uint32_t              dropped;
+   uint32_t              offsets[max_samples_per_action];
+};
+thread_local sample_buffer samples;
+
+struct thread_timer {
+   timer_t  timer;
+   bool     created = false;
+   bool     armed = false;
+   uint32_t generation = 0;
+
+   //the function tables of the codes sampled on this thread, copied while the code mapping is known to be readable
+   std::unordered_map<digest_type, std::vector<function_table_entry>> function_tables;
+
+   ~thread_timer() {
+      if(created)
+         timer_delete(timer);
+   }
+};
+thread_local thread_timer the_thread_timer;
+
+//bumped on every start and stop, threads reconfigure their timer when they see it change
+std::atomic<uint32_t> configuration_generation = 0;
+std::atomic<uint32_t> configured_interval_us = 0;
+
+struct sample_key {
+   account_name contract;
+   digest_type  code_hash;
+   uint32_t     function_index;
+   bool operator==(const sample_key&) const = default;
+};
+struct sample_key_hash {
+   size_t operator()(const sample_key& k) const {
+      size_t seed = std::hash<uint64_t>()(k.contract.to_uint64_t());
+      seed ^= std::hash<digest_type>()(k.code_hash) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+      seed ^= std::hash<uint32_t>()(k.function_index) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+      return seed;
+   }
+};
+
+std::mutex                                                   samples_mtx;
+boost::unordered_flat_map<sample_key, uint64_t, sample_key_hash> sample_counts; // guarded by samples_mtx
+uint64_t                                                     total_samples = 0; // guarded by samples_mtx
+uint64_t                                                     dropped_samples = 0; // guarded by samples_mtx
+
+//the handler of SIGPROF before ours, e.g. that of the eos-vm-jit profiler, which gets the signals not taken in OC code
+struct sigaction previous_sigprof_action = {};
+
+void forward_to_previous_handler(int sig, siginfo_t* info, void* ctx) {
+   if(previous_sigprof_action.sa_flags & SA_SIGINFO) {
+      if(previous_sigprof_action.sa_sigaction)
+         previous_sigprof_action.sa_sigaction(sig, info, ctx);
+   }
+   else if(previous_sigprof_action.sa_handler != SIG_DFL && previous_sigprof_action.sa_handler != SIG_IGN) {
+      previous_sigprof_action.sa_handler(sig);
+   }
+}
+
+void sigprof_handler(int sig, siginfo_t* info, void* ctx) {
+   if(!samples.active) {
+      forward_to_previous_handler(sig, info, ctx);
+      return;
+   }
+   if(samples.count == max_samples_per_action) {
+      ++samples.dropped;
+      return;
+   }
+   const uintptr_t ip = static_cast<ucontext_t*>(ctx)->uc_mcontext.gregs[REG_RIP];
+   samples.offsets[samples.count++] = (ip >= samples.code_base && ip < samples.code_end) ? (uint32_t)(ip - samples.code_base) : outside_of_code;
+}
+
+//installs the handler unless it is installed already, keeping the one it replaces to forward to
+void install_sigprof_handler() {
+   static std::mutex install_mtx;
+   std::lock_guard g(install_mtx);
+
+   struct sigaction current;
+   sigaction(SIGPROF, nullptr, &current);
+   if((current.sa_flags & SA_SIGINFO) && current.sa_sigaction == sigprof_handler)
+      return;
+
+   struct sigaction sig_action;
+   sig_action.sa_sigaction = sigprof_handler;
+   sigemptyset(&sig_action.sa_mask);
+   //the signal is taken wherever the thread happens to be, don't fail its system calls with EINTR
+   sig_action.sa_flags = SA_SIGINFO | SA_RESTART;
+   previous_sigprof_action = current;
+   sigaction(SIGPROF, &sig_action, nullptr);
+}
+
+void configure_thread_timer(uint32_t interval_us) {
+   thread_timer& t = the_thread_timer;
+   if(interval_us && !t.created) {
+      struct sigevent sev = {};
+      sev.sigev_notify = SIGEV_THREAD_ID;
+      sev.sigev_signo = SIGPROF;
+      sev.sigev_notify_thread_id = syscall(SYS_gettid);
+      t.created = timer_create(CLOCK_THREAD_CPUTIME_ID, &sev, &t.timer) == 0;
+   }
+   if(t.created) {
+      struct itimerspec spec = {};
+      spec.it_interval.tv_sec = interval_us / 1000000;
+      spec.it_interval.tv_nsec = (interval_us % 1000000) * 1000;
+      spec.it_value = spec.it_interval;
+      t.armed = timer_settime(t.timer, 0, &spec, nullptr) == 0 && interval_us;
+   }
+   if(!interval_us)
+      t.function_tables.clear();
+}
+
+}
+
+void profiler::start(uint32_t interval_us) {
+   //reinstalled on every start, another profiler may have taken SIGPROF over since the last one
+   install_sigprof_handler();
+   configured_interval_us.store(interval_us, std::memory_order_relaxed);
+   configuration_generation.fetch_add(1, std::memory_order_release);
+}
+
+void profiler::stop() {
+   configured_interval_us.store(0, std::memory_order_relaxed);
+   configuration_generation.fetch_add(1, std::memory_order_release);
+}
+
+profiler::profile profiler::get() {
+   profile result;
+   result.interval_us = configured_interval_us;
+   result.running = result.interval_us != 0;
+
+   std::vector<std::pair<uint64_t, const sample_key*>> sorted;
+   std::lock_guard g(samples_mtx);
+   result.total_samples = total_samples;
+   result.dropped = dropped_samples;
+   sorted.reserve(sample_counts.size());
+   for(const auto& [key, count] : sample_counts)
+      sorted.emplace_back(count, &key);
+   std::sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b) { return a.first > b.first; });
+
+   result.folded_stacks.reserve(sorted.size());
+   for(const auto& [count, key] : sorted) {
+      std::string function = key->function_index == outside_of_code ? "[native]" : "wasm-function[" + std::to_string(key->function_index) + "]";
+      result.folded_stacks.push_back(key->contract.to_string() + ";" + key->code_hash.str() + ";" + function + " " + std::to_string(count));
+   }
+   return result;
+}
+
+void profiler::clear() {
+   std::lock_guard g(samples_mtx);
+   sample_counts.clear();
+   total_samples = 0;
+   dropped_samples = 0;
+}
+
+profiler::scoped_sampling::scoped_sampling(const code_descriptor& code, const uint8_t* code_mapping, account_name receiver)
+   : _code(code), _receiver(receiver) {
+   thread_timer& t = the_thread_timer;
+   //the interval stored before a generation is seen along with it
+   const uint32_t generation = configuration_generation.load(std::memory_order_acquire);
+   if(generation != t.generation) {
+      t.generation = generation;
+      configure_thread_timer(configured_interval_us.load(std::memory_order_relaxed));
+   }
+   if(!t.armed)
+      return;
+
+   auto& table = t.function_tables[code.code_hash];
+   if(table.empty() && code.function_table_size) {
+      const function_table_entry* begin = reinterpret_cast<const function_table_entry*>(code_mapping + code.function_table_begin);
+      table.assign(begin, begin + code.function_table_size);
+   }
+
+   samples.code_base = (uintptr_t)(code_mapping + code.code_begin);
+   samples.code_end = (uintptr_t)(code_mapping + code.code_begin + code.code_size);
+   samples.count = 0;
+   samples.dropped = 0;
+   std::atomic_signal_fence(std::memory_order_release);
+   samples.active = 1;
+   _sampling = true;
+}
+
+profiler::scoped_sampling::~scoped_sampling() {
+   if(!_sampling)
+      return;
+   samples.active = 0;
+   std::atomic_signal_fence(std::memory_order_acquire);
+
+   const auto& table = the_thread_timer.function_tables[_code.code_hash];
+   std::lock_guard g(samples_mtx);
+   for(uint32_t i = 0; i < samples.count; ++i) {
+      uint32_t function_index = outside_of_code;
+      if(samples.offsets[i] != outside_of_code) {
+         auto it = std::upper_bound(table.begin(), table.end(), samples.offsets[i], [](uint32_t offset, const function_table_entry& e) {
+            return offset < e.code_offset;
+         });
+         if(it != table.begin())
+            function_index = std::prev(it)->function_index;
+      }
+      ++sample_counts[sample_key{_receiver, _code.code_hash, function_index}];
+   }
+   total_samples += samples.count;
+   dropped_samples += samples.dropped;
+}
+
+}
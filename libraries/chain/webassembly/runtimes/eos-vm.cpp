@@ -1,5 +1,6 @@
 #include <eosio/chain/webassembly/eos-vm.hpp>
 #include <eosio/chain/webassembly/interface.hpp>
+#include <eosio/chain/webassembly/intrinsic_profiler.hpp>
 #include <eosio/chain/account_object.hpp>
 #include <eosio/chain/apply_context.hpp>
 #include <eosio/chain/transaction_context.hpp>
@@ -14,6 +15,10 @@
 #include <boost/hana/string.hpp>
 #include <boost/hana/equal.hpp>
 
+#include <fc/scoped_exit.hpp>
+
+#include <atomic>
+
 namespace eosio { namespace chain { namespace webassembly { namespace eos_vm_runtime {
 
 using namespace eosio::vm;
@@ -126,16 +131,23 @@ class eos_vm_instantiated_module : public wasm_instantiated_module_interface {
 
       eos_vm_instantiated_module(eos_vm_runtime<Impl>* runtime, std::unique_ptr<backend_t> mod) :
          _runtime(runtime),
-         _instantiated_module(std::move(mod)) {}
+         _instantiated_module(std::move(mod)),
+         _id(++_next_id) {}
 
       void apply(apply_context& context) override {
-         // set up backend to share the compiled mod in the instantiated
-         // module of the contract
-         _runtime->_bkend.share(*_instantiated_module);
-         // set exec ctx's mod to instantiated module's mod
-         _runtime->_exec_ctx.set_module(&(_instantiated_module->get_module()));
-         // link exe ctx to backend
-         _runtime->_bkend.set_context(&_runtime->_exec_ctx);
+         // The thread's backend and exec ctx stay bound to the last module applied on this thread; consecutive
+         // actions of the same contract (e.g. token transfers) skip binding them again. Ids are never reused, so
+         // a module instantiated after this one was evicted from the cache cannot be mistaken for it.
+         if (_runtime->_bound_module_id != _id) {
+            // set up backend to share the compiled mod in the instantiated
+            // module of the contract
+            _runtime->_bkend.share(*_instantiated_module);
+            // set exec ctx's mod to instantiated module's mod
+            _runtime->_exec_ctx.set_module(&(_instantiated_module->get_module()));
+            // link exe ctx to backend
+            _runtime->_bkend.set_context(&_runtime->_exec_ctx);
+            _runtime->_bound_module_id = _id;
+         }
          // set max_call_depth and max_pages to original values
          _runtime->_bkend.reset_max_call_depth();
          _runtime->_bkend.reset_max_pages();
@@ -171,6 +183,9 @@ class eos_vm_instantiated_module : public wasm_instantiated_module_interface {
    private:
       eos_vm_runtime<Impl>*            _runtime;
       std::unique_ptr<backend_t> _instantiated_module;
+      uint64_t                   _id;
+
+      inline static std::atomic<uint64_t> _next_id = 0;
 };
 
 #ifdef __x86_64__
@@ -290,6 +305,46 @@ template<typename Impl>
 thread_local typename eos_vm_runtime<Impl>::context_t eos_vm_runtime<Impl>::_exec_ctx;
 template<typename Impl>
 thread_local eos_vm_backend_t<Impl> eos_vm_runtime<Impl>::_bkend;
+template<typename Impl>
+thread_local uint64_t eos_vm_runtime<Impl>::_bound_module_id = 0;
+}
+
+// the id given to the host function by the intrinsic_profiler when it is registered
+template <auto HostFunction>
+uint32_t profiled_intrinsic_id = 0;
+
+template<auto F, typename R, typename... Args>
+R interface::profiled(Args... args) {
+   if (!intrinsic_profiler::enabled())
+      return (this->*F)(static_cast<Args&&>(args)...);
+   const uint64_t start = intrinsic_profiler::now();
+   // also accounts the calls which throw, eosio_exit always does
+   auto record = fc::make_scoped_exit([&]() {
+      intrinsic_profiler::record(context.get_receiver(), profiled_intrinsic_id<F>, intrinsic_profiler::now() - start);
+   });
+   return (this->*F)(static_cast<Args&&>(args)...);
+}
+
+template <auto HostFunction, typename T = decltype(HostFunction)>
+struct profiled_host_function;
+
+template <auto HostFunction, typename R, typename... Args>
+struct profiled_host_function<HostFunction, R (interface::*)(Args...)> {
+   static constexpr auto value = &interface::profiled<HostFunction, R, Args...>;
+};
+
+template <auto HostFunction, typename R, typename... Args>
+struct profiled_host_function<HostFunction, R (interface::*)(Args...) const> {
+   static constexpr auto value = &interface::profiled<HostFunction, R, Args...>;
+};
+
+template <auto HostFunction, bool is_injected>
+constexpr auto registered_host_function() {
+   // the injected functions are softfloat, which contracts call in their tightest loops; they are not profiled
+   if constexpr (is_injected)
+      return HostFunction;
+   else
+      return profiled_host_function<HostFunction>::value;
 }
 
 template <auto HostFunction, typename... Preconditions>
@@ -297,10 +352,13 @@ struct host_function_registrator {
    template <typename Mod, typename Name>
    constexpr host_function_registrator(Mod mod_name, Name fn_name) {
       using rhf_t = eos_vm_host_functions_t;
-      rhf_t::add<HostFunction, Preconditions...>(mod_name.c_str(), fn_name.c_str());
-#ifdef EOSIO_EOS_VM_OC_RUNTIME_ENABLED
       constexpr bool is_injected = (Mod() == BOOST_HANA_STRING(EOSIO_INJECTED_MODULE_NAME));
-      eosvmoc::register_eosvm_oc<HostFunction, is_injected, std::tuple<Preconditions...>>(
+      constexpr auto host_function = registered_host_function<HostFunction, is_injected>();
+      if constexpr (!is_injected)
+         profiled_intrinsic_id<HostFunction> = intrinsic_profiler::register_intrinsic(fn_name.c_str());
+      rhf_t::add<host_function, Preconditions...>(mod_name.c_str(), fn_name.c_str());
+#ifdef EOSIO_EOS_VM_OC_RUNTIME_ENABLED
+      eosvmoc::register_eosvm_oc<host_function, is_injected, std::tuple<Preconditions...>>(
           mod_name + BOOST_HANA_STRING(".") + fn_name);
 #endif
    }
@@ -7,4 +7,7 @@ namespace fc
 
    std::string zlib_compress(const std::string& in);
 
+   /// gzip format (RFC 1952), suitable for HTTP `Content-Encoding: gzip`
+   std::string gzip_compress(const std::string& in);
+
 } // namespace fc
@@ -4,6 +4,7 @@
 #include <fc/platform_independence.hpp>
 #include <fc/io/raw_fwd.hpp>
 #include <boost/functional/hash.hpp>
+#include <vector>
 
 namespace fc
 {
@@ -30,6 +31,13 @@ class sha256
     static sha256 hash( const std::string& );
     static sha256 hash( const sha256& );
 
+    /**
+     * Hash each pair of consecutive digests, out[i] = hash(in[2*i], in[2*i+1]) for i < num_pairs. Several pairs are
+     * hashed at once when the CPU supports it (AVX2 or the SHA extensions). out may be in, the result then replaces
+     * the first num_pairs digests.
+     */
+    static void hash_pairs( const sha256* in, size_t num_pairs, sha256* out );
+
     template<typename T>
     static sha256 hash( const T& t ) 
     { 
@@ -112,6 +120,18 @@ class sha256
 
   uint64_t hash64(const char* buf, size_t len);    
 
+  namespace detail {
+     /// an implementation of sha256::hash_pairs, usable only if supported by the CPU
+     struct sha256_hash_pairs_impl {
+        const char* name;
+        bool        supported;
+        void      (*hash_pairs)( const sha256* in, size_t num_pairs, sha256* out );
+     };
+
+     /// every implementation of sha256::hash_pairs built in, in order of preference, so that tests can check each of them
+     std::vector<sha256_hash_pairs_impl> sha256_hash_pairs_impls();
+  }
+
 } // fc
 
 namespace std
@@ -339,6 +339,9 @@ namespace fc {
      inline bool get( unsigned char& c ) { return mb.peek( &c, 1, index ); }
      inline bool get( char& c ) { return mb.peek( &c, 1, index ); }
 
+     /// number of bytes in the buffer past the ones peeked so far
+     inline uint32_t remaining() const { return mb.bytes_to_read_from_index( index ); }
+
   private:
      const message_buffer<buffer_len>& mb;
      typename message_buffer<buffer_len>::index_t index{0,0};
@@ -0,0 +1,236 @@
+#include <fc/crypto/sha256.hpp>
+
+#include <openssl/sha.h>
+#include <string.h>
+
+#if defined(__x86_64__)
+#include <cpuid.h>
+#include <immintrin.h>
+#endif
+
+/*
+ * sha256::hash_pairs hashes many messages of exactly 64 bytes (two digests), as done for every level of a merkle
+ * tree. Messages of the same length share their padding block, whose message schedule is computed once, and
+ * independent messages are hashed together: 8 at a time in the lanes of AVX2 registers, or 2 at a time interleaved
+ * through the SHA extensions so that the latency of one round is hidden by the round of the other message.
+ */
+
+namespace fc {
+
+namespace {
+
+   constexpr uint32_t k256[64] = {
+      0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+      0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+      0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+      0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+      0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+      0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+      0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+      0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+   };
+
+   constexpr uint32_t initial_state[8] = {
+      0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+   };
+
+   constexpr uint32_t rotr( uint32_t x, int n ) { return (x >> n) | (x << (32 - n)); }
+
+   /**
+    * W[t] + K[t] of the block padding a message of 64 bytes: 0x80, zeros and the message length of 512 bits
+    */
+   struct padding_schedule {
+      alignas(16) uint32_t wk[64] = {};
+
+      constexpr padding_schedule() {
+         uint32_t w[64] = {};
+         w[0]  = 0x80000000;
+         w[15] = 512;
+         for( int t = 16; t < 64; ++t ) {
+            uint32_t s0 = rotr(w[t-15], 7) ^ rotr(w[t-15], 18) ^ (w[t-15] >> 3);
+            uint32_t s1 = rotr(w[t-2], 17) ^ rotr(w[t-2], 19) ^ (w[t-2] >> 10);
+            w[t] = w[t-16] + s0 + w[t-7] + s1;
+         }
+         for( int t = 0; t < 64; ++t )
+            wk[t] = w[t] + k256[t];
+      }
+   };
+   constexpr padding_schedule padding;
+
+   void hash_pairs_openssl( const sha256* in, size_t num_pairs, sha256* out ) {
+      SHA256_CTX ctx;
+      for( size_t i = 0; i < num_pairs; ++i ) {
+         SHA256_Init( &ctx );
+         SHA256_Update( &ctx, in + 2*i, 2*sizeof(sha256) );
+         SHA256_Final( (uint8_t*)out[i].data(), &ctx );
+      }
+   }
+
+#if defined(__x86_64__)
+
+   #define FC_SHA256_ROTR_X8(x, n) _mm256_or_si256(_mm256_srli_epi32(x, n), _mm256_slli_epi32(x, 32 - (n)))
+
+   __attribute__((target("avx2"), always_inline))
+   inline void round_x8( __m256i (&s)[8], __m256i wk ) {
+      auto& [a, b, c, d, e, f, g, h] = s;
+      __m256i s1  = _mm256_xor_si256(_mm256_xor_si256(FC_SHA256_ROTR_X8(e, 6), FC_SHA256_ROTR_X8(e, 11)), FC_SHA256_ROTR_X8(e, 25));
+      __m256i ch  = _mm256_xor_si256(_mm256_and_si256(e, f), _mm256_andnot_si256(e, g));
+      __m256i t1  = _mm256_add_epi32(_mm256_add_epi32(_mm256_add_epi32(h, s1), ch), wk);
+      __m256i s0  = _mm256_xor_si256(_mm256_xor_si256(FC_SHA256_ROTR_X8(a, 2), FC_SHA256_ROTR_X8(a, 13)), FC_SHA256_ROTR_X8(a, 22));
+      __m256i maj = _mm256_or_si256(_mm256_and_si256(a, b), _mm256_and_si256(c, _mm256_or_si256(a, b)));
+      h = g; g = f; f = e;
+      e = _mm256_add_epi32(d, t1);
+      d = c; c = b; b = a;
+      a = _mm256_add_epi32(t1, _mm256_add_epi32(s0, maj));
+   }
+
+   /**
+    * Hash 8 messages of 64 bytes, one in each 32 bit lane
+    */
+   __attribute__((target("avx2")))
+   void hash_pairs_x8( const sha256* in, sha256* out ) {
+      const __m256i bswap = _mm256_set_epi8(12,13,14,15, 8,9,10,11, 4,5,6,7, 0,1,2,3,
+                                            12,13,14,15, 8,9,10,11, 4,5,6,7, 0,1,2,3);
+      const __m256i lanes = _mm256_set_epi32(7*64, 6*64, 5*64, 4*64, 3*64, 2*64, 64, 0);
+      const char* msgs = in->data();
+
+      __m256i w[16];
+      for( int t = 0; t < 16; ++t )
+         w[t] = _mm256_shuffle_epi8(_mm256_i32gather_epi32(reinterpret_cast<const int*>(msgs + 4*t), lanes, 1), bswap);
+
+      __m256i state[8], s[8];
+      for( int i = 0; i < 8; ++i )
+         s[i] = state[i] = _mm256_set1_epi32(initial_state[i]);
+
+      for( int t = 0; t < 64; ++t ) {
+         if( t >= 16 ) {
+            __m256i w15 = w[(t-15) & 15], w2 = w[(t-2) & 15];
+            __m256i s0 = _mm256_xor_si256(_mm256_xor_si256(FC_SHA256_ROTR_X8(w15, 7), FC_SHA256_ROTR_X8(w15, 18)), _mm256_srli_epi32(w15, 3));
+            __m256i s1 = _mm256_xor_si256(_mm256_xor_si256(FC_SHA256_ROTR_X8(w2, 17), FC_SHA256_ROTR_X8(w2, 19)), _mm256_srli_epi32(w2, 10));
+            w[t & 15] = _mm256_add_epi32(_mm256_add_epi32(w[t & 15], s0), _mm256_add_epi32(w[(t-7) & 15], s1));
+         }
+         round_x8(s, _mm256_add_epi32(w[t & 15], _mm256_set1_epi32(k256[t])));
+      }
+      for( int i = 0; i < 8; ++i )
+         s[i] = state[i] = _mm256_add_epi32(state[i], s[i]);
+
+      for( int t = 0; t < 64; ++t )
+         round_x8(s, _mm256_set1_epi32(padding.wk[t]));
+
+      alignas(32) uint32_t words[8][8];
+      for( int i = 0; i < 8; ++i )
+         _mm256_store_si256(reinterpret_cast<__m256i*>(words[i]), _mm256_shuffle_epi8(_mm256_add_epi32(state[i], s[i]), bswap));
+      for( int lane = 0; lane < 8; ++lane ) {
+         for( int i = 0; i < 8; ++i )
+            memcpy(out[lane].data() + 4*i, &words[i][lane], 4);
+      }
+   }
+
+   #undef FC_SHA256_ROTR_X8
+
+   /**
+    * Hash 2 messages of 64 bytes with the SHA extensions, the state is kept as ABEF / CDGH as the round instructions
+    * expect
+    */
+   __attribute__((target("sha,sse4.1")))
+   void hash_pairs_sha_ni_x2( const sha256* in, sha256* out ) {
+      constexpr int n = 2;
+      const __m128i bswap = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+
+      __m128i tmp       = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(initial_state)), 0xB1);     // CDAB
+      __m128i cdgh_init = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(initial_state + 4)), 0x1B); // EFGH
+      const __m128i abef_init = _mm_alignr_epi8(tmp, cdgh_init, 8);
+      cdgh_init = _mm_blend_epi16(cdgh_init, tmp, 0xF0);
+
+      __m128i abef[n], cdgh[n], msg[n][4];
+      for( int j = 0; j < n; ++j ) {
+         abef[j] = abef_init;
+         cdgh[j] = cdgh_init;
+         for( int i = 0; i < 4; ++i )
+            msg[j][i] = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in[2*j].data() + 16*i)), bswap);
+      }
+
+      // 4 rounds at a time, computing the message schedule 4 words at a time ahead of its use
+      for( int i = 0; i < 16; ++i ) {
+         const __m128i k = _mm_loadu_si128(reinterpret_cast<const __m128i*>(k256 + 4*i));
+         for( int j = 0; j < n; ++j ) {
+            __m128i m = _mm_add_epi32(msg[j][i & 3], k);
+            cdgh[j] = _mm_sha256rnds2_epu32(cdgh[j], abef[j], m);
+            abef[j] = _mm_sha256rnds2_epu32(abef[j], cdgh[j], _mm_shuffle_epi32(m, 0x0E));
+            if( i >= 3 && i < 15 ) {
+               __m128i& w = msg[j][(i + 1) & 3];
+               w = _mm_add_epi32(w, _mm_alignr_epi8(msg[j][i & 3], msg[j][(i - 1) & 3], 4));
+               w = _mm_sha256msg2_epu32(w, msg[j][i & 3]);
+            }
+            if( i >= 1 && i < 13 )
+               msg[j][(i - 1) & 3] = _mm_sha256msg1_epu32(msg[j][(i - 1) & 3], msg[j][i & 3]);
+         }
+      }
+
+      __m128i abef_mid[n], cdgh_mid[n];
+      for( int j = 0; j < n; ++j ) {
+         abef_mid[j] = abef[j] = _mm_add_epi32(abef[j], abef_init);
+         cdgh_mid[j] = cdgh[j] = _mm_add_epi32(cdgh[j], cdgh_init);
+      }
+      for( int i = 0; i < 16; ++i ) {
+         const __m128i m = _mm_load_si128(reinterpret_cast<const __m128i*>(padding.wk + 4*i));
+         for( int j = 0; j < n; ++j ) {
+            cdgh[j] = _mm_sha256rnds2_epu32(cdgh[j], abef[j], m);
+            abef[j] = _mm_sha256rnds2_epu32(abef[j], cdgh[j], _mm_shuffle_epi32(m, 0x0E));
+         }
+      }
+
+      for( int j = 0; j < n; ++j ) {
+         tmp = _mm_shuffle_epi32(_mm_add_epi32(abef[j], abef_mid[j]), 0x1B);         // FEBA
+         __m128i dchg = _mm_shuffle_epi32(_mm_add_epi32(cdgh[j], cdgh_mid[j]), 0xB1); // DCHG
+         _mm_storeu_si128(reinterpret_cast<__m128i*>(out[j].data()), _mm_shuffle_epi8(_mm_blend_epi16(tmp, dchg, 0xF0), bswap));
+         _mm_storeu_si128(reinterpret_cast<__m128i*>(out[j].data() + 16), _mm_shuffle_epi8(_mm_alignr_epi8(dchg, tmp, 8), bswap));
+      }
+   }
+
+   bool cpu_has_sha_extensions() {
+      unsigned eax, ebx, ecx, edx;
+      if( !__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx) )
+         return false;
+      return (ebx & bit_SHA) && __builtin_cpu_supports("sse4.1");
+   }
+
+   template<size_t Lanes, void (*Kernel)( const sha256*, sha256* )>
+   void hash_pairs_batched( const sha256* in, size_t num_pairs, sha256* out ) {
+      size_t i = 0;
+      for( ; i + Lanes <= num_pairs; i += Lanes )
+         Kernel( in + 2*i, out + i );
+      hash_pairs_openssl( in + 2*i, num_pairs - i, out + i );
+   }
+
+#endif
+
+   using hash_pairs_fn = void (*)( const sha256* in, size_t num_pairs, sha256* out );
+
+   hash_pairs_fn select_hash_pairs() {
+      for( const auto& impl : detail::sha256_hash_pairs_impls() ) {
+         if( impl.supported )
+            return impl.hash_pairs;
+      }
+      return &hash_pairs_openssl;
+   }
+
+} // anonymous namespace
+
+   std::vector<detail::sha256_hash_pairs_impl> detail::sha256_hash_pairs_impls() {
+      std::vector<sha256_hash_pairs_impl> impls;
+#if defined(__x86_64__)
+      __builtin_cpu_init();
+      impls.push_back( {"sha-ni", cpu_has_sha_extensions(), &hash_pairs_batched<2, hash_pairs_sha_ni_x2>} );
+      impls.push_back( {"avx2", static_cast<bool>(__builtin_cpu_supports("avx2")), &hash_pairs_batched<8, hash_pairs_x8>} );
+#endif
+      impls.push_back( {"openssl", true, &hash_pairs_openssl} );
+      return impls;
+   }
+
+   void sha256::hash_pairs( const sha256* in, size_t num_pairs, sha256* out ) {
+      static const hash_pairs_fn impl = select_hash_pairs();
+      impl( in, num_pairs, out );
+   }
+
+} // fc
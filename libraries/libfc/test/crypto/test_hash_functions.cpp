@@ -2,6 +2,8 @@
 
 #include <fc/crypto/hex.hpp>
 #include <fc/crypto/sha3.hpp>
+#include <fc/crypto/sha256.hpp>
+#include <fc/io/raw.hpp>
 #include <fc/utility.hpp>
 
 using namespace fc;
@@ -66,4 +68,50 @@ BOOST_AUTO_TEST_CASE(keccak256) try {
 
 } FC_LOG_AND_RETHROW();
 
+BOOST_AUTO_TEST_CASE(sha256_hash_pairs) try {
+
+   // counts around the number of pairs hashed at once by every implementation, and remainders hashed one pair at a time
+   const auto impls = fc::detail::sha256_hash_pairs_impls();
+   for(size_t num_pairs : {0, 1, 2, 3, 5, 7, 8, 9, 15, 16, 17, 23, 1001}) {
+      std::vector<fc::sha256> digests;
+      for(size_t i = 0; i < 2 * num_pairs; ++i)
+         digests.push_back(fc::sha256::hash(std::to_string(i)));
+
+      std::vector<fc::sha256> expected;
+      for(size_t i = 0; i < num_pairs; ++i)
+         expected.push_back(fc::sha256::hash(std::make_pair(digests[2 * i], digests[2 * i + 1])));
+
+      std::vector<fc::sha256> result(num_pairs);
+      fc::sha256::hash_pairs(digests.data(), num_pairs, result.data());
+      BOOST_CHECK(result == expected);
+
+      // each implementation the CPU supports, not only the one hash_pairs picked
+      for(const auto& impl : impls) {
+         if(!impl.supported)
+            continue;
+         BOOST_TEST_CONTEXT(impl.name << " with " << num_pairs << " pairs") {
+            std::vector<fc::sha256> impl_result(num_pairs);
+            impl.hash_pairs(digests.data(), num_pairs, impl_result.data());
+            BOOST_CHECK(impl_result == expected);
+
+            std::vector<fc::sha256> in_place = digests;
+            impl.hash_pairs(in_place.data(), num_pairs, in_place.data());
+            in_place.resize(num_pairs);
+            BOOST_CHECK(in_place == expected);
+         }
+      }
+
+      // in place
+      fc::sha256::hash_pairs(digests.data(), num_pairs, digests.data());
+      digests.resize(num_pairs);
+      BOOST_CHECK(digests == expected);
+   }
+
+   for(const auto& impl : impls) {
+      if(!impl.supported)
+         BOOST_TEST_MESSAGE("sha256::hash_pairs implementation " << impl.name << " not supported by this CPU, not tested");
+   }
+
+} FC_LOG_AND_RETHROW();
+
 BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
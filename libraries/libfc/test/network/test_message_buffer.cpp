@@ -323,6 +323,7 @@ BOOST_AUTO_TEST_CASE(message_buffer_datastream) {
 
    for( int i = 0; i < 3; ++i ) {
       auto ds2 = mbuff.create_peek_datastream();
+      BOOST_CHECK_EQUAL( 1024u, ds2.remaining() );
       fc::raw::unpack( ds2, v );
       BOOST_CHECK_EQUAL( 13, v );
       fc::raw::unpack( ds2, v );
@@ -330,6 +331,8 @@ BOOST_AUTO_TEST_CASE(message_buffer_datastream) {
       std::string s;
       fc::raw::unpack( ds2, s );
       BOOST_CHECK_EQUAL( s, std::string( "hello" ) );
+      BOOST_CHECK_EQUAL( 1024u - 2 * sizeof(int) - 6, ds2.remaining() );
+      BOOST_CHECK_EQUAL( 1024u, mbuff.bytes_to_read() );
    }
 
    {
@@ -1,9 +1,20 @@
 #include <eosio/state_history/compression.hpp>
+#include <eosio/chain/exceptions.hpp>
+
+#include <fc/io/fstream.hpp>
 
 #include <boost/iostreams/device/back_inserter.hpp>
 #include <boost/iostreams/filter/zlib.hpp>
 #include <boost/iostreams/filtering_stream.hpp>
 
+#ifdef EOSIO_ZSTD_ENABLED
+#include <zdict.h>
+#include <zstd.h>
+#endif
+
+#include <map>
+#include <mutex>
+
 namespace eosio {
 namespace state_history {
 
@@ -28,7 +39,241 @@ bytes zlib_decompress(std::string_view data) {
    return out;
 }
 
+compression_codec compression_codec_from_string(const std::string& name) {
+   if (name == "zlib")
+      return compression_codec::zlib;
+   if (name == "zstd")
+      return compression_codec::zstd;
+   EOS_THROW(chain::plugin_config_exception, "unknown state history compression codec ${n}, expected zlib or zstd", ("n", name));
+}
+
+const char* to_string(compression_codec codec) {
+   switch (codec) {
+   case compression_codec::zlib: return "zlib";
+   case compression_codec::zstd: return "zstd";
+   }
+   return "unknown";
+}
+
+bool is_supported(compression_codec codec) {
+#ifdef EOSIO_ZSTD_ENABLED
+   return true;
+#else
+   return codec != compression_codec::zstd;
+#endif
+}
+
+namespace {
+std::mutex                                   dictionaries_mtx;
+std::map<uint32_t, zstd_dictionary_ptr>      dictionaries;
+} // namespace
+
+zstd_dictionary_ptr load_zstd_dictionary(const std::filesystem::path& file) {
+   std::string content;
+   fc::read_file_contents(file, content);
+   auto dict = std::make_shared<const zstd_dictionary>(bytes(content.begin(), content.end()));
+   register_zstd_dictionary(dict);
+   return dict;
+}
+
+void register_zstd_dictionary(zstd_dictionary_ptr dict) {
+   std::lock_guard g(dictionaries_mtx);
+   dictionaries[dict->id()] = std::move(dict);
+}
+
+zstd_dictionary_ptr find_zstd_dictionary(uint32_t id) {
+   std::lock_guard g(dictionaries_mtx);
+   auto itr = dictionaries.find(id);
+   return itr == dictionaries.end() ? nullptr : itr->second;
+}
+
+#ifdef EOSIO_ZSTD_ENABLED
+
+namespace {
+size_t check_zstd(size_t result, const char* what) {
+   EOS_ASSERT(!ZSTD_isError(result), chain::plugin_exception, "zstd ${what} failed: ${e}",
+              ("what", what)("e", ZSTD_getErrorName(result)));
+   return result;
+}
+} // namespace
+
+struct zstd_dictionary::impl {
+   ZSTD_DDict* ddict = nullptr;
+   uint32_t    id    = 0;
+   // compression dictionaries depend on the compression level, created on first use of each level
+   mutable std::mutex                 mtx;
+   mutable std::map<int, ZSTD_CDict*> cdicts;
+
+   ~impl() {
+      for (auto& [level, cdict] : cdicts)
+         ZSTD_freeCDict(cdict);
+      ZSTD_freeDDict(ddict);
+   }
+
+   const ZSTD_CDict* cdict(const bytes& content, int level) const {
+      std::lock_guard g(mtx);
+      auto& cdict = cdicts[level];
+      if (!cdict)
+         cdict = ZSTD_createCDict(content.data(), content.size(), level);
+      EOS_ASSERT(cdict, chain::plugin_exception, "unable to create zstd compression dictionary");
+      return cdict;
+   }
+};
+
+zstd_dictionary::zstd_dictionary(bytes content)
+    : content_(std::move(content))
+    , my(std::make_unique<impl>()) {
+   my->id = ZDICT_getDictID(content_.data(), content_.size());
+   EOS_ASSERT(my->id != 0, chain::plugin_config_exception, "not a zstd dictionary");
+   my->ddict = ZSTD_createDDict(content_.data(), content_.size());
+   EOS_ASSERT(my->ddict, chain::plugin_config_exception, "unable to load zstd dictionary ${id}", ("id", my->id));
+}
+
+zstd_dictionary::~zstd_dictionary() = default;
+
+uint32_t zstd_dictionary::id() const { return my->id; }
+
+bytes train_zstd_dictionary(const std::vector<bytes>& samples, size_t max_size) {
+   bytes               buffer;
+   std::vector<size_t> sizes;
+   sizes.reserve(samples.size());
+   for (const auto& s : samples) {
+      buffer.insert(buffer.end(), s.begin(), s.end());
+      sizes.push_back(s.size());
+   }
+   bytes dict(max_size);
+   size_t size = ZDICT_trainFromBuffer(dict.data(), dict.size(), buffer.data(), sizes.data(), sizes.size());
+   EOS_ASSERT(!ZDICT_isError(size), chain::plugin_exception, "zstd dictionary training failed: ${e}",
+              ("e", ZDICT_getErrorName(size)));
+   dict.resize(size);
+   return dict;
+}
+
+namespace detail {
+
+struct zstd_compressor_impl::impl {
+   ZSTD_CCtx*          cctx = nullptr;
+   int                 level;
+   zstd_dictionary_ptr dict;
+
+   void reset() {
+      check_zstd(ZSTD_CCtx_reset(cctx, ZSTD_reset_session_and_parameters), "reset");
+      if (dict)
+         check_zstd(ZSTD_CCtx_refCDict(cctx, dict->get_impl().cdict(dict->content(), level)), "dictionary");
+      else
+         check_zstd(ZSTD_CCtx_setParameter(cctx, ZSTD_c_compressionLevel, level), "level");
+   }
+};
+
+zstd_compressor_impl::zstd_compressor_impl(int level, zstd_dictionary_ptr dict)
+    : my(std::make_unique<impl>()) {
+   my->level = level ? level : ZSTD_CLEVEL_DEFAULT;
+   my->dict  = std::move(dict);
+   my->cctx  = ZSTD_createCCtx();
+   EOS_ASSERT(my->cctx, chain::plugin_exception, "unable to create zstd compression context");
+   my->reset();
+}
+
+zstd_compressor_impl::~zstd_compressor_impl() { ZSTD_freeCCtx(my->cctx); }
+
+bool zstd_compressor_impl::filter(const char*& src_begin, const char* src_end, char*& dest_begin, char* dest_end, bool flush) {
+   ZSTD_inBuffer  in{src_begin, static_cast<size_t>(src_end - src_begin), 0};
+   ZSTD_outBuffer out{dest_begin, static_cast<size_t>(dest_end - dest_begin), 0};
+   size_t remaining = check_zstd(ZSTD_compressStream2(my->cctx, &out, &in, flush ? ZSTD_e_end : ZSTD_e_continue), "compression");
+   src_begin += in.pos;
+   dest_begin += out.pos;
+   return !flush || remaining != 0;
+}
+
+void zstd_compressor_impl::close() { my->reset(); }
+
+struct zstd_decompressor_impl::impl {
+   ZSTD_DCtx* dctx    = nullptr;
+   bool       started = false;
+};
+
+zstd_decompressor_impl::zstd_decompressor_impl()
+    : my(std::make_unique<impl>()) {
+   my->dctx = ZSTD_createDCtx();
+   EOS_ASSERT(my->dctx, chain::plugin_exception, "unable to create zstd decompression context");
+}
+
+zstd_decompressor_impl::~zstd_decompressor_impl() { ZSTD_freeDCtx(my->dctx); }
+
+bool zstd_decompressor_impl::filter(const char*& src_begin, const char* src_end, char*& dest_begin, char* dest_end, bool flush) {
+   if (!my->started && src_begin != src_end) {
+      // the frame header names the dictionary, if any, the frame was compressed with
+      if (uint32_t id = ZSTD_getDictID_fromFrame(src_begin, src_end - src_begin)) {
+         auto dict = find_zstd_dictionary(id);
+         EOS_ASSERT(dict, chain::plugin_exception, "zstd dictionary ${id} required to decompress state history entry is not loaded",
+                    ("id", id));
+         check_zstd(ZSTD_DCtx_refDDict(my->dctx, dict->get_impl().ddict), "dictionary");
+      }
+      my->started = true;
+   }
+   ZSTD_inBuffer  in{src_begin, static_cast<size_t>(src_end - src_begin), 0};
+   ZSTD_outBuffer out{dest_begin, static_cast<size_t>(dest_end - dest_begin), 0};
+   size_t remaining = check_zstd(ZSTD_decompressStream(my->dctx, &out, &in), "decompression");
+   src_begin += in.pos;
+   dest_begin += out.pos;
+   if (remaining == 0)
+      return false; // end of frame
+   EOS_ASSERT(!flush || in.pos || out.pos, chain::plugin_exception, "truncated zstd frame");
+   return true;
+}
+
+void zstd_decompressor_impl::close() {
+   check_zstd(ZSTD_DCtx_reset(my->dctx, ZSTD_reset_session_and_parameters), "reset");
+   my->started = false;
+}
+
+} // namespace detail
+
+#else
+
+struct zstd_dictionary::impl {};
+
+zstd_dictionary::zstd_dictionary(bytes content) {
+   EOS_THROW(chain::plugin_config_exception, "zstd dictionaries require a build with ENABLE_ZSTD");
+}
+
+zstd_dictionary::~zstd_dictionary() = default;
+
+uint32_t zstd_dictionary::id() const { return 0; }
+
+bytes train_zstd_dictionary(const std::vector<bytes>& samples, size_t max_size) {
+   EOS_THROW(chain::plugin_config_exception, "zstd dictionaries require a build with ENABLE_ZSTD");
+}
+
+namespace detail {
+
+struct zstd_compressor_impl::impl {};
+
+zstd_compressor_impl::zstd_compressor_impl(int level, zstd_dictionary_ptr dict) {
+   EOS_THROW(chain::plugin_exception, "zstd compression requires a build with ENABLE_ZSTD");
+}
+
+zstd_compressor_impl::~zstd_compressor_impl() = default;
+
+bool zstd_compressor_impl::filter(const char*&, const char*, char*&, char*, bool) { return false; }
+
+void zstd_compressor_impl::close() {}
+
+struct zstd_decompressor_impl::impl {};
+
+zstd_decompressor_impl::zstd_decompressor_impl() {
+   EOS_THROW(chain::plugin_exception, "state history entry is compressed with zstd which requires a build with ENABLE_ZSTD");
+}
+
+zstd_decompressor_impl::~zstd_decompressor_impl() = default;
+
+bool zstd_decompressor_impl::filter(const char*&, const char*, char*&, char*, bool) { return false; }
+
+void zstd_decompressor_impl::close() {}
+
+} // namespace detail
 
+#endif
 
 } // namespace state_history
 } // namespace eosio
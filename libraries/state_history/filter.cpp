@@ -0,0 +1,295 @@
+#include <eosio/state_history/filter.hpp>
+#include <eosio/chain/exceptions.hpp>
+
+#include <fc/io/raw.hpp>
+
+#include <algorithm>
+
+namespace eosio {
+namespace state_history {
+
+namespace {
+
+// reads an entry held in memory, rows and traces are copied straight out of it
+class memory_stream {
+public:
+   explicit memory_stream(std::string_view entry)
+       : ds(entry.data(), entry.size()) {}
+
+   bool read(char* d, size_t n) {
+      EOS_ASSERT(ds.remaining() >= n, chain::plugin_exception, "truncated state history log entry");
+      return ds.read(d, n);
+   }
+   bool get(char& c) { return read(&c, 1); }
+   bool get(unsigned char& c) { return read(reinterpret_cast<char*>(&c), 1); }
+   void skip(size_t n) {
+      EOS_ASSERT(ds.remaining() >= n, chain::plugin_exception, "truncated state history log entry");
+      ds.skip(n);
+   }
+
+   // bytes read from mark() to append_marked() are appended to out
+   void mark() { marked = ds.pos(); }
+   void append_marked(bytes& out) const { out.insert(out.end(), marked, ds.pos()); }
+
+private:
+   fc::datastream<const char*> ds;
+   const char*                 marked = nullptr;
+};
+
+// reads an entry as it is decompressed, only the bytes read since mark() are held in memory
+class streambuf_stream {
+public:
+   explicit streambuf_stream(std::streambuf& in)
+       : in(in) {}
+
+   bool read(char* d, size_t n) {
+      EOS_ASSERT(in.sgetn(d, n) == static_cast<std::streamsize>(n), chain::plugin_exception,
+                 "truncated state history log entry");
+      if (marking)
+         marked.insert(marked.end(), d, d + n);
+      return true;
+   }
+   bool get(char& c) { return read(&c, 1); }
+   bool get(unsigned char& c) { return read(reinterpret_cast<char*>(&c), 1); }
+   void skip(size_t n) {
+      char buf[4096];
+      for (size_t left = n; left;) {
+         const size_t s = std::min(left, sizeof(buf));
+         read(buf, s);
+         left -= s;
+      }
+   }
+
+   void mark() {
+      marked.clear();
+      marking = true;
+   }
+   void append_marked(bytes& out) const { out.insert(out.end(), marked.begin(), marked.end()); }
+
+private:
+   std::streambuf& in;
+   bytes           marked;
+   bool            marking = false;
+};
+
+template <typename Stream>
+void skip(Stream& ds, size_t n) { ds.skip(n); }
+
+template <typename T, typename Stream>
+T read(Stream& ds) {
+   T v;
+   fc::raw::unpack(ds, v);
+   return v;
+}
+
+template <typename Stream>
+uint32_t read_size(Stream& ds) { return read<fc::unsigned_int>(ds).value; }
+
+// bytes and string
+template <typename Stream>
+void skip_bytes(Stream& ds) { skip(ds, read_size(ds)); }
+
+// vector of 16 byte pairs, e.g. permission_level or account_delta
+template <typename Stream>
+void skip_pairs(Stream& ds) { skip(ds, size_t(read_size(ds)) * 16); }
+
+template <typename Stream, typename T>
+void skip_optional(Stream& ds, T&& skip_value) {
+   if (read<bool>(ds))
+      skip_value(ds);
+}
+
+void append(bytes& out, const char* begin, const char* end) { out.insert(out.end(), begin, end); }
+
+template <typename T>
+void append(bytes& out, const T& v) {
+   auto packed = fc::raw::pack(v);
+   out.insert(out.end(), packed.begin(), packed.end());
+}
+
+bool is_contract_table(const std::string& name) { return name.starts_with("contract_"); }
+
+} // namespace
+
+entry_filter::entry_filter(const get_blocks_request_v1& req)
+    : contracts(req.contracts)
+    , tables(req.tables)
+    , actions(req.actions) {
+   std::sort(contracts.begin(), contracts.end());
+   std::sort(tables.begin(), tables.end());
+   std::sort(actions.begin(), actions.end());
+}
+
+bool entry_filter::match_contract(chain::name n) const {
+   return contracts.empty() || std::binary_search(contracts.begin(), contracts.end(), n);
+}
+
+bool entry_filter::match_table(chain::name n) const {
+   return tables.empty() || std::binary_search(tables.begin(), tables.end(), n);
+}
+
+bool entry_filter::match_action(chain::name n) const {
+   return actions.empty() || std::binary_search(actions.begin(), actions.end(), n);
+}
+
+// vector<table_delta>, see pack_deltas(); every contract_* row starts with variant index 0, code, scope and table
+template <typename Stream>
+bytes entry_filter::read_filtered_deltas(Stream& ds) const {
+   bytes    tables_out;
+   uint32_t num_tables_out = 0;
+
+   const uint32_t num_tables = read_size(ds);
+   for (uint32_t t = 0; t < num_tables; ++t) {
+      const auto version  = read<fc::unsigned_int>(ds);
+      const auto name     = read<std::string>(ds);
+      const auto num_rows = read_size(ds);
+      const bool contract = is_contract_table(name);
+      // secondary indices, and their contract_table rows, carry the index number in the low 4 bits of the table
+      const uint64_t table_mask = name == "contract_row" ? ~uint64_t(0) : ~uint64_t(0xf);
+
+      bytes    rows_out;
+      uint32_t num_rows_out = 0;
+      for (uint32_t r = 0; r < num_rows; ++r) {
+         ds.mark();
+         read<bool>(ds); // present
+         const uint32_t size = read_size(ds);
+         if (!contract || size < 1 + 3 * sizeof(uint64_t)) {
+            skip(ds, size);
+            continue;
+         }
+         char head[1 + 3 * sizeof(uint64_t)];
+         ds.read(head, sizeof(head));
+         skip(ds, size - sizeof(head));
+         uint64_t code, table;
+         memcpy(&code, head + 1, sizeof(code));
+         memcpy(&table, head + 1 + 2 * sizeof(uint64_t), sizeof(table));
+         if (match_contract(chain::name(code)) && match_table(chain::name(table & table_mask))) {
+            ds.append_marked(rows_out);
+            ++num_rows_out;
+         }
+      }
+
+      if (num_rows_out) {
+         append(tables_out, version);
+         append(tables_out, name);
+         append(tables_out, fc::unsigned_int(num_rows_out));
+         append(tables_out, rows_out.data(), rows_out.data() + rows_out.size());
+         ++num_tables_out;
+      }
+   }
+
+   bytes out;
+   append(out, fc::unsigned_int(num_tables_out));
+   append(out, tables_out.data(), tables_out.data() + tables_out.size());
+   return out;
+}
+
+bytes entry_filter::filter_deltas(std::string_view entry) const {
+   memory_stream ds(entry);
+   return read_filtered_deltas(ds);
+}
+
+bytes entry_filter::filter_deltas(std::streambuf& entry) const {
+   streambuf_stream ds(entry);
+   return read_filtered_deltas(ds);
+}
+
+namespace {
+
+// skips a transaction_trace, see the history serialization of augmented_transaction_trace;
+// returns true if one of its action traces, or of its failed deferred transaction, matches
+template <typename Stream, typename MatchAction>
+bool skip_transaction_trace(Stream& ds, const MatchAction& match_action) {
+   read<fc::unsigned_int>(ds);                    // variant index
+   skip(ds, sizeof(chain::transaction_id_type));  // id
+   skip(ds, sizeof(uint8_t) + sizeof(uint32_t)); // status, cpu_usage_us
+   read<fc::unsigned_int>(ds);                    // net_usage_words
+   skip(ds, sizeof(int64_t) + sizeof(uint64_t) + sizeof(bool)); // elapsed, net_usage, scheduled
+
+   bool matched = false;
+   const uint32_t num_actions = read_size(ds);
+   for (uint32_t a = 0; a < num_actions; ++a) {
+      read<fc::unsigned_int>(ds); // variant index
+      read<fc::unsigned_int>(ds); // action_ordinal
+      read<fc::unsigned_int>(ds); // creator_action_ordinal
+      skip_optional(ds, [](Stream& ds) {                                    // receipt
+         read<fc::unsigned_int>(ds);                                        // variant index
+         skip(ds, sizeof(uint64_t) + sizeof(chain::digest_type) + 2 * sizeof(uint64_t)); // receiver, act_digest, global_sequence, recv_sequence
+         skip_pairs(ds);                                                    // auth_sequence
+         read<fc::unsigned_int>(ds);                                        // code_sequence
+         read<fc::unsigned_int>(ds);                                        // abi_sequence
+      });
+      const auto receiver = read<uint64_t>(ds);
+      const auto account  = read<uint64_t>(ds);
+      const auto name     = read<uint64_t>(ds);
+      skip_pairs(ds);                                  // authorization
+      skip_bytes(ds);                                  // data
+      skip(ds, sizeof(bool) + sizeof(int64_t));        // context_free, elapsed
+      skip_bytes(ds);                                  // console
+      skip_pairs(ds);                                  // account_ram_deltas
+      skip_optional(ds, skip_bytes<Stream>);           // except
+      skip_optional(ds, [](Stream& ds) { skip(ds, sizeof(uint64_t)); }); // error_code
+      skip_bytes(ds);                                  // return_value
+      matched = matched || match_action(chain::name(receiver), chain::name(account), chain::name(name));
+   }
+
+   skip_optional(ds, [](Stream& ds) { skip(ds, 2 * sizeof(uint64_t)); }); // account_ram_delta
+   skip_optional(ds, skip_bytes<Stream>);                                 // except
+   skip_optional(ds, [](Stream& ds) { skip(ds, sizeof(uint64_t)); });     // error_code
+   skip_optional(ds, [&](Stream& ds) {                                    // failed_dtrx_trace
+      matched = skip_transaction_trace(ds, match_action) || matched;
+   });
+   skip_optional(ds, [](Stream& ds) {                                     // partial
+      read<fc::unsigned_int>(ds);                                         // variant index
+      skip(ds, sizeof(uint32_t) + sizeof(uint16_t) + sizeof(uint32_t));   // expiration, ref_block_num, ref_block_prefix
+      read<fc::unsigned_int>(ds);                                         // max_net_usage_words
+      skip(ds, sizeof(uint8_t));                                          // max_cpu_usage_ms
+      read<fc::unsigned_int>(ds);                                         // delay_sec
+      read<chain::extensions_type>(ds);                                   // transaction_extensions
+      read<std::vector<chain::signature_type>>(ds);                       // signatures
+      const uint32_t num_cfd = read_size(ds);                             // context_free_data
+      for (uint32_t i = 0; i < num_cfd; ++i)
+         skip_bytes(ds);
+   });
+   return matched;
+}
+
+} // namespace
+
+// vector<transaction_trace>, see trace_converter::pack()
+template <typename Stream>
+bytes entry_filter::read_filtered_traces(Stream& ds) const {
+   auto match = [this](chain::name receiver, chain::name account, chain::name name) {
+      return (match_contract(receiver) || match_contract(account)) && match_action(name);
+   };
+
+   bytes    traces_out;
+   uint32_t num_traces_out = 0;
+
+   const uint32_t num_traces = read_size(ds);
+   for (uint32_t t = 0; t < num_traces; ++t) {
+      ds.mark();
+      if (skip_transaction_trace(ds, match)) {
+         ds.append_marked(traces_out);
+         ++num_traces_out;
+      }
+   }
+
+   bytes out;
+   append(out, fc::unsigned_int(num_traces_out));
+   append(out, traces_out.data(), traces_out.data() + traces_out.size());
+   return out;
+}
+
+bytes entry_filter::filter_traces(std::string_view entry) const {
+   memory_stream ds(entry);
+   return read_filtered_traces(ds);
+}
+
+bytes entry_filter::filter_traces(std::streambuf& entry) const {
+   streambuf_stream ds(entry);
+   return read_filtered_traces(ds);
+}
+
+} // namespace state_history
+} // namespace eosio
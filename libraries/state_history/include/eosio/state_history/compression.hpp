@@ -2,6 +2,11 @@
 
 #include <eosio/chain/types.hpp>
 
+#include <boost/iostreams/filter/symmetric.hpp>
+
+#include <filesystem>
+#include <memory>
+
 namespace eosio {
 namespace state_history {
 
@@ -10,5 +15,105 @@ using chain::bytes;
 bytes zlib_compress_bytes(const bytes& in);
 bytes zlib_decompress(std::string_view);
 
+/**
+ * Tag written at the start of a state history log entry payload, selects how the rest of the entry is compressed.
+ * The tag is read per entry so that a log may contain entries written with different codecs.
+ */
+enum class compression_codec : uint32_t {
+   zlib = 1, // uint64_t uncompressed size followed by a zlib stream
+   zstd = 2, // uint64_t uncompressed size followed by a zstd frame, which may reference a trained dictionary
+};
+
+/// throws for an unknown codec name
+compression_codec compression_codec_from_string(const std::string& name);
+const char* to_string(compression_codec codec);
+/// false for zstd when built without ENABLE_ZSTD
+bool is_supported(compression_codec codec);
+
+/**
+ * zstd dictionary trained on sample entries (see leap-util state-history train-dictionary). A frame compressed with
+ * a dictionary records the dictionary id, readers look the dictionary up by that id in the registry below.
+ */
+class zstd_dictionary {
+public:
+   explicit zstd_dictionary(bytes content);
+   ~zstd_dictionary();
+
+   uint32_t     id() const;
+   const bytes& content() const { return content_; }
+
+   struct impl;
+   const impl& get_impl() const { return *my; }
+
+private:
+   bytes                 content_;
+   std::unique_ptr<impl> my;
+};
+using zstd_dictionary_ptr = std::shared_ptr<const zstd_dictionary>;
+
+/// thread safe, load a dictionary from file and register it for decompression
+zstd_dictionary_ptr load_zstd_dictionary(const std::filesystem::path& file);
+/// thread safe
+void register_zstd_dictionary(zstd_dictionary_ptr dict);
+/// thread safe, nullptr if no dictionary with id has been registered
+zstd_dictionary_ptr find_zstd_dictionary(uint32_t id);
+
+/// train a dictionary of at most max_size bytes from samples of uncompressed entries
+bytes train_zstd_dictionary(const std::vector<bytes>& samples, size_t max_size);
+
+struct compression_config {
+   compression_codec   codec = compression_codec::zlib;
+   int                 level = 0; // 0 for the default level of codec
+   zstd_dictionary_ptr dictionary; // only used by zstd
+};
+
+namespace detail {
+
+// SymmetricFilter implementations, see boost/iostreams/filter/symmetric.hpp
+class zstd_compressor_impl {
+public:
+   typedef char char_type;
+
+   zstd_compressor_impl(int level, zstd_dictionary_ptr dict);
+   ~zstd_compressor_impl();
+
+   bool filter(const char*& src_begin, const char* src_end, char*& dest_begin, char* dest_end, bool flush);
+   void close();
+
+private:
+   struct impl;
+   std::unique_ptr<impl> my;
+};
+
+class zstd_decompressor_impl {
+public:
+   typedef char char_type;
+
+   zstd_decompressor_impl();
+   ~zstd_decompressor_impl();
+
+   bool filter(const char*& src_begin, const char* src_end, char*& dest_begin, char* dest_end, bool flush);
+   void close();
+
+private:
+   struct impl;
+   std::unique_ptr<impl> my;
+};
+
+} // namespace detail
+
+/// boost iostreams filter writing a single zstd frame
+struct zstd_compressor : boost::iostreams::symmetric_filter<detail::zstd_compressor_impl> {
+   explicit zstd_compressor(int level = 0, zstd_dictionary_ptr dict = {},
+                            std::streamsize buffer_size = boost::iostreams::default_device_buffer_size)
+       : symmetric_filter(buffer_size, level, std::move(dict)) {}
+};
+
+/// boost iostreams filter reading a single zstd frame, the dictionary it references must have been registered
+struct zstd_decompressor : boost::iostreams::symmetric_filter<detail::zstd_decompressor_impl> {
+   explicit zstd_decompressor(std::streamsize buffer_size = boost::iostreams::default_device_buffer_size)
+       : symmetric_filter(buffer_size) {}
+};
+
 } // namespace state_history
 } // namespace eosio
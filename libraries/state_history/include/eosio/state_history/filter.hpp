@@ -0,0 +1,53 @@
+#pragma once
+
+#include <eosio/state_history/types.hpp>
+
+#include <streambuf>
+#include <string_view>
+
+namespace eosio {
+namespace state_history {
+
+/**
+ * Selects the parts of stored trace and delta log entries that match the filters of a get_blocks_request_v1, see
+ * get_blocks_request_v1 for the semantics.
+ *
+ * Entries are walked in their serialized form: contract_* rows are matched on the code and table that lead every row,
+ * and transaction traces are skipped over field by field without unpacking action data, so only the selected bytes
+ * are copied. Entries too large to hold in memory, e.g. the initial chain state, are filtered as they are decompressed.
+ */
+class entry_filter {
+public:
+   /// entries up to this size are read whole and filtered in memory, larger ones are filtered from their stream
+   static constexpr uint64_t max_entry_size = 64 * 1024 * 1024;
+
+   explicit entry_filter(const get_blocks_request_v1& req);
+
+   /// false if the request has no filters
+   bool empty() const { return contracts.empty() && tables.empty() && actions.empty(); }
+
+   /// filtered copy of a chain state log entry
+   bytes filter_deltas(std::string_view entry) const;
+   bytes filter_deltas(std::streambuf& entry) const;
+
+   /// filtered copy of a trace log entry
+   bytes filter_traces(std::string_view entry) const;
+   bytes filter_traces(std::streambuf& entry) const;
+
+private:
+   template <typename Stream>
+   bytes read_filtered_deltas(Stream& ds) const;
+   template <typename Stream>
+   bytes read_filtered_traces(Stream& ds) const;
+
+   bool match_contract(chain::name n) const;
+   bool match_table(chain::name n) const;
+   bool match_action(chain::name n) const;
+
+   std::vector<chain::name> contracts; // sorted
+   std::vector<chain::name> tables;    // sorted
+   std::vector<chain::name> actions;   // sorted
+};
+
+} // namespace state_history
+} // namespace eosio
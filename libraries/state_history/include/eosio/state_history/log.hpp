@@ -106,17 +106,17 @@ struct locked_decompress_stream {
    : lock(std::move(l)) {};
 
    template <typename StateHistoryLog>
-   void init(StateHistoryLog&& log, fc::cfile& stream, uint64_t compressed_size) {
+   void init(StateHistoryLog&& log, fc::cfile& stream, uint64_t compressed_size, state_history::compression_codec codec) {
       auto istream = std::make_unique<bio::filtering_istreambuf>();
-      istream->push(bio::zlib_decompressor());
+      push_decompressor(*istream, codec);
       istream->push(bio::restrict(bio::file_source(stream.get_file_path().string()), stream.tellp(), compressed_size));
       buf = std::move(istream);
    }
 
    template <typename LogData>
-   void init(LogData&& log, fc::datastream<const char*>& stream, uint64_t compressed_size) {
+   void init(LogData&& log, fc::datastream<const char*>& stream, uint64_t compressed_size, state_history::compression_codec codec) {
       auto istream = std::make_unique<bio::filtering_istreambuf>();
-      istream->push(bio::zlib_decompressor());
+      push_decompressor(*istream, codec);
       istream->push(bio::restrict(bio::file_source(log.filename), stream.pos() - log.data(), compressed_size));
       buf = std::move(istream);
    }
@@ -125,6 +125,14 @@ struct locked_decompress_stream {
       buf.emplace<std::vector<char>>( std::move(cbuf) );
       return std::get<std::vector<char>>(buf).size();
    }
+
+ private:
+   static void push_decompressor(bio::filtering_istreambuf& istream, state_history::compression_codec codec) {
+      if (codec == state_history::compression_codec::zstd)
+         istream.push(state_history::zstd_decompressor());
+      else
+         istream.push(bio::zlib_decompressor());
+   }
 };
 
 namespace detail {
@@ -149,13 +157,19 @@ template <typename Log, typename Stream>
 uint64_t read_unpacked_entry(Log&& log, Stream& stream, uint64_t payload_size, locked_decompress_stream& result) {
    // result has state_history_log mutex locked
 
+   // s is the compression_codec of the entry, entries of a log may have been written with different codecs
+   EOS_ASSERT(payload_size >= sizeof(uint32_t), chain::plugin_exception,
+              "corrupt state history log entry: payload of ${s} bytes is too small", ("s", payload_size));
    uint32_t s;
    stream.read((char*)&s, sizeof(s));
-   if (s == 1 && payload_size > (s + sizeof(uint32_t))) {
+   const bool zstd = s == static_cast<uint32_t>(state_history::compression_codec::zstd);
+   EOS_ASSERT(!zstd || payload_size >= sizeof(uint32_t) + sizeof(uint64_t), chain::plugin_exception,
+              "corrupt state history log entry: payload of ${s} bytes is too small for a zstd entry", ("s", payload_size));
+   if ((s == 1 && payload_size > (s + sizeof(uint32_t))) || zstd) {
       uint64_t compressed_size = payload_size - sizeof(uint32_t) - sizeof(uint64_t);
       uint64_t decompressed_size;
       stream.read((char*)&decompressed_size, sizeof(decompressed_size));
-      result.init(log, stream, compressed_size);
+      result.init(log, stream, compressed_size, static_cast<state_history::compression_codec>(s));
       return decompressed_size;
    } else {
       // Compressed deltas now exceeds 4GB on one of the public chains. This length prefix
@@ -284,6 +298,7 @@ class state_history_log {
  private:
    const char* const       name = "";
    state_history_log_config _config;
+   state_history::compression_config _compression;
 
    // provide exclusive access to all data of this object since accessed from the main thread and the ship thread
    mutable std::mutex      _mx;
@@ -303,9 +318,13 @@ class state_history_log {
    state_history_log( const state_history_log&) = delete;
 
    state_history_log(const char* name, const std::filesystem::path& log_dir,
-                     state_history_log_config conf = {})
+                     state_history_log_config conf = {}, state_history::compression_config compression = {})
        : name(name)
-       , _config(std::move(conf)) {
+       , _config(std::move(conf))
+       , _compression(std::move(compression)) {
+
+      EOS_ASSERT(state_history::is_supported(_compression.codec), chain::plugin_config_exception,
+                 "${c} compression of state history requires a build with ENABLE_ZSTD", ("c", state_history::to_string(_compression.codec)));
 
       log.set_file_path(log_dir/(std::string(name) + ".log"));
       index.set_file_path(log_dir/(std::string(name) + ".index"));
@@ -376,6 +395,10 @@ class state_history_log {
       return _config;
    }
 
+   const state_history::compression_config& compression() const {
+      return _compression;
+   }
+
    //        begin     end
    std::pair<uint32_t, uint32_t> block_range() const {
       std::lock_guard g(_mx);
@@ -419,11 +442,11 @@ class state_history_log {
          // In order to conserve memory usage for reading the chain state later, we need to
          // encode the uncompressed data size to the disk so that the reader can send the
          // decompressed data size before decompressing data. Here we use the number
-         // 1 indicates the format contains a 64 bits unsigned integer for decompressed data
+         // 1 (zlib) or 2 (zstd) to indicate the format contains a 64 bits unsigned integer for decompressed data
          // size and then the actually compressed data. The compressed data size can be
          // computed from the payload size in the header minus sizeof(uint32_t) + sizeof(uint64_t).
 
-         uint32_t s = 1;
+         uint32_t s = static_cast<uint32_t>(_compression.codec);
          stream.write((char*)&s, sizeof(s));
          uint64_t uncompressioned_size = 0;
          stream.skip(sizeof(uncompressioned_size));
@@ -434,7 +457,10 @@ class state_history_log {
          {
             bio::filtering_ostreambuf buf;
             buf.push(boost::ref(cnt));
-            buf.push(bio::zlib_compressor());
+            if (_compression.codec == state_history::compression_codec::zstd)
+               buf.push(state_history::zstd_compressor(_compression.level, _compression.dictionary));
+            else
+               buf.push(bio::zlib_compressor(_compression.level ? _compression.level : bio::zlib::default_compression));
             buf.push(bio::file_descriptor_sink(stream.fileno(), bio::never_close_handle));
             pack_to(buf);
          }
@@ -14,6 +14,11 @@ struct trace_converter {
 
    void add_transaction(const transaction_trace_ptr& trace, const chain::packed_transaction_ptr& transaction);
    void pack(boost::iostreams::filtering_ostreambuf& ds, bool trace_debug_mode, const chain::signed_block_ptr& block);
+
+   /// traces of block in block order, clears the cached traces; the result can be packed on another thread
+   std::vector<augmented_transaction_trace> take_traces(const chain::signed_block_ptr& block);
+   static void pack(boost::iostreams::filtering_ostreambuf& ds, bool trace_debug_mode,
+                    const std::vector<augmented_transaction_trace>& traces);
 };
 
 } // namespace state_history
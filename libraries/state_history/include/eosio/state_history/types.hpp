@@ -104,6 +104,16 @@ struct get_blocks_request_v0 {
    bool                        fetch_deltas           = false;
 };
 
+/// get_blocks_request_v0 that only sends the parts of traces and deltas a client is interested in. An empty filter
+/// matches everything. When any filter is set, deltas only contain the contract_* tables with rows of matching contracts
+/// and tables, and traces only contain the transactions with an action trace of a matching contract (receiver or
+/// action account) and action.
+struct get_blocks_request_v1 : get_blocks_request_v0 {
+   std::vector<chain::name> contracts = {};
+   std::vector<chain::name> tables    = {};
+   std::vector<chain::name> actions   = {};
+};
+
 struct get_blocks_ack_request_v0 {
    uint32_t num_messages = 0;
 };
@@ -121,7 +131,7 @@ struct get_blocks_result_v0 : get_blocks_result_base {
    std::optional<bytes>          deltas;
 };
 
-using state_request = std::variant<get_status_request_v0, get_blocks_request_v0, get_blocks_ack_request_v0>;
+using state_request = std::variant<get_status_request_v0, get_blocks_request_v0, get_blocks_ack_request_v0, get_blocks_request_v1>;
 using state_result  = std::variant<get_status_result_v0, get_blocks_result_v0>;
 
 } // namespace state_history
@@ -133,6 +143,7 @@ FC_REFLECT(eosio::state_history::block_position, (block_num)(block_id));
 FC_REFLECT_EMPTY(eosio::state_history::get_status_request_v0);
 FC_REFLECT(eosio::state_history::get_status_result_v0, (head)(last_irreversible)(trace_begin_block)(trace_end_block)(chain_state_begin_block)(chain_state_end_block)(chain_id));
 FC_REFLECT(eosio::state_history::get_blocks_request_v0, (start_block_num)(end_block_num)(max_messages_in_flight)(have_positions)(irreversible_only)(fetch_block)(fetch_traces)(fetch_deltas));
+FC_REFLECT_DERIVED(eosio::state_history::get_blocks_request_v1, (eosio::state_history::get_blocks_request_v0), (contracts)(tables)(actions));
 FC_REFLECT(eosio::state_history::get_blocks_ack_request_v0, (num_messages));
 FC_REFLECT(eosio::state_history::get_blocks_result_base, (head)(last_irreversible)(this_block)(prev_block)(block));
 FC_REFLECT_DERIVED(eosio::state_history::get_blocks_result_v0, (eosio::state_history::get_blocks_result_base), (traces)(deltas));
@@ -16,6 +16,10 @@ void trace_converter::add_transaction(const transaction_trace_ptr& trace, const
 }
 
 void trace_converter::pack(boost::iostreams::filtering_ostreambuf& obuf, bool trace_debug_mode, const chain::signed_block_ptr& block) {
+   pack(obuf, trace_debug_mode, take_traces(block));
+}
+
+std::vector<augmented_transaction_trace> trace_converter::take_traces(const chain::signed_block_ptr& block) {
    std::vector<augmented_transaction_trace> traces;
    if (onblock_trace)
       traces.push_back(*onblock_trace);
@@ -32,7 +36,11 @@ void trace_converter::pack(boost::iostreams::filtering_ostreambuf& obuf, bool tr
    }
    cached_traces.clear();
    onblock_trace.reset();
+   return traces;
+}
 
+void trace_converter::pack(boost::iostreams::filtering_ostreambuf& obuf, bool trace_debug_mode,
+                           const std::vector<augmented_transaction_trace>& traces) {
    fc::datastream<boost::iostreams::filtering_ostreambuf&> ds{obuf};
    return fc::raw::pack(ds, make_history_context_wrapper(trace_debug_mode, traces));
 }
@@ -16,8 +16,17 @@ public:
       : db(db) {}
 
    controller& db;
+
+   std::optional<boost::signals2::scoped_connection> accepted_block_connection;
+   std::optional<boost::signals2::scoped_connection> irreversible_block_connection;
 };
 
+// response only depends on head/LIB state, so it may be served from the http_plugin response cache
+static api_entry cacheable(api_entry&& entry) {
+   entry.cacheable = true;
+   return std::move(entry);
+}
+
 
 chain_api_plugin::chain_api_plugin() = default;
 chain_api_plugin::~chain_api_plugin() = default;
@@ -125,21 +134,28 @@ void chain_api_plugin::plugin_startup() {
 
    ro_api.set_shorten_abi_errors( !http_plugin::verbose_errors() );
 
+   my->accepted_block_connection.emplace(chain.chain().accepted_block.connect([&_http_plugin](const chain::block_signal_params&) {
+      _http_plugin.invalidate_response_cache();
+   }));
+   my->irreversible_block_connection.emplace(chain.chain().irreversible_block.connect([&_http_plugin](const chain::block_signal_params&) {
+      _http_plugin.invalidate_response_cache();
+   }));
+
    _http_plugin.add_api( {
-      CALL_WITH_400(chain, node, ro_api, chain_apis::read_only, get_info, 200, http_params_types::no_params)
+      cacheable(CALL_WITH_400(chain, node, ro_api, chain_apis::read_only, get_info, 200, http_params_types::no_params))
       }, appbase::exec_queue::read_only, appbase::priority::medium_high);
    _http_plugin.add_api({
       CHAIN_RO_CALL(get_activated_protocol_features, 200, http_params_types::possible_no_params),
-      CHAIN_RO_CALL_POST(get_block, fc::variant, 200, http_params_types::params_required), // _POST because get_block() returns a lambda to be executed on the http thread pool
-      CHAIN_RO_CALL(get_block_info, 200, http_params_types::params_required),
+      cacheable(CHAIN_RO_CALL_POST(get_block, fc::variant, 200, http_params_types::params_required)), // _POST because get_block() returns a lambda to be executed on the http thread pool
+      cacheable(CHAIN_RO_CALL(get_block_info, 200, http_params_types::params_required)),
       CHAIN_RO_CALL(get_block_header_state, 200, http_params_types::params_required),
       CHAIN_RO_CALL_POST(get_account, chain_apis::read_only::get_account_results, 200, http_params_types::params_required),
       CHAIN_RO_CALL(get_code, 200, http_params_types::params_required),
       CHAIN_RO_CALL(get_code_hash, 200, http_params_types::params_required),
       CHAIN_RO_CALL(get_consensus_parameters, 200, http_params_types::no_params),
-      CHAIN_RO_CALL(get_abi, 200, http_params_types::params_required),
+      cacheable(CHAIN_RO_CALL(get_abi, 200, http_params_types::params_required)),
       CHAIN_RO_CALL(get_raw_code_and_abi, 200, http_params_types::params_required),
-      CHAIN_RO_CALL(get_raw_abi, 200, http_params_types::params_required),
+      cacheable(CHAIN_RO_CALL(get_raw_abi, 200, http_params_types::params_required)),
       CHAIN_RO_CALL_POST(get_table_rows, chain_apis::read_only::get_table_rows_result, 200, http_params_types::params_required),
       CHAIN_RO_CALL(get_table_by_scope, 200, http_params_types::params_required),
       CHAIN_RO_CALL(get_currency_balance, 200, http_params_types::params_required),
@@ -168,6 +184,12 @@ void chain_api_plugin::plugin_startup() {
       });
    }
 
+   if (chain.token_balance_queries_enabled()) {
+      _http_plugin.add_async_api({
+         CHAIN_RO_CALL_WITH_400(get_token_balances, 200, http_params_types::params_required),
+      });
+   }
+
    _http_plugin.add_async_api({
       // chain_plugin send_read_only_transaction will post to read_exclusive queue
       CHAIN_RO_CALL_ASYNC(send_read_only_transaction, chain_apis::read_only::send_read_only_transaction_results, 200, http_params_types::params_required),
@@ -183,6 +205,11 @@ void chain_api_plugin::plugin_startup() {
 
 }
    
-void chain_api_plugin::plugin_shutdown() {}
+void chain_api_plugin::plugin_shutdown() {
+   if (my) {
+      my->accepted_block_connection.reset();
+      my->irreversible_block_connection.reset();
+   }
+}
 
 }
\ No newline at end of file
@@ -4,62 +4,18 @@
 #include <eosio/chain/controller.hpp>
 #include <eosio/chain/permission_object.hpp>
 
-#include <boost/multi_index_container.hpp>
-#include <boost/multi_index/ordered_index.hpp>
-#include <boost/multi_index/composite_key.hpp>
-#include <boost/multi_index/member.hpp>
+#include <fc/io/cfile.hpp>
+#include <fc/io/fstream.hpp>
+#include <fc/io/raw.hpp>
 
-#include <boost/bimap.hpp>
-#include <boost/bimap/multiset_of.hpp>
-#include <boost/bimap/set_of.hpp>
-
-#include <shared_mutex>
+#include <algorithm>
+#include <map>
+#include <memory>
 
 using namespace eosio;
 using namespace eosio::chain::literals;
-using namespace boost::multi_index;
-using namespace boost::bimaps;
 
 namespace {
-   /**
-    * Structure to hold indirect reference to a `property_object` via {owner,name} as well as a non-standard
-    * index over `last_updated_height` (which is truncated at the LIB during initialization) for roll-back support
-    */
-   struct permission_info {
-      // indexed data
-      chain::name    owner;
-      chain::name    name;
-      uint32_t       last_updated_height;
-
-      // un-indexed data
-      uint32_t       threshold;
-
-      using cref = std::reference_wrapper<const permission_info>;
-   };
-
-   struct by_owner_name;
-   struct by_last_updated_height;
-
-   /**
-    * Multi-index providing fast lookup for {owner,name} as well as {last_updated_height}
-    */
-   using permission_info_index_t = multi_index_container<
-      permission_info,
-      indexed_by<
-         ordered_unique<
-            tag<by_owner_name>,
-            composite_key<permission_info,
-               member<permission_info, chain::name, &permission_info::owner>,
-               member<permission_info, chain::name, &permission_info::name>
-            >
-         >,
-         ordered_non_unique<
-            tag<by_last_updated_height>,
-            member<permission_info, uint32_t, &permission_info::last_updated_height>
-         >
-      >
-   >;
-
    /**
     * Utility function to identify on-block action
     * @param p
@@ -89,6 +45,10 @@ namespace {
       static weighted upper_bound_for( const T& value ) {
          return {value, std::numeric_limits<chain::weight_type>::max()};
       }
+
+      friend bool operator<( const weighted& lhs, const weighted& rhs ) {
+         return std::tie(lhs.value, lhs.weight) < std::tie(rhs.value, rhs.weight);
+      }
    };
 
    template<typename Output, typename Input>
@@ -99,50 +59,116 @@ namespace {
          return {};
       }
    }
-}
 
-namespace std {
    /**
-    * support for using `permission_info::cref` in ordered containers
+    * The fields of a permission reported with each authorizer that matches it
     */
-   template<>
-   struct less<permission_info::cref> {
-      bool operator()( const permission_info::cref& lhs, const permission_info::cref& rhs ) const {
-         return std::uintptr_t(&lhs.get()) < std::uintptr_t(&rhs.get());
-      }
+   struct permission_info {
+      chain::name    owner;
+      chain::name    name;
+      uint32_t       threshold = 0;
+
+      chain::permission_level level() const { return {owner, name}; }
    };
 
    /**
-    * support for using `weighted<T>` in ordered containers
+    * State of a permission that differs from the base index, either because it changed after the base was built or
+    * because it has been rolled back. `last_updated_height` provides the roll-back support.
     */
-   template<typename T>
-   struct less<weighted<T>> {
-      bool operator()( const weighted<T>& lhs, const weighted<T>& rhs ) const {
-         return std::tie(lhs.value, lhs.weight) < std::tie(rhs.value, rhs.weight);
+   struct permission_record {
+      permission_info                                 info;
+      uint32_t                                        last_updated_height = 0;
+      bool                                            deleted = false; ///< hides the permission of the base index
+      std::vector<weighted<chain::permission_level>>  accounts;
+      std::vector<weighted<chain::public_key_type>>   keys;
+   };
+   using permission_record_ptr = std::shared_ptr<const permission_record>;
+
+   /**
+    * Immutable index of irreversible permissions, held in sorted arrays rather than node based containers to keep
+    * the memory footprint of large chains down. Authorizer entries refer to their permission by position.
+    */
+   struct base_index {
+      template<typename T>
+      using entries_t = std::vector<std::pair<weighted<T>, uint32_t>>; ///< sorted, with the position in permissions
+
+      std::vector<permission_info>             permissions; ///< sorted by owner, name
+      entries_t<chain::permission_level>       accounts;
+      entries_t<chain::public_key_type>        keys;
+
+      bool contains( const chain::permission_level& p ) const {
+         return std::binary_search(permissions.begin(), permissions.end(), p, [](const auto& lhs, const auto& rhs) {
+            return to_level(lhs) < to_level(rhs);
+         });
       }
+
+   private:
+      static chain::permission_level to_level( const permission_info& pi ) { return pi.level(); }
+      static const chain::permission_level& to_level( const chain::permission_level& p ) { return p; }
+   };
+   using base_index_ptr = std::shared_ptr<const base_index>;
+
+   /**
+    * Immutable index of the permission records, rebuilt by the writer for every block that changes them.
+    * A permission with a record is served from here only, never from the base index.
+    */
+   struct overlay_index {
+      std::map<chain::permission_level, permission_record_ptr>                      records;
+      std::multimap<weighted<chain::permission_level>, const permission_record*>    accounts;
+      std::multimap<weighted<chain::public_key_type>, const permission_record*>     keys;
+   };
+
+   /**
+    * What readers see, swapped atomically by the writer
+    */
+   struct index_snapshot {
+      base_index_ptr                          base;
+      std::shared_ptr<const overlay_index>    overlay;
    };
 
+   /**
+    * Header of the persisted index, followed by the base index arrays and the permission records
+    */
+   struct persisted_header {
+      static constexpr uint32_t expected_magic   = 0x42445141; // "AQDB"
+      static constexpr uint32_t current_version  = 1;
+
+      uint32_t                magic = expected_magic;
+      uint32_t                version = current_version;
+      chain::block_id_type    block_id; ///< head block the index reflects
+   };
+
+   /**
+    * Records of irreversible permissions are folded into a new base index once there are this many of them
+    */
+   constexpr size_t fold_threshold = 4096;
 }
 
+FC_REFLECT_TEMPLATE( (typename T), weighted<T>, (value)(weight) )
+FC_REFLECT( permission_info, (owner)(name)(threshold) )
+FC_REFLECT( permission_record, (info)(last_updated_height)(deleted)(accounts)(keys) )
+FC_REFLECT( persisted_header, (magic)(version)(block_id) )
+
 namespace eosio::chain_apis {
    /**
     * Implementation details of the account query DB
+    *
+    * All members other than `snapshot` belong to the thread calling `cache_transaction_trace` and `commit_block`.
+    * Readers only ever load `snapshot`, so lookups never wait for a block to be committed.
     */
    struct account_query_db_impl {
-      account_query_db_impl(const chain::controller& controller)
+      account_query_db_impl(const chain::controller& controller, std::filesystem::path persist_file)
       :controller(controller)
+      ,persist_file(std::move(persist_file))
       {}
 
       /**
-       * Build the initial database from the chain controller by extracting the information contained in the
-       * blockchain state at the current HEAD
+       * Load the persisted index if it was written at the current HEAD, otherwise build it from the information
+       * contained in the blockchain state at the current HEAD
        */
       void build_account_query_map() {
-         std::unique_lock write_lock(rw_mutex);
-
          ilog("Building account query DB");
          auto start = fc::time_point::now();
-         const auto& index = controller.db().get_index<chain::permission_index>().indices().get<by_id>();
 
          // build a initial time to block number map
          const auto lib_num = controller.last_irreversible_block_num();
@@ -154,61 +180,233 @@ namespace eosio::chain_apis {
             time_to_block_num.emplace(block_p->timestamp.to_time_point(), block_num);
          }
 
-         for (const auto& po : index ) {
-            uint32_t last_updated_height = last_updated_time_to_height(po.last_updated);
-            const auto& pi = permission_info_index.emplace( permission_info{ po.owner, po.name, last_updated_height, po.auth.threshold } ).first;
-            add_to_bimaps(*pi, po);
+         if (!load()) {
+            const auto& index = controller.db().get_index<chain::permission_index>().indices().get<chain::by_owner>();
+            std::vector<permission_record_ptr> irreversible;
+            for (const auto& po : index ) {
+               auto record = make_record(po, last_updated_time_to_height(po.last_updated));
+               if (record->last_updated_height > lib_num) {
+                  records.emplace(record->info.level(), std::move(record));
+               } else {
+                  irreversible.emplace_back(std::move(record));
+               }
+            }
+            base = merge_into_base(base_index(), irreversible);
          }
+         publish();
+
          auto duration = fc::time_point::now() - start;
          ilog("Finished building account query DB in ${sec}", ("sec", (duration.count() / 1'000'000.0 )));
       }
 
       /**
-       * Add a permission to the bimaps for keys and accounts
-       * @param pi - the ephemeral permission info structure being added
-       * @param po - the chain data associted with this permission
+       * Load the persisted index, only accepted if it was written for the current HEAD block as otherwise the chain
+       * state may have changed in ways that the index does not reflect
+       * @return true if the index was loaded
        */
-      void add_to_bimaps( const permission_info& pi, const chain::permission_object& po ) {
-         // For each account, add this permission info's non-owning reference to the bimap for accounts
-         for (const auto& a : po.auth.accounts) {
-            name_bimap.insert(name_bimap_t::value_type {{a.permission, a.weight}, pi});
+      bool load() {
+         if (persist_file.empty() || !std::filesystem::exists(persist_file))
+            return false;
+
+         try {
+            std::string content;
+            fc::read_file_contents(persist_file, content);
+            // a persisted index is only valid for the chain state it was written with
+            std::filesystem::remove(persist_file);
+
+            fc::datastream<const char*> ds(content.data(), content.size());
+            persisted_header header;
+            fc::raw::unpack(ds, header);
+            if (header.magic != persisted_header::expected_magic || header.version != persisted_header::current_version) {
+               wlog("Ignoring account query DB ${f} with unsupported version ${v}", ("f", persist_file.string())("v", header.version));
+               return false;
+            }
+            if (header.block_id != controller.head_block_id()) {
+               ilog("Ignoring account query DB ${f} written at block ${b}, head is ${h}",
+                    ("f", persist_file.string())("b", chain::block_header::num_from_id(header.block_id))("h", controller.head_block_num()));
+               return false;
+            }
+
+            auto loaded = std::make_shared<base_index>();
+            fc::raw::unpack(ds, loaded->permissions);
+            fc::raw::unpack(ds, loaded->accounts);
+            fc::raw::unpack(ds, loaded->keys);
+            std::vector<permission_record> loaded_records;
+            fc::raw::unpack(ds, loaded_records);
+
+            base = std::move(loaded);
+            for (auto& r : loaded_records) {
+               auto level = r.info.level();
+               records.emplace(level, std::make_shared<const permission_record>(std::move(r)));
+            }
+            ilog("Loaded account query DB ${f} written at block ${b}", ("f", persist_file.string())("b", controller.head_block_num()));
+            return true;
+         } FC_LOG_AND_DROP(("Unable to load account query DB ${f}, rebuilding it", ("f", persist_file.string())));
+
+         base.reset();
+         records.clear();
+         return false;
+      }
+
+      /**
+       * Write the index for the current HEAD block so that the next start can load it instead of building it
+       */
+      void persist() const {
+         if (persist_file.empty())
+            return;
+
+         auto tmp_file = persist_file;
+         tmp_file += ".tmp";
+         {
+            fc::datastream<fc::cfile> out;
+            out.set_file_path(tmp_file);
+            out.open(fc::cfile::truncate_rw_mode);
+            fc::raw::pack(out, persisted_header{ .block_id = controller.head_block_id() });
+            fc::raw::pack(out, base->permissions);
+            fc::raw::pack(out, base->accounts);
+            fc::raw::pack(out, base->keys);
+            fc::raw::pack(out, fc::unsigned_int(records.size()));
+            for (const auto& r : records) {
+               fc::raw::pack(out, *r.second);
+            }
+            out.flush();
+            out.close();
          }
+         std::filesystem::rename(tmp_file, persist_file);
+         ilog("Persisted account query DB to ${f} at block ${b}", ("f", persist_file.string())("b", controller.head_block_num()));
+      }
 
-         // for each key, add this permission info's non-owning reference to the bimap for keys
-         for (const auto& k: po.auth.keys) {
-            key_bimap.insert(key_bimap_t::value_type {{k.key.to_public_key(), k.weight}, pi});
+      static permission_record_ptr make_record( const chain::permission_object& po, uint32_t last_updated_height ) {
+         auto record = std::make_shared<permission_record>();
+         record->info = permission_info{ po.owner, po.name, po.auth.threshold };
+         record->last_updated_height = last_updated_height;
+         record->accounts.reserve(po.auth.accounts.size());
+         for (const auto& a : po.auth.accounts) {
+            record->accounts.push_back({a.permission, a.weight});
          }
+         record->keys.reserve(po.auth.keys.size());
+         for (const auto& k : po.auth.keys) {
+            record->keys.push_back({k.key.to_public_key(), k.weight});
+         }
+         return record;
+      }
+
+      static permission_record_ptr make_deleted_record( const chain::permission_level& p, uint32_t last_updated_height ) {
+         auto record = std::make_shared<permission_record>();
+         record->info = permission_info{ p.actor, p.permission, 0 };
+         record->last_updated_height = last_updated_height;
+         record->deleted = true;
+         return record;
       }
 
       /**
-       * Remove a permission from the bimaps for keys and accounts
-       * @param pi - the ephemeral permission info structure being removed
+       * Create a new base index from `old` with the given records applied
+       * @param old - the base index to start from
+       * @param changes - records sorted by permission without duplicates
        */
-      void remove_from_bimaps( const permission_info& pi ) {
-         // remove all entries from the name bimap that refer to this permission_info's reference
-         const auto name_range = name_bimap.right.equal_range(pi);
-         name_bimap.right.erase(name_range.first, name_range.second);
-
-         // remove all entries from the key bimap that refer to this permission_info's reference
-         const auto key_range = key_bimap.right.equal_range(pi);
-         key_bimap.right.erase(key_range.first, key_range.second);
+      static base_index_ptr merge_into_base( const base_index& old, const std::vector<permission_record_ptr>& changes ) {
+         auto result = std::make_shared<base_index>();
+         result->permissions.reserve(old.permissions.size() + changes.size());
+
+         // merge the permissions, remembering where each of the retained old permissions moved to
+         constexpr uint32_t dropped = std::numeric_limits<uint32_t>::max();
+         std::vector<uint32_t> old_to_new(old.permissions.size(), dropped);
+         std::vector<uint32_t> change_to_new(changes.size(), dropped);
+         size_t o = 0, c = 0;
+         while (o < old.permissions.size() || c < changes.size()) {
+            const bool take_old = c == changes.size() ||
+                                  (o < old.permissions.size() && old.permissions[o].level() < changes[c]->info.level());
+            if (take_old) {
+               old_to_new[o] = result->permissions.size();
+               result->permissions.push_back(old.permissions[o]);
+               ++o;
+               continue;
+            }
+            if (o < old.permissions.size() && old.permissions[o].level() == changes[c]->info.level()) {
+               ++o; // replaced by the change
+            }
+            if (!changes[c]->deleted) {
+               change_to_new[c] = result->permissions.size();
+               result->permissions.push_back(changes[c]->info);
+            }
+            ++c;
+         }
+
+         // remapping positions keeps the retained entries sorted, the entries of the changes are sorted and merged in
+         auto merge_entries = [&](const auto& old_entries, auto& new_entries, auto record_entries) {
+            using entries_t = std::decay_t<decltype(old_entries)>;
+            entries_t retained;
+            retained.reserve(old_entries.size());
+            for (const auto& e : old_entries) {
+               if (old_to_new[e.second] != dropped)
+                  retained.emplace_back(e.first, old_to_new[e.second]);
+            }
+            entries_t added;
+            for (size_t i = 0; i < changes.size(); ++i) {
+               if (change_to_new[i] == dropped)
+                  continue;
+               for (const auto& w : record_entries(*changes[i]))
+                  added.emplace_back(w, change_to_new[i]);
+            }
+            std::sort(added.begin(), added.end());
+            new_entries.reserve(retained.size() + added.size());
+            std::merge(retained.begin(), retained.end(), added.begin(), added.end(), std::back_inserter(new_entries));
+         };
+         merge_entries(old.accounts, result->accounts, [](const permission_record& r) -> const auto& { return r.accounts; });
+         merge_entries(old.keys, result->keys, [](const permission_record& r) -> const auto& { return r.keys; });
+
+         return result;
       }
 
-      bool is_rollback_required( const chain::signed_block_ptr& block ) const {
-         std::shared_lock read_lock(rw_mutex);
-         const auto bnum = block->block_num();
-         const auto& index = permission_info_index.get<by_last_updated_height>();
+      /**
+       * Move the records of irreversible permissions into a new base index once there are enough of them to be
+       * worth the copy of the base
+       */
+      void fold_irreversible_records() {
+         const auto lib_num = controller.last_irreversible_block_num();
+         std::vector<permission_record_ptr> irreversible;
+         for (const auto& r : records) {
+            if (r.second->last_updated_height <= lib_num)
+               irreversible.push_back(r.second);
+         }
+         if (irreversible.size() < fold_threshold)
+            return;
 
-         if (index.empty()) {
-            return false;
-         } else {
-            const auto& pi = (*index.rbegin());
-            if (pi.last_updated_height < bnum) {
-               return false;
+         base = merge_into_base(*base, irreversible);
+         for (const auto& r : irreversible) {
+            records.erase(r->info.level());
+         }
+      }
+
+      /**
+       * Make the current base index and records visible to readers
+       */
+      void publish() {
+         auto overlay = std::make_shared<overlay_index>();
+         overlay->records = records;
+         for (const auto& r : records) {
+            const auto& record = *r.second;
+            if (record.deleted)
+               continue;
+            for (const auto& a : record.accounts) {
+               overlay->accounts.emplace(a, &record);
+            }
+            for (const auto& k : record.keys) {
+               overlay->keys.emplace(k, &record);
             }
          }
 
-         return true;
+         auto next = std::make_shared<index_snapshot>();
+         next->base = base;
+         next->overlay = std::move(overlay);
+         std::atomic_store(&snapshot, std::shared_ptr<const index_snapshot>(std::move(next)));
+      }
+
+      bool is_rollback_required( const chain::signed_block_ptr& block ) const {
+         const auto bnum = block->block_num();
+         return std::any_of(records.begin(), records.end(), [bnum](const auto& r) {
+            return r.second->last_updated_height >= bnum;
+         });
       }
 
       uint32_t last_updated_time_to_height( const fc::time_point& last_updated) {
@@ -226,16 +424,14 @@ namespace eosio::chain_apis {
       }
 
       /**
-       * Given a block number, remove all permissions that were last updated at or after that block number
-       * this will effectively roll back the database to just before the incoming block
+       * Given a block number, reset all permissions that were last updated at or after that block number to their
+       * state at the HEAD of the chain, this will effectively roll back the database to just before the incoming block
        *
-       * For each removed entry, this will create a new entry if there exists an equivalent {owner, name} permission
-       * at the HEAD state of the chain.
+       * Permissions of the base index are irreversible so only records need to be rolled back.
        * @param block - the block to rollback before
        */
       void rollback_to_before( const chain::signed_block_ptr& block ) {
          const auto bnum = block->block_num();
-         auto& index = permission_info_index.get<by_last_updated_height>();
          const auto& permission_by_owner = controller.db().get_index<chain::permission_index>().indices().get<chain::by_owner>();
 
          // roll back time-map
@@ -244,36 +440,26 @@ namespace eosio::chain_apis {
             time_iter = decltype(time_iter){time_to_block_num.erase( std::next(time_iter).base() )};
          }
 
-         auto curr_iter = index.rbegin();
-         while (!index.empty()) {
-            if (curr_iter == index.rend()) {
-               break;
-            }
-
-            const auto& pi = (*curr_iter);
-            if (pi.last_updated_height < bnum) {
-               break;
+         for (auto itr = records.begin(); itr != records.end();) {
+            if (itr->second->last_updated_height < bnum) {
+               ++itr;
+               continue;
             }
 
-            // remove this entry from the bimaps
-            remove_from_bimaps(pi);
-
-            auto itr = permission_by_owner.find(std::make_tuple(pi.owner, pi.name));
-            if (itr == permission_by_owner.end()) {
-               // this permission does not exist at this point in the chains history
-               curr_iter = decltype(curr_iter)( index.erase(index.iterator_to(pi)) );
-            } else {
-               const auto& po = *itr;
-
+            auto po_itr = permission_by_owner.find(std::make_tuple(itr->first.actor, itr->first.permission));
+            if (po_itr != permission_by_owner.end()) {
+               const auto& po = *po_itr;
                uint32_t last_updated_height = chain::block_timestamp_type(po.last_updated) == block->timestamp ?
                   bnum : last_updated_time_to_height(po.last_updated);
-
-               index.modify(index.iterator_to(pi), [&po, last_updated_height](auto& mutable_pi) {
-                  mutable_pi.last_updated_height = last_updated_height;
-                  mutable_pi.threshold = po.auth.threshold;
-               });
-               add_to_bimaps(pi, po);
-               ++curr_iter;
+               itr->second = make_record(po, last_updated_height);
+               ++itr;
+            } else if (base->contains(itr->first)) {
+               // this permission does not exist at this point in the chains history but does in the base index
+               itr->second = make_deleted_record(itr->first, controller.last_irreversible_block_num());
+               ++itr;
+            } else {
+               // this permission does not exist at this point in the chains history
+               itr = records.erase(itr);
             }
          }
       }
@@ -301,11 +487,10 @@ namespace eosio::chain_apis {
 
       using permission_set_t = std::set<chain::permission_level>;
       /**
-       * Pre-Commit step with const qualifier to guarantee it does not mutate
-       * the thread-safe data set
+       * Find the permissions updated and deleted by the cached traces of a block
        * @param block
        */
-      auto commit_block_prelock( const chain::signed_block_ptr& block ) const {
+      auto find_changed_permissions( const chain::signed_block_ptr& block ) const {
          permission_set_t updated;
          permission_set_t deleted;
 
@@ -365,11 +550,10 @@ namespace eosio::chain_apis {
          permission_set_t deleted;
          bool rollback_required = false;
 
-         std::tie(updated, deleted, rollback_required) = commit_block_prelock(block);
+         std::tie(updated, deleted, rollback_required) = find_changed_permissions(block);
 
-         // optimistic skip of locking section if there is nothing to do
+         // skip publishing a new snapshot if there is nothing to do
          if (!updated.empty() || !deleted.empty() || rollback_required) {
-            std::unique_lock write_lock(rw_mutex);
             auto block_num = block->block_num();
 
             rollback_to_before(block);
@@ -378,38 +562,26 @@ namespace eosio::chain_apis {
             time_to_block_num.emplace(block->timestamp, block_num);
 
             const auto bnum = block_num;
-            auto& index = permission_info_index.get<by_owner_name>();
             const auto& permission_by_owner = controller.db().get_index<chain::permission_index>().indices().get<chain::by_owner>();
 
             // for each updated permission, find the new values and update the account query db
             for (const auto& up: updated) {
-               auto key = std::make_tuple(up.actor, up.permission);
-               auto source_itr = permission_by_owner.find(key);
+               auto source_itr = permission_by_owner.find(std::make_tuple(up.actor, up.permission));
                EOS_ASSERT(source_itr != permission_by_owner.end(), chain::plugin_exception, "chain data is missing");
-               auto itr = index.find(key);
-               if (itr == index.end()) {
-                  const auto& po = *source_itr;
-                  itr = index.emplace(permission_info{ po.owner, po.name, bnum, po.auth.threshold }).first;
-               } else {
-                  remove_from_bimaps(*itr);
-                  index.modify(itr, [&](auto& mutable_pi){
-                     mutable_pi.last_updated_height = bnum;
-                     mutable_pi.threshold = source_itr->auth.threshold;
-                  });
-               }
-
-               add_to_bimaps(*itr, *source_itr);
+               records[up] = make_record(*source_itr, bnum);
             }
 
             // for all deleted permissions, process their removal from the account query DB
             for (const auto& dp: deleted) {
-               auto key = std::make_tuple(dp.actor, dp.permission);
-               auto itr = index.find(key);
-               if (itr != index.end()) {
-                  remove_from_bimaps(*itr);
-                  index.erase(itr);
+               if (base->contains(dp)) {
+                  records[dp] = make_deleted_record(dp, bnum);
+               } else {
+                  records.erase(dp);
                }
             }
+
+            fold_irreversible_records();
+            publish();
          }
 
          // drop any unprocessed cached traces
@@ -419,7 +591,9 @@ namespace eosio::chain_apis {
 
       account_query_db::get_accounts_by_authorizers_result
       get_accounts_by_authorizers( const account_query_db::get_accounts_by_authorizers_params& args) const {
-         std::shared_lock read_lock(rw_mutex);
+         const auto snap = std::atomic_load(&snapshot);
+         const auto& base = *snap->base;
+         const auto& overlay = *snap->overlay;
 
          using result_t = account_query_db::get_accounts_by_authorizers_result;
          result_t result;
@@ -429,49 +603,57 @@ namespace eosio::chain_apis {
          const auto key_set = std::set<chain::public_key_type>(args.keys.begin(), args.keys.end());
 
          /**
-          * Add a range of results
+          * Add a result
           */
-         auto push_results = [&result](const auto& begin, const auto& end) {
-            for (auto itr = begin; itr != end; ++itr) {
-               const auto& pi = itr->second.get();
-               const auto& authorizer = itr->first.value;
-               auto weight = itr->first.weight;
-
-               result.accounts.emplace_back(result_t::account_result{
-                     pi.owner,
-                     pi.name,
-                     make_optional_authorizer<chain::permission_level>(authorizer),
-                     make_optional_authorizer<chain::public_key_type>(authorizer),
-                     weight,
-                     pi.threshold
-               });
-            }
+         auto push_result = [&result](const permission_info& pi, const auto& authorizer) {
+            result.accounts.emplace_back(result_t::account_result{
+                  pi.owner,
+                  pi.name,
+                  make_optional_authorizer<chain::permission_level>(authorizer.value),
+                  make_optional_authorizer<chain::public_key_type>(authorizer.value),
+                  authorizer.weight,
+                  pi.threshold
+            });
          };
 
+         /**
+          * Add the results of all authorizers in [lower, upper], from the base index unless the permission has a record
+          */
+         auto push_results = [&](const auto& base_entries, const auto& overlay_entries, const auto& lower, const auto& upper) {
+            auto itr = std::lower_bound(base_entries.begin(), base_entries.end(), lower, [](const auto& e, const auto& w) {
+               return e.first < w;
+            });
+            for (; itr != base_entries.end() && !(upper < itr->first); ++itr) {
+               const auto& pi = base.permissions[itr->second];
+               if (!overlay.records.count(pi.level()))
+                  push_result(pi, itr->first);
+            }
+
+            const auto end = overlay_entries.upper_bound(upper);
+            for (auto oitr = overlay_entries.lower_bound(lower); oitr != end; ++oitr) {
+               push_result(oitr->second->info, oitr->first);
+            }
+         };
 
          for (const auto& a: account_set) {
+            using weighted_level = weighted<chain::permission_level>;
             if (a.permission.empty()) {
                // empty permission is a wildcard
-               // construct a range between the lower bound of the given account and the lower bound of the
-               // next possible account name
-               const auto begin = name_bimap.left.lower_bound(weighted<chain::permission_level>::lower_bound_for({a.actor, a.permission}));
-               const auto next_account_name = chain::name(a.actor.to_uint64_t() + 1);
-               const auto end = name_bimap.left.lower_bound(weighted<chain::permission_level>::lower_bound_for({next_account_name, a.permission}));
-               push_results(begin, end);
+               // construct a range between the lowest and highest permission of the given account
+               const auto upper = chain::permission_level{a.actor, chain::name(std::numeric_limits<uint64_t>::max())};
+               push_results(base.accounts, overlay.accounts, weighted_level::lower_bound_for({a.actor, a.permission}),
+                            weighted_level::upper_bound_for(upper));
             } else {
                // construct a range of all possible weights for an account/permission pair
                const auto p = chain::permission_level{a.actor, a.permission};
-               const auto begin = name_bimap.left.lower_bound(weighted<chain::permission_level>::lower_bound_for(p));
-               const auto end = name_bimap.left.upper_bound(weighted<chain::permission_level>::upper_bound_for(p));
-               push_results(begin, end);
+               push_results(base.accounts, overlay.accounts, weighted_level::lower_bound_for(p), weighted_level::upper_bound_for(p));
             }
          }
 
          for (const auto& k: key_set) {
             // construct a range of all possible weights for a key
-            const auto begin = key_bimap.left.lower_bound(weighted<chain::public_key_type>::lower_bound_for(k));
-            const auto end = key_bimap.left.upper_bound(weighted<chain::public_key_type>::upper_bound_for(k));
-            push_results(begin, end);
+            using weighted_key = weighted<chain::public_key_type>;
+            push_results(base.keys, overlay.keys, weighted_key::lower_bound_for(k), weighted_key::upper_bound_for(k));
          }
 
          return result;
@@ -484,30 +666,25 @@ namespace eosio::chain_apis {
       using onblock_trace_t = std::optional<chain::transaction_trace_ptr>;
 
       const chain::controller&   controller;               ///< the controller to read data from
+      const std::filesystem::path persist_file;            ///< where the index is persisted at shutdown, empty to disable
       cached_trace_map_t         cached_trace_map;         ///< temporary cache of uncommitted traces
       onblock_trace_t            onblock_trace;            ///< temporary cache of on_block trace
 
       using time_map_t = std::map<fc::time_point, uint32_t>;
       time_map_t                 time_to_block_num;
 
-
-
-      using name_bimap_t = bimap<multiset_of<weighted<chain::permission_level>>, multiset_of<permission_info::cref>>;
-      using key_bimap_t = bimap<multiset_of<weighted<chain::public_key_type>>, multiset_of<permission_info::cref>>;
+      base_index_ptr             base;                     ///< irreversible permissions
+      std::map<chain::permission_level, permission_record_ptr> records; ///< permissions that differ from base
 
       /*
-       * The structures below are shared between the writing thread and the reading thread(s) and must be protected
-       * by the `rw_mutex`
+       * The snapshot is shared between the writing thread and the reading thread(s) and must only be accessed with
+       * `std::atomic_load` and `std::atomic_store`
        */
-      permission_info_index_t    permission_info_index;    ///< multi-index that holds ephemeral indices
-      name_bimap_t               name_bimap;               ///< many:many bimap of names:permission_infos
-      key_bimap_t                key_bimap;                ///< many:many bimap of keys:permission_infos
-
-      mutable std::shared_mutex  rw_mutex;                 ///< mutex for read/write locking on the Multi-index and bimaps
+      std::shared_ptr<const index_snapshot> snapshot;
    };
 
-   account_query_db::account_query_db( const chain::controller& controller )
-   :_impl(std::make_unique<account_query_db_impl>(controller))
+   account_query_db::account_query_db( const chain::controller& controller, const std::filesystem::path& persist_file )
+   :_impl(std::make_unique<account_query_db_impl>(controller, persist_file))
    {
       _impl->build_account_query_map();
    }
@@ -527,6 +704,12 @@ namespace eosio::chain_apis {
       } FC_LOG_AND_DROP(("ACCOUNT DB commit_block ERROR"));
    }
 
+   void account_query_db::persist() const {
+      try {
+         _impl->persist();
+      } FC_LOG_AND_DROP(("ACCOUNT DB persist ERROR"));
+   }
+
    account_query_db::get_accounts_by_authorizers_result account_query_db::get_accounts_by_authorizers( const account_query_db::get_accounts_by_authorizers_params& args) const {
       return _impl->get_accounts_by_authorizers(args);
    }
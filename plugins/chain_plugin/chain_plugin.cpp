@@ -25,6 +25,8 @@
 #include <boost/lexical_cast.hpp>
 
 #include <fc/io/json.hpp>
+#include <fc/io/raw.hpp>
+#include <fc/crypto/hex.hpp>
 #include <fc/variant.hpp>
 #include <cstdlib>
 
@@ -161,6 +163,8 @@ public:
    bool                              accept_transactions     = false;
    bool                              api_accept_transactions = true;
    bool                              account_queries_enabled = false;
+   bool                              account_queries_persisted = true;
+   bool                              token_balance_queries_enabled = false;
 
    std::optional<controller::config> chain_config;
    std::optional<controller>         chain;
@@ -195,6 +199,7 @@ public:
 
 
    std::optional<chain_apis::account_query_db>                        _account_query_db;
+   std::optional<chain_apis::token_balance_db>                        _token_balance_db;
    std::optional<chain_apis::trx_retry_db>                            _trx_retry_db;
    chain_apis::trx_finality_status_processing_ptr                     _trx_finality_status_processing;
 
@@ -355,6 +360,10 @@ void chain_plugin::set_program_options(options_description& cli, options_descrip
           "'none' - EOS VM OC tier-up is completely disabled.\n")
 #endif
          ("enable-account-queries", bpo::value<bool>()->default_value(false), "enable queries to find accounts by various metadata.")
+         ("persist-account-queries", bpo::value<bool>()->default_value(true),
+          "Persist the account query index in the state directory at shutdown and load it at startup instead of rebuilding it from the chain state.")
+         ("enable-token-balance-queries", bpo::value<bool>()->default_value(false),
+          "enable queries for the balances of accounts in all token contracts with the eosio.token table layout, kept in memory.")
          ("transaction-retry-max-storage-size-gb", bpo::value<uint64_t>(),
           "Maximum size (in GiB) allowed to be allocated for the Transaction Retry feature. Setting above 0 enables this feature.")
          ("transaction-retry-interval-sec", bpo::value<uint32_t>()->default_value(20),
@@ -922,6 +931,8 @@ void chain_plugin_impl::plugin_initialize(const variables_map& options) {
 #endif
 
       account_queries_enabled = options.at("enable-account-queries").as<bool>();
+      account_queries_persisted = options.at("persist-account-queries").as<bool>();
+      token_balance_queries_enabled = options.at("enable-token-balance-queries").as<bool>();
 
       chain_config->integrity_hash_on_start = options.at("integrity-hash-on-start").as<bool>();
       chain_config->integrity_hash_on_stop = options.at("integrity-hash-on-stop").as<bool>();
@@ -1016,6 +1027,10 @@ void chain_plugin_impl::plugin_initialize(const variables_map& options) {
             _account_query_db->commit_block(block);
          }
 
+         if (_token_balance_db) {
+            _token_balance_db->commit_block(block);
+         }
+
          if (_trx_retry_db) {
             _trx_retry_db->on_accepted_block(block->block_num());
          }
@@ -1121,11 +1136,19 @@ void chain_plugin_impl::plugin_startup()
    if (account_queries_enabled) {
       account_queries_enabled = false;
       try {
-         _account_query_db.emplace(*chain);
+         _account_query_db.emplace(*chain, account_queries_persisted ? state_dir / "account_query_db.bin" : std::filesystem::path{});
          account_queries_enabled = true;
       } FC_LOG_AND_DROP(("Unable to enable account queries"));
    }
 
+   if (token_balance_queries_enabled) {
+      token_balance_queries_enabled = false;
+      try {
+         _token_balance_db.emplace(*chain);
+         token_balance_queries_enabled = true;
+      } FC_LOG_AND_DROP(("Unable to enable token balance queries"));
+   }
+
 
 } FC_CAPTURE_AND_RETHROW() }
 
@@ -1139,6 +1162,9 @@ void chain_plugin_impl::plugin_shutdown() {
    irreversible_block_connection.reset();
    applied_transaction_connection.reset();
    block_start_connection.reset();
+   if (_account_query_db && !readonly) {
+      _account_query_db->persist();
+   }
    chain.reset();
 }
 
@@ -1173,7 +1199,8 @@ chain_apis::read_write chain_plugin::get_read_write_api(const fc::microseconds&
 }
 
 chain_apis::read_only chain_plugin::get_read_only_api(const fc::microseconds& http_max_response_time) const {
-   return chain_apis::read_only(chain(), my->_account_query_db, get_abi_serializer_max_time(), http_max_response_time, my->_trx_finality_status_processing.get());
+   return chain_apis::read_only(chain(), my->_account_query_db, get_abi_serializer_max_time(), http_max_response_time, my->_trx_finality_status_processing.get(),
+                                my->_token_balance_db ? &*my->_token_balance_db : nullptr);
 }
 
 
@@ -1250,6 +1277,10 @@ bool chain_plugin::account_queries_enabled() const {
    return my->account_queries_enabled;
 }
 
+bool chain_plugin::token_balance_queries_enabled() const {
+   return my->token_balance_queries_enabled;
+}
+
 bool chain_plugin::transaction_finality_status_enabled() const {
    return my->_trx_finality_status_processing.get();
 }
@@ -1420,6 +1451,74 @@ uint64_t read_only::get_table_index_name(const read_only::get_table_rows_params&
    return index;
 }
 
+string read_only::encode_table_rows_cursor(const table_rows_cursor& c) {
+   return fc::to_hex(fc::raw::pack(c));
+}
+
+read_only::table_rows_cursor read_only::decode_table_rows_cursor(const string& cursor, uint64_t table_id, bool reverse) {
+   table_rows_cursor c;
+   bool valid = cursor.size() % 2 == 0;
+   try {
+      vector<char> bytes(cursor.size() / 2);
+      fc::from_hex(cursor, bytes.data(), bytes.size());
+      if( valid )
+         fc::raw::unpack(bytes, c);
+   } catch(...) {
+      valid = false;
+   }
+   EOS_ASSERT( valid, chain::contract_table_query_exception, "Invalid cursor: ${c}", ("c", cursor));
+   EOS_ASSERT( c.version == 1, chain::contract_table_query_exception, "Unsupported cursor version ${v}", ("v", c.version));
+   // table ids are not reused while the table has rows, a cursor of another table or index cannot resume this one
+   EOS_ASSERT( c.table_id == table_id, chain::contract_table_query_exception, "Cursor was not returned for this table and index" );
+   EOS_ASSERT( c.reverse == reverse, chain::contract_table_query_exception, "Cursor was returned for the opposite direction" );
+   return c;
+}
+
+read_only::get_table_rows_result read_only::serialize_table_rows(table_rows_http_params& p, abi_def&& abi,
+                                                                 const fc::microseconds& abi_serializer_max_time) {
+   const auto start = fc::time_point::now();
+   read_only::get_table_rows_result result;
+   // binary rows are returned as stored, only json rows need the abi
+   abi_serializer abis;
+   type_name table_type;
+   if( p.json ) {
+      abis.set_abi(std::move(abi), abi_serializer::create_yield_function(abi_serializer_max_time));
+      table_type = abis.get_table_type(p.table);
+   }
+
+   result.rows.reserve(p.rows.size());
+   for (auto& row : p.rows) {
+      fc::variant data_var;
+      if( p.json ) {
+         data_var = abis.binary_to_variant(table_type, row.first,
+                                           abi_serializer::create_yield_function(abi_serializer_max_time),
+                                           p.shorten_abi_errors );
+      } else {
+         data_var = fc::variant(row.first);
+      }
+
+      if (p.show_payer) {
+         result.rows.emplace_back(fc::mutable_variant_object("data", std::move(data_var))("payer", row.second));
+      } else {
+         result.rows.emplace_back(std::move(data_var));
+      }
+   }
+   result.more = p.more;
+   result.next_key = std::move(p.next_key);
+   result.next_cursor = std::move(p.next_cursor);
+
+   if( p.show_stats ) {
+      get_table_rows_stats stats;
+      stats.rows = result.rows.size();
+      stats.walk_us = p.walk_us;
+      stats.serialize_us = (fc::time_point::now() - start).count();
+      const int64_t total_us = stats.walk_us + stats.serialize_us;
+      stats.rows_per_sec = total_us > 0 ? stats.rows * 1'000'000.0 / total_us : 0;
+      result.stats = stats;
+   }
+   return result;
+}
+
 uint64_t convert_to_type(const eosio::name &n, const string &desc) {
    return n.to_uint64_t();
 }
@@ -2564,6 +2663,13 @@ read_only::get_accounts_by_authorizers( const account_query_db::get_accounts_by_
    return aqdb->get_accounts_by_authorizers(args);
 }
 
+token_balance_db::get_token_balances_result
+read_only::get_token_balances( const token_balance_db::get_token_balances_params& args, const fc::time_point& ) const
+{
+   EOS_ASSERT(tbdb, plugin_config_exception, "Token balance queries being accessed when not enabled");
+   return tbdb->get_token_balances(args);
+}
+
 namespace detail {
    struct ram_market_exchange_state_t {
       asset  ignore1;
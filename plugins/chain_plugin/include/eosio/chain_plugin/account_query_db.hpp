@@ -2,11 +2,14 @@
 #include <eosio/chain/types.hpp>
 #include <eosio/chain/trace.hpp>
 
+#include <filesystem>
+
 namespace eosio::chain_apis {
    /**
-    * This class manages the ephemeral indices and data that provide the `get_accounts_by_authorizers` RPC call
-    * There is no persistence and the indices/caches are recreated when the class is instantiated based on the
-    * current state of the chain.
+    * This class manages the indices and data that provide the `get_accounts_by_authorizers` RPC call
+    * The indices are recreated when the class is instantiated based on the current state of the chain, unless they
+    * were persisted at the same HEAD block. Lookups are served from an immutable snapshot that is replaced for every
+    * block that changes a permission, so they never wait on the thread committing blocks.
     */
    class account_query_db {
    public:
@@ -16,8 +19,9 @@ namespace eosio::chain_apis {
        * The caller is expected to manage lifetimes such that this controller reference does not go stale
        * for the life of the account query DB
        * @param chain - controller to read data from
+       * @param persist_file - file the indices are loaded from and persisted to, empty to disable persistence
        */
-      account_query_db( const class eosio::chain::controller& chain );
+      account_query_db( const class eosio::chain::controller& chain, const std::filesystem::path& persist_file = {} );
       ~account_query_db();
 
       /**
@@ -41,6 +45,12 @@ namespace eosio::chain_apis {
        */
       void commit_block( const chain::signed_block_ptr& block );
 
+      /**
+       * Persist the indices for the current HEAD block of the controller, to be loaded instead of rebuilt by the next
+       * instance. Call after the last block has been committed and before the controller is shut down.
+       */
+      void persist() const;
+
       /**
        * parameters for the get_accounts_by_authorizers RPC
        */
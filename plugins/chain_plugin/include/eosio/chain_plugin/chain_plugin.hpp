@@ -17,6 +17,7 @@
 #include <boost/multiprecision/cpp_int.hpp>
 
 #include <eosio/chain_plugin/account_query_db.hpp>
+#include <eosio/chain_plugin/token_balance_db.hpp>
 #include <eosio/chain_plugin/trx_retry_db.hpp>
 #include <eosio/chain_plugin/trx_finality_status_processing.hpp>
 
@@ -143,6 +144,7 @@ class read_only : public api_base {
    const fc::microseconds http_max_response_time;
    bool  shorten_abi_errors = true;
    const trx_finality_status_processing* trx_finality_status_proc;
+   const token_balance_db* tbdb;
    friend class api_base;
    
 public:
@@ -150,12 +152,14 @@ public:
 
    read_only(const controller& db, const std::optional<account_query_db>& aqdb,
              const fc::microseconds& abi_serializer_max_time, const fc::microseconds& http_max_response_time,
-             const trx_finality_status_processing* trx_finality_status_proc)
+             const trx_finality_status_processing* trx_finality_status_proc,
+             const token_balance_db* tbdb = nullptr)
       : db(db)
       , aqdb(aqdb)
       , abi_serializer_max_time(abi_serializer_max_time)
       , http_max_response_time(http_max_response_time)
-      , trx_finality_status_proc(trx_finality_status_proc) {
+      , trx_finality_status_proc(trx_finality_status_proc)
+      , tbdb(tbdb) {
    }
 
    void validate() const {}
@@ -429,12 +433,23 @@ public:
       std::optional<bool>  reverse;
       std::optional<bool>  show_payer; // show RAM payer
       std::optional<uint32_t> time_limit_ms; // defaults to http-max-response-time-ms
+      string               cursor; // next_cursor of the previous page, resumes at its exact index position; replaces lower_bound (upper_bound if reverse)
+      std::optional<bool>  show_stats; // report rows/sec of the request
     };
 
+   struct get_table_rows_stats {
+      uint32_t rows = 0;
+      int64_t  walk_us = 0;      ///< time spent walking the index on the main thread
+      int64_t  serialize_us = 0; ///< time spent converting the rows in the http thread pool
+      double   rows_per_sec = 0;
+   };
+
    struct get_table_rows_result {
       vector<fc::variant> rows; ///< one row per item, either encoded as hex String or JSON object
       bool                more = false; ///< true if last element in data is not the end and sizeof data() < limit
       string              next_key; ///< fill lower_bound with this value to fetch more rows
+      std::optional<string> next_cursor; ///< set with more, fill cursor with this value to fetch more rows without re-locating them
+      std::optional<get_table_rows_stats> stats; ///< set with show_stats
    };
 
    using get_table_rows_return_t = std::function<chain::t_or_exception<get_table_rows_result>()>;
@@ -571,6 +586,53 @@ public:
 
    static uint64_t get_table_index_name(const read_only::get_table_rows_params& p, bool& primary);
 
+   /// index position of the first row of the next get_table_rows page, handed out hex encoded as next_cursor
+   struct table_rows_cursor {
+      uint8_t      version = 1;
+      bool         reverse = false;
+      uint64_t     table_id = 0;    ///< id of the table_id_object of the walked index
+      vector<char> secondary_key;   ///< in-memory representation of the secondary key, empty for the primary index
+      uint64_t     primary_key = 0;
+   };
+
+   static string encode_table_rows_cursor(const table_rows_cursor& c);
+   /// throws contract_table_query_exception unless cursor was returned for the same index and direction
+   static table_rows_cursor decode_table_rows_cursor(const string& cursor, uint64_t table_id, bool reverse);
+
+   template <typename SecKeyType>
+   static vector<char> secondary_key_to_cursor(const SecKeyType& k) {
+      static_assert( std::is_trivially_copyable_v<SecKeyType> );
+      vector<char> bytes(sizeof(k));
+      memcpy(bytes.data(), &k, sizeof(k));
+      return bytes;
+   }
+
+   template <typename SecKeyType>
+   static SecKeyType secondary_key_from_cursor(const table_rows_cursor& c) {
+      EOS_ASSERT( c.secondary_key.size() == sizeof(SecKeyType), chain::contract_table_query_exception,
+                  "Invalid cursor for key type of this index" );
+      SecKeyType k;
+      memcpy(&k, c.secondary_key.data(), sizeof(k));
+      return k;
+   }
+
+   // rows copied out of the index on the main thread, converted by serialize_table_rows in the http thread pool
+   struct table_rows_http_params {
+      name table;
+      bool shorten_abi_errors;
+      bool json;
+      bool show_payer;
+      bool show_stats;
+      bool more = false;
+      std::string next_key;
+      std::optional<std::string> next_cursor;
+      int64_t walk_us = 0;
+      vector<std::pair<vector<char>, name>> rows;
+   };
+
+   static get_table_rows_result serialize_table_rows(table_rows_http_params& p, abi_def&& abi,
+                                                     const fc::microseconds& abi_serializer_max_time);
+
    template <typename IndexType, typename SecKeyType, typename ConvFn>
    get_table_rows_return_t
    get_table_rows_by_seckey( const read_only::get_table_rows_params& p,
@@ -580,17 +642,9 @@ public:
 
       fc::time_point params_deadline = p.time_limit_ms ? std::min(fc::time_point::now().safe_add(fc::milliseconds(*p.time_limit_ms)), deadline) : deadline;
 
-      struct http_params_t {
-         name table;
-         bool shorten_abi_errors;
-         bool json;
-         bool show_payer;
-         bool more;
-         std::string next_key;
-         vector<std::pair<vector<char>, name>> rows;
-      };
-      
-      http_params_t http_params { p.table, shorten_abi_errors, p.json, p.show_payer && *p.show_payer, false  };
+      const bool reverse = p.reverse && *p.reverse;
+      table_rows_http_params http_params { p.table, shorten_abi_errors, p.json, p.show_payer && *p.show_payer,
+                                           p.show_stats && *p.show_stats };
          
       const auto& d = db.db();
 
@@ -640,6 +694,15 @@ public:
             }
          }
 
+         if( !p.cursor.empty() ) {
+            auto c = decode_table_rows_cursor( p.cursor, index_t_id->id._id, reverse );
+            auto resume_tuple = std::make_tuple( index_t_id->id._id, secondary_key_from_cursor<secondary_key_type>(c), c.primary_key );
+            if( reverse )
+               upper_bound_lookup_tuple = std::min( upper_bound_lookup_tuple, resume_tuple );
+            else
+               lower_bound_lookup_tuple = std::max( lower_bound_lookup_tuple, resume_tuple );
+         }
+
          if( upper_bound_lookup_tuple < lower_bound_lookup_tuple )
             return []() ->  chain::t_or_exception<read_only::get_table_rows_result> {
                return read_only::get_table_rows_result();
@@ -661,46 +724,29 @@ public:
             if( itr != end_itr ) {
                http_params.more = true;
                http_params.next_key = convert_to_string(itr->secondary_key, p.key_type, p.encode_type, "next_key - next lower bound");
+               http_params.next_cursor = encode_table_rows_cursor( { .reverse = reverse,
+                                                                     .table_id = index_t_id->id._id,
+                                                                     .secondary_key = secondary_key_to_cursor(itr->secondary_key),
+                                                                     .primary_key = itr->primary_key } );
             }
          };
 
+         const auto walk_start = fc::time_point::now();
          auto lower = secidx.lower_bound( lower_bound_lookup_tuple );
          auto upper = secidx.upper_bound( upper_bound_lookup_tuple );
-         if( p.reverse && *p.reverse ) {
+         if( reverse ) {
             walk_table_row_range( boost::make_reverse_iterator(upper), boost::make_reverse_iterator(lower) );
          } else {
             walk_table_row_range( lower, upper );
          }
+         http_params.walk_us = (fc::time_point::now() - walk_start).count();
       }
 
       // not enforcing the deadline for that second processing part (the serialization), as it is not taking place
       // on the main thread, but in the http thread pool.
       return [p = std::move(http_params), abi=std::move(abi), abi_serializer_max_time=abi_serializer_max_time]() mutable ->
          chain::t_or_exception<read_only::get_table_rows_result> {
-         read_only::get_table_rows_result result;
-         abi_serializer abis;
-         abis.set_abi(std::move(abi), abi_serializer::create_yield_function(abi_serializer_max_time));
-         auto table_type = abis.get_table_type(p.table);
-         
-         for (auto& row : p.rows) {
-            fc::variant data_var;
-            if( p.json ) {
-               data_var = abis.binary_to_variant(table_type, row.first,
-                                                 abi_serializer::create_yield_function(abi_serializer_max_time),
-                                                 p.shorten_abi_errors );
-            } else {
-               data_var = fc::variant(row.first);
-            }
-
-            if (p.show_payer) {
-               result.rows.emplace_back(fc::mutable_variant_object("data", std::move(data_var))("payer", row.second));
-            } else {
-               result.rows.emplace_back(std::move(data_var));
-            }            
-         }
-         result.more = p.more;
-         result.next_key = p.next_key;
-         return result;
+         return serialize_table_rows(p, std::move(abi), abi_serializer_max_time);
       };
    }
 
@@ -712,17 +758,9 @@ public:
 
       fc::time_point params_deadline = p.time_limit_ms ? std::min(fc::time_point::now().safe_add(fc::milliseconds(*p.time_limit_ms)), deadline) : deadline;
 
-      struct http_params_t {
-         name table;
-         bool shorten_abi_errors;
-         bool json;
-         bool show_payer;
-         bool more;
-         std::string next_key;
-         vector<std::pair<vector<char>, name>> rows;
-      };
-      
-      http_params_t http_params { p.table, shorten_abi_errors, p.json, p.show_payer && *p.show_payer, false  };
+      const bool reverse = p.reverse && *p.reverse;
+      table_rows_http_params http_params { p.table, shorten_abi_errors, p.json, p.show_payer && *p.show_payer,
+                                           p.show_stats && *p.show_stats };
          
       const auto& d = db.db();
 
@@ -754,6 +792,16 @@ public:
             }
          }
 
+         if( !p.cursor.empty() ) {
+            auto c = decode_table_rows_cursor( p.cursor, t_id->id._id, reverse );
+            EOS_ASSERT( c.secondary_key.empty(), chain::contract_table_query_exception, "Invalid cursor for the primary index" );
+            auto resume_tuple = std::make_tuple( t_id->id, c.primary_key );
+            if( reverse )
+               upper_bound_lookup_tuple = std::min( upper_bound_lookup_tuple, resume_tuple );
+            else
+               lower_bound_lookup_tuple = std::max( lower_bound_lookup_tuple, resume_tuple );
+         }
+
          if( upper_bound_lookup_tuple < lower_bound_lookup_tuple  )
             return []() ->  chain::t_or_exception<read_only::get_table_rows_result> {
                return read_only::get_table_rows_result();
@@ -773,46 +821,28 @@ public:
             if( itr != end_itr ) {
                http_params.more = true;
                http_params.next_key = convert_to_string(itr->primary_key, p.key_type, p.encode_type, "next_key - next lower bound");
+               http_params.next_cursor = encode_table_rows_cursor( { .reverse = reverse,
+                                                                     .table_id = t_id->id._id,
+                                                                     .primary_key = itr->primary_key } );
             }
          };
 
+         const auto walk_start = fc::time_point::now();
          auto lower = idx.lower_bound( lower_bound_lookup_tuple );
          auto upper = idx.upper_bound( upper_bound_lookup_tuple );
-         if( p.reverse && *p.reverse ) {
+         if( reverse ) {
             walk_table_row_range( boost::make_reverse_iterator(upper), boost::make_reverse_iterator(lower) );
          } else {
             walk_table_row_range( lower, upper );
          }
+         http_params.walk_us = (fc::time_point::now() - walk_start).count();
       }
       
       // not enforcing the deadline for that second processing part (the serialization), as it is not taking place
       // on the main thread, but in the http thread pool.
       return [p = std::move(http_params), abi=std::move(abi), abi_serializer_max_time=abi_serializer_max_time]() mutable ->
          chain::t_or_exception<read_only::get_table_rows_result> {
-         read_only::get_table_rows_result result;
-         abi_serializer abis;
-         abis.set_abi(std::move(abi), abi_serializer::create_yield_function(abi_serializer_max_time));
-         auto table_type = abis.get_table_type(p.table);
-         
-         for (auto& row : p.rows) {
-            fc::variant data_var;
-            if( p.json ) {
-               data_var = abis.binary_to_variant(table_type, row.first,
-                                                 abi_serializer::create_yield_function(abi_serializer_max_time),
-                                                 p.shorten_abi_errors );
-            } else {
-               data_var = fc::variant(row.first);
-            }
-
-            if (p.show_payer) {
-               result.rows.emplace_back(fc::mutable_variant_object("data", std::move(data_var))("payer", row.second));
-            } else {
-               result.rows.emplace_back(std::move(data_var));
-            }            
-         }
-         result.more = p.more;
-         result.next_key = p.next_key;
-         return result;
+         return serialize_table_rows(p, std::move(abi), abi_serializer_max_time);
       };
    }
 
@@ -820,6 +850,10 @@ public:
    using get_accounts_by_authorizers_params = account_query_db::get_accounts_by_authorizers_params;
    get_accounts_by_authorizers_result get_accounts_by_authorizers( const get_accounts_by_authorizers_params& args, const fc::time_point& deadline) const;
 
+   using get_token_balances_result = token_balance_db::get_token_balances_result;
+   using get_token_balances_params = token_balance_db::get_token_balances_params;
+   get_token_balances_result get_token_balances( const get_token_balances_params& args, const fc::time_point& deadline) const;
+
    chain::symbol extract_core_symbol()const;
 
    using get_consensus_parameters_params = empty;
@@ -996,6 +1030,7 @@ public:
    static void handle_guard_exception(const chain::guard_exception& e);
 
    bool account_queries_enabled() const;
+   bool token_balance_queries_enabled() const;
    bool transaction_finality_status_enabled() const;
 
    // return variant of trace for logging, trace is modified to minimize log output
@@ -1034,8 +1069,10 @@ FC_REFLECT(eosio::chain_apis::read_only::get_block_header_result, (id)(signed_bl
 FC_REFLECT( eosio::chain_apis::read_write::push_transaction_results, (transaction_id)(processed) )
 FC_REFLECT( eosio::chain_apis::read_write::send_transaction2_params, (return_failure_trace)(retry_trx)(retry_trx_num_blocks)(transaction) )
 
-FC_REFLECT( eosio::chain_apis::read_only::get_table_rows_params, (json)(code)(scope)(table)(table_key)(lower_bound)(upper_bound)(limit)(key_type)(index_position)(encode_type)(reverse)(show_payer)(time_limit_ms) )
-FC_REFLECT( eosio::chain_apis::read_only::get_table_rows_result, (rows)(more)(next_key) );
+FC_REFLECT( eosio::chain_apis::read_only::get_table_rows_params, (json)(code)(scope)(table)(table_key)(lower_bound)(upper_bound)(limit)(key_type)(index_position)(encode_type)(reverse)(show_payer)(time_limit_ms)(cursor)(show_stats) )
+FC_REFLECT( eosio::chain_apis::read_only::get_table_rows_stats, (rows)(walk_us)(serialize_us)(rows_per_sec) );
+FC_REFLECT( eosio::chain_apis::read_only::get_table_rows_result, (rows)(more)(next_key)(next_cursor)(stats) );
+FC_REFLECT( eosio::chain_apis::read_only::table_rows_cursor, (version)(reverse)(table_id)(secondary_key)(primary_key) );
 
 FC_REFLECT( eosio::chain_apis::read_only::get_table_by_scope_params, (code)(table)(lower_bound)(upper_bound)(limit)(reverse)(time_limit_ms) )
 FC_REFLECT( eosio::chain_apis::read_only::get_table_by_scope_result_row, (code)(scope)(table)(payer)(count));
@@ -0,0 +1,76 @@
+#pragma once
+#include <eosio/chain/asset.hpp>
+#include <eosio/chain/block.hpp>
+#include <eosio/chain/types.hpp>
+
+namespace eosio::chain_apis {
+   /**
+    * This class manages the ephemeral index that provides the `get_token_balances` RPC call: the balances of every
+    * holder in every contract with the `accounts`/`stat` table layout of eosio.token.
+    * There is no persistence and the index is recreated when the class is instantiated based on the current state of
+    * the chain, it is then maintained from the contract rows changed by each block.
+    */
+   class token_balance_db {
+   public:
+
+      /**
+       * Instantiate a new token balance DB from the given chain controller
+       * The caller is expected to manage lifetimes such that this controller reference does not go stale
+       * for the life of the token balance DB
+       * @param chain - controller to read data from
+       */
+      token_balance_db( const class eosio::chain::controller& chain );
+      ~token_balance_db();
+
+      /**
+       * Allow moving the token balance DB (including by assignment)
+       */
+      token_balance_db(token_balance_db&&);
+      token_balance_db& operator=(token_balance_db&&);
+
+      /**
+       * Add a block to the token balance DB. Must be called from the `accepted_block` signal, while the changes
+       * of the block are the last undo session of the chain state. Balances changed by blocks that have been
+       * forked out are read again from the chain state.
+       * @param block
+       */
+      void commit_block( const chain::signed_block_ptr& block );
+
+      /**
+       * parameters for the get_token_balances RPC
+       */
+      struct get_token_balances_params {
+         std::vector<chain::name> accounts;
+         std::vector<chain::name> contracts; ///< only report balances of these token contracts, all if empty
+      };
+
+      /**
+       * Result of the get_token_balances RPC
+       */
+      struct get_token_balances_result {
+         struct balance_result {
+            chain::name    account;
+            chain::name    contract;
+            chain::asset   balance;
+         };
+
+         std::vector<balance_result> balances; ///< ordered by account, contract and symbol
+      };
+
+      /**
+       * Given a set of accounts, find their balances in all token contracts
+       *
+       * @param args
+       * @return
+       */
+      get_token_balances_result get_token_balances( const get_token_balances_params& args ) const;
+
+   private:
+      std::unique_ptr<struct token_balance_db_impl> _impl;
+   };
+
+}
+
+FC_REFLECT( eosio::chain_apis::token_balance_db::get_token_balances_params, (accounts)(contracts) )
+FC_REFLECT( eosio::chain_apis::token_balance_db::get_token_balances_result::balance_result, (account)(contract)(balance) )
+FC_REFLECT( eosio::chain_apis::token_balance_db::get_token_balances_result, (balances) )
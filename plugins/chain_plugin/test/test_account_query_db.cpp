@@ -4,6 +4,7 @@
 #include <eosio/chain/types.hpp>
 #include <eosio/chain_plugin/account_query_db.hpp>
 #include <eosio/chain/thread_utils.hpp>
+#include <fc/filesystem.hpp>
 
 using namespace eosio;
 using namespace eosio::chain;
@@ -143,6 +144,61 @@ BOOST_FIXTURE_TEST_CASE(updateauth_test_multi_threaded, validating_tester) { try
 
 } FC_LOG_AND_RETHROW() }
 
+BOOST_FIXTURE_TEST_CASE(persist_test, validating_tester) { try {
+   fc::temp_directory tmp;
+   const auto persist_file = tmp.path() / "account_query_db.bin";
+
+   const auto tester_account = "tester"_n;
+   const string role = "first";
+   params pars;
+   pars.keys.emplace_back(get_public_key(tester_account, role));
+   pars.accounts.push_back({tester_account, {}});
+
+   {
+      auto aq_db = account_query_db(*control, persist_file);
+      auto c = control->accepted_block.connect([&](const block_signal_params& t) {
+         const auto& [ block, id ] = t;
+         aq_db.commit_block( block );
+      });
+
+      produce_blocks(10);
+      aq_db.cache_transaction_trace(create_account(tester_account));
+      aq_db.cache_transaction_trace(push_action(config::system_account_name, updateauth::get_name(), tester_account, fc::mutable_variant_object()
+            ("account", tester_account)
+            ("permission", "role"_n)
+            ("parent", "active")
+            ("auth",  authority(get_public_key(tester_account, role), 5))
+      ));
+      produce_block();
+
+      BOOST_TEST_REQUIRE(find_account_auth(aq_db.get_accounts_by_authorizers(pars), tester_account, "role"_n) == true);
+      aq_db.persist();
+   }
+   BOOST_TEST_REQUIRE(std::filesystem::exists(persist_file));
+
+   // loaded at the same head block, and consumed by loading
+   {
+      auto aq_db = account_query_db(*control, persist_file);
+      BOOST_TEST_REQUIRE(!std::filesystem::exists(persist_file));
+      const auto results = aq_db.get_accounts_by_authorizers(pars);
+      BOOST_TEST_REQUIRE(find_account_auth(results, tester_account, "role"_n) == true);
+      BOOST_TEST_REQUIRE(find_account_auth(results, tester_account, "active"_n) == true);
+      aq_db.persist();
+   }
+
+   // ignored once the chain has moved on, the index is rebuilt from the chain state instead
+   push_action(config::system_account_name, deleteauth::get_name(), tester_account, fc::mutable_variant_object()
+         ("account", tester_account)
+         ("permission", "role"_n)
+   );
+   produce_block();
+   {
+      auto aq_db = account_query_db(*control, persist_file);
+      BOOST_TEST_REQUIRE(find_account_auth(aq_db.get_accounts_by_authorizers(pars), tester_account, "role"_n) == false);
+   }
+
+} FC_LOG_AND_RETHROW() }
+
 BOOST_AUTO_TEST_CASE(future_fork_test) { try {
    tester node_a(setup_policy::none);
    tester node_b(setup_policy::none);
@@ -0,0 +1,153 @@
+#include <boost/test/unit_test.hpp>
+#include <eosio/testing/tester.hpp>
+#include <eosio/chain/types.hpp>
+#include <eosio/chain_plugin/token_balance_db.hpp>
+
+#include <test_contracts.hpp>
+
+using namespace eosio;
+using namespace eosio::chain;
+using namespace eosio::testing;
+using namespace eosio::chain_apis;
+
+using mvo     = fc::mutable_variant_object;
+using params  = token_balance_db::get_token_balances_params;
+using results = token_balance_db::get_token_balances_result;
+
+namespace {
+
+void create_token(tester& t, name contract, const string& max_supply) {
+   t.create_account(contract);
+   t.set_code(contract, test_contracts::eosio_token_wasm());
+   t.set_abi(contract, test_contracts::eosio_token_abi());
+   t.push_action(contract, "create"_n, contract, mvo()("issuer", contract)("maximum_supply", max_supply));
+   t.push_action(contract, "issue"_n, contract, mvo()("to", contract)("quantity", max_supply)("memo", ""));
+}
+
+void transfer(tester& t, name contract, name from, name to, const string& quantity) {
+   t.push_action(contract, "transfer"_n, from, mvo()("from", from)("to", to)("quantity", quantity)("memo", ""));
+}
+
+std::optional<asset> find_balance(const results& rst, name account, name contract, symbol_code sym) {
+   for (const auto& b : rst.balances) {
+      if (b.account == account && b.contract == contract && b.balance.get_symbol().to_symbol_code() == sym)
+         return b.balance;
+   }
+   return {};
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(token_balance_db_tests)
+
+BOOST_FIXTURE_TEST_CASE(balances_test, validating_tester) { try {
+   create_accounts({"alice"_n, "bob"_n});
+   create_token(*this, "eosio.token"_n, "1000.0000 TOK");
+   transfer(*this, "eosio.token"_n, "eosio.token"_n, "alice"_n, "10.0000 TOK");
+   produce_block();
+
+   // balances present at startup are indexed from the chain state
+   auto tb_db = token_balance_db(*control);
+   auto c = control->accepted_block.connect([&](const block_signal_params& t) {
+      const auto& [ block, id ] = t;
+      tb_db.commit_block( block );
+   });
+
+   params pars;
+   pars.accounts = {"alice"_n, "bob"_n};
+   auto rst = tb_db.get_token_balances(pars);
+   BOOST_REQUIRE_EQUAL(rst.balances.size(), 1u);
+   BOOST_REQUIRE_EQUAL(*find_balance(rst, "alice"_n, "eosio.token"_n, symbol(4, "TOK").to_symbol_code()), asset::from_string("10.0000 TOK"));
+
+   // and then maintained from the rows changed by each block, across token contracts
+   create_token(*this, "other.token"_n, "500.00 OTH");
+   transfer(*this, "eosio.token"_n, "alice"_n, "bob"_n, "2.5000 TOK");
+   transfer(*this, "other.token"_n, "other.token"_n, "alice"_n, "1.00 OTH");
+   produce_block();
+
+   rst = tb_db.get_token_balances(pars);
+   BOOST_REQUIRE_EQUAL(rst.balances.size(), 3u);
+   BOOST_REQUIRE_EQUAL(*find_balance(rst, "alice"_n, "eosio.token"_n, symbol(4, "TOK").to_symbol_code()), asset::from_string("7.5000 TOK"));
+   BOOST_REQUIRE_EQUAL(*find_balance(rst, "alice"_n, "other.token"_n, symbol(2, "OTH").to_symbol_code()), asset::from_string("1.00 OTH"));
+   BOOST_REQUIRE_EQUAL(*find_balance(rst, "bob"_n, "eosio.token"_n, symbol(4, "TOK").to_symbol_code()), asset::from_string("2.5000 TOK"));
+
+   pars.contracts = {"other.token"_n};
+   rst = tb_db.get_token_balances(pars);
+   BOOST_REQUIRE_EQUAL(rst.balances.size(), 1u);
+   pars.contracts.clear();
+
+   // closed balances are removed
+   transfer(*this, "eosio.token"_n, "bob"_n, "alice"_n, "2.5000 TOK");
+   push_action("eosio.token"_n, "close"_n, "bob"_n, mvo()("owner", "bob")("symbol", "4,TOK"));
+   produce_block();
+
+   rst = tb_db.get_token_balances(pars);
+   BOOST_REQUIRE_EQUAL(rst.balances.size(), 2u);
+   BOOST_REQUIRE(!find_balance(rst, "bob"_n, "eosio.token"_n, symbol(4, "TOK").to_symbol_code()));
+   BOOST_REQUIRE_EQUAL(*find_balance(rst, "alice"_n, "eosio.token"_n, symbol(4, "TOK").to_symbol_code()), asset::from_string("10.0000 TOK"));
+
+} FC_LOG_AND_RETHROW() }
+
+BOOST_AUTO_TEST_CASE(fork_test) { try {
+   tester node_a(setup_policy::none);
+   tester node_b(setup_policy::none);
+
+   node_a.create_accounts({"alice"_n});
+   create_token(node_a, "eosio.token"_n, "1000.0000 TOK");
+   for (int i = 0; i < 10; i++) {
+      node_b.push_block(node_a.produce_block());
+   }
+
+   auto tb_db = token_balance_db(*node_a.control);
+   auto c = node_a.control->accepted_block.connect([&](const block_signal_params& t) {
+      const auto& [ block, id ] = t;
+      tb_db.commit_block( block );
+   });
+
+   // a transfer on node A that is forked out by node B
+   transfer(node_a, "eosio.token"_n, "eosio.token"_n, "alice"_n, "10.0000 TOK");
+   node_a.produce_block();
+
+   params pars;
+   pars.accounts = {"alice"_n};
+   BOOST_REQUIRE_EQUAL(tb_db.get_token_balances(pars).balances.size(), 1u);
+
+   node_a.push_block(node_b.produce_block(fc::milliseconds(config::block_interval_ms * 100)));
+   node_a.push_block(node_b.produce_block());
+
+   BOOST_REQUIRE_EQUAL(tb_db.get_token_balances(pars).balances.size(), 0u);
+
+} FC_LOG_AND_RETHROW() }
+
+BOOST_AUTO_TEST_CASE(fork_after_restart_test) { try {
+   tester node_a(setup_policy::none);
+   tester node_b(setup_policy::none);
+
+   node_a.create_accounts({"alice"_n});
+   create_token(node_a, "eosio.token"_n, "1000.0000 TOK");
+   for (int i = 0; i < 10; i++) {
+      node_b.push_block(node_a.produce_block());
+   }
+
+   // a transfer on node A that is forked out by node B, in a block applied before the DB is built as on a restart
+   transfer(node_a, "eosio.token"_n, "eosio.token"_n, "alice"_n, "10.0000 TOK");
+   node_a.produce_block();
+
+   auto tb_db = token_balance_db(*node_a.control);
+   auto c = node_a.control->accepted_block.connect([&](const block_signal_params& t) {
+      const auto& [ block, id ] = t;
+      tb_db.commit_block( block );
+   });
+
+   params pars;
+   pars.accounts = {"alice"_n};
+   BOOST_REQUIRE_EQUAL(tb_db.get_token_balances(pars).balances.size(), 1u);
+
+   node_a.push_block(node_b.produce_block(fc::milliseconds(config::block_interval_ms * 100)));
+   node_a.push_block(node_b.produce_block());
+
+   BOOST_REQUIRE_EQUAL(tb_db.get_token_balances(pars).balances.size(), 0u);
+
+} FC_LOG_AND_RETHROW() }
+
+BOOST_AUTO_TEST_SUITE_END()
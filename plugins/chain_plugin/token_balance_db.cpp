@@ -0,0 +1,238 @@
+#include <eosio/chain_plugin/token_balance_db.hpp>
+
+#include <eosio/chain/contract_table_objects.hpp>
+#include <eosio/chain/controller.hpp>
+
+#include <map>
+#include <set>
+#include <shared_mutex>
+
+using namespace eosio;
+using namespace eosio::chain::literals;
+
+namespace {
+   constexpr auto accounts_table = "accounts"_n;
+   constexpr auto stat_table     = "stat"_n;
+
+   /**
+    * {holder, contract, symbol code}, the `accounts` table of a token contract is scoped by holder and keyed by the
+    * symbol code of the balance
+    */
+   using balance_key = std::tuple<chain::name, chain::name, uint64_t>;
+}
+
+namespace eosio::chain_apis {
+   /**
+    * Implementation details of the token balance DB
+    */
+   struct token_balance_db_impl {
+      token_balance_db_impl(const chain::controller& controller)
+      :controller(controller)
+      {}
+
+      /**
+       * Build the initial index from the `accounts` tables of the chain state at the current HEAD
+       */
+      void build_token_balance_map() {
+         ilog("Building token balance DB");
+         auto start = fc::time_point::now();
+         const auto& db = controller.db();
+         const auto& table_index = db.get_index<chain::table_id_multi_index>().indices();
+         const auto& row_index = db.get_index<chain::key_value_index, chain::by_scope_primary>();
+
+         std::map<balance_key, chain::asset> built;
+         for (const auto& t : table_index) {
+            if (t.table != accounts_table)
+               continue;
+            for (auto itr = row_index.lower_bound(boost::make_tuple(t.id)); itr != row_index.end() && itr->t_id == t.id; ++itr) {
+               if (auto balance = read_balance(t, *itr))
+                  built.emplace(balance_key{t.scope, t.code, itr->primary_key}, *balance);
+            }
+         }
+         const auto count = built.size();
+         {
+            std::unique_lock write_lock(rw_mutex);
+            balances.swap(built);
+         }
+
+         // what the reversible blocks applied so far changed is not known, e.g. those applied before a restart
+         changed_by_block.clear();
+         untracked_head_num = controller.head_block_num();
+
+         auto duration = fc::time_point::now() - start;
+         ilog("Finished building token balance DB with ${n} balances in ${sec}",
+              ("n", count)("sec", (duration.count() / 1'000'000.0 )));
+      }
+
+      /**
+       * The balance held by a row of an `accounts` table, if the row has the eosio.token layout: an asset whose
+       * symbol code is the primary key, in a contract that has a `stat` table for that symbol code
+       */
+      std::optional<chain::asset> read_balance( const chain::table_id_object& t, const chain::key_value_object& row ) const {
+         int64_t  amount;
+         uint64_t sym;
+         if (t.table != accounts_table || row.value.size() != sizeof(amount) + sizeof(sym))
+            return {};
+         memcpy(&amount, row.value.data(), sizeof(amount));
+         memcpy(&sym, row.value.data() + sizeof(amount), sizeof(sym));
+         if ((sym >> 8) != row.primary_key)
+            return {};
+         if (!controller.db().find<chain::table_id_object, chain::by_code_scope_table>(boost::make_tuple(t.code, chain::name(row.primary_key), stat_table)))
+            return {};
+         try {
+            return chain::asset(amount, chain::symbol(sym));
+         } catch (const fc::exception&) {
+            return {}; // not a valid asset
+         }
+      }
+
+      /**
+       * The balance of key in the chain state at the current HEAD
+       */
+      std::optional<chain::asset> read_balance( const balance_key& key ) const {
+         const auto& [holder, contract, symbol_code] = key;
+         const auto& db = controller.db();
+         const auto* t = db.find<chain::table_id_object, chain::by_code_scope_table>(boost::make_tuple(contract, holder, accounts_table));
+         if (!t)
+            return {};
+         const auto* row = db.find<chain::key_value_object, chain::by_scope_primary>(boost::make_tuple(t->id, symbol_code));
+         if (!row)
+            return {};
+         return read_balance(*t, *row);
+      }
+
+      /**
+       * The balances changed by the last undo session of the chain state, i.e. by the block just accepted
+       */
+      std::set<balance_key> changed_balances() const {
+         const auto& db = controller.db();
+         const auto& table_index = db.get_index<chain::table_id_multi_index>();
+
+         // rows of a table removed in this block refer to the removed table id
+         std::map<uint64_t, const chain::table_id_object*> removed_tables;
+         for (const auto& t : table_index.last_undo_session().removed_values)
+            removed_tables[t.id._id] = &t;
+
+         auto find_table = [&](uint64_t tid) -> const chain::table_id_object* {
+            if (const auto* t = table_index.find(tid))
+               return t;
+            auto itr = removed_tables.find(tid);
+            return itr == removed_tables.end() ? nullptr : itr->second;
+         };
+
+         std::set<balance_key> changed;
+         auto add_row = [&](const chain::key_value_object& row) {
+            const auto* t = find_table(row.t_id._id);
+            if (t && t->table == accounts_table)
+               changed.emplace(t->scope, t->code, row.primary_key);
+         };
+
+         auto undo = db.get_index<chain::key_value_index>().last_undo_session();
+         for (const auto& row : undo.old_values)
+            add_row(row);
+         for (const auto& row : undo.removed_values)
+            add_row(row);
+         for (const auto& row : undo.new_values)
+            add_row(row);
+         return changed;
+      }
+
+      /**
+       * Commit a block to the token balance DB
+       * @param block
+       */
+      void commit_block( const chain::signed_block_ptr& block ) {
+         const auto block_num = block->block_num();
+         const auto lib_num = controller.last_irreversible_block_num();
+         if (untracked_head_num > lib_num && block_num <= untracked_head_num) {
+            // a fork switch popped a reversible block whose changes are not known, read every balance again
+            build_token_balance_map();
+            return;
+         }
+
+         auto changed = changed_balances();
+
+         // a block at or below a block seen before means a fork switch, the balances changed by the blocks that were
+         // forked out have been restored in the chain state and need to be read again
+         std::set<balance_key> refresh = changed;
+         for (auto itr = changed_by_block.lower_bound(block_num); itr != changed_by_block.end();) {
+            refresh.insert(itr->second.begin(), itr->second.end());
+            itr = changed_by_block.erase(itr);
+         }
+
+         // only keep track of what reversible blocks changed
+         changed_by_block.erase(changed_by_block.begin(), changed_by_block.upper_bound(lib_num));
+         if (block_num > lib_num && !changed.empty())
+            changed_by_block.emplace(block_num, std::move(changed));
+
+         if (refresh.empty())
+            return;
+
+         std::vector<std::pair<balance_key, std::optional<chain::asset>>> updates;
+         updates.reserve(refresh.size());
+         for (const auto& key : refresh)
+            updates.emplace_back(key, read_balance(key));
+
+         std::unique_lock write_lock(rw_mutex);
+         for (auto& [key, balance] : updates) {
+            if (balance)
+               balances.insert_or_assign(key, *balance);
+            else
+               balances.erase(key);
+         }
+      }
+
+      token_balance_db::get_token_balances_result
+      get_token_balances( const token_balance_db::get_token_balances_params& args ) const {
+         using result_t = token_balance_db::get_token_balances_result;
+         result_t result;
+
+         // deduplicate inputs
+         const auto account_set = std::set<chain::name>(args.accounts.begin(), args.accounts.end());
+         const auto contract_set = std::set<chain::name>(args.contracts.begin(), args.contracts.end());
+
+         std::shared_lock read_lock(rw_mutex);
+         for (const auto& account : account_set) {
+            auto itr = balances.lower_bound(balance_key{account, chain::name(), 0});
+            for (; itr != balances.end() && std::get<0>(itr->first) == account; ++itr) {
+               const auto& contract = std::get<1>(itr->first);
+               if (contract_set.empty() || contract_set.count(contract))
+                  result.balances.emplace_back(result_t::balance_result{account, contract, itr->second});
+            }
+         }
+         return result;
+      }
+
+      const chain::controller&                               controller;       ///< the controller to read data from
+      std::map<uint32_t, std::set<balance_key>>              changed_by_block; ///< balances changed by reversible blocks
+      uint32_t                                               untracked_head_num = 0; ///< head when the balances were last built, the reversible blocks up to it are not in changed_by_block
+
+      /*
+       * The balances are shared between the writing thread and the reading thread(s) and must be protected by the
+       * `rw_mutex`
+       */
+      std::map<balance_key, chain::asset>                    balances;
+      mutable std::shared_mutex                              rw_mutex;
+   };
+
+   token_balance_db::token_balance_db( const chain::controller& controller )
+   :_impl(std::make_unique<token_balance_db_impl>(controller))
+   {
+      _impl->build_token_balance_map();
+   }
+
+   token_balance_db::~token_balance_db() = default;
+   token_balance_db::token_balance_db(token_balance_db&&) = default;
+   token_balance_db& token_balance_db::operator=(token_balance_db&&) = default;
+
+   void token_balance_db::commit_block( const chain::signed_block_ptr& block ) {
+      try {
+         _impl->commit_block(block);
+      } FC_LOG_AND_DROP(("TOKEN BALANCE DB commit_block ERROR"));
+   }
+
+   token_balance_db::get_token_balances_result token_balance_db::get_token_balances( const get_token_balances_params& args ) const {
+      return _impl->get_token_balances(args);
+   }
+
+}
@@ -143,6 +143,7 @@ namespace eosio {
             detail::internal_url_handler handler;
             handler.content_type = content_type;
             handler.category = entry.category;
+            handler.cacheable = entry.cacheable;
             auto next_ptr = std::make_shared<url_handler>(std::move(entry.handler));
             handler.fn = [my=std::move(my), priority, to_queue, next_ptr=std::move(next_ptr)]
                        ( detail::abstract_conn_ptr conn, string&& r, string&& b, url_response_callback&& then ) {
@@ -176,15 +177,31 @@ namespace eosio {
           *
           * @pre b.size() has been added to bytes_in_flight by caller
           * @param next - the next handler for responses
+          * @param my - the http_plugin_impl
           * @return the constructed internal_url_handler
           */
-         static detail::internal_url_handler make_http_thread_url_handler(api_entry&& entry, http_content_type content_type) {
+         static detail::internal_url_handler make_http_thread_url_handler(api_entry&& entry, http_plugin_impl_ptr my, http_content_type content_type) {
             detail::internal_url_handler handler;
             handler.content_type = content_type;
             handler.category = entry.category;
-            handler.fn = [next=std::move(entry.handler)]( const detail::abstract_conn_ptr& conn, string&& r, string&& b, url_response_callback&& then ) mutable {
+            handler.cacheable = entry.cacheable;
+            auto next_ptr = std::make_shared<url_handler>(std::move(entry.handler));
+            handler.fn = [my=std::move(my), category=entry.category, next_ptr=std::move(next_ptr)]( const detail::abstract_conn_ptr& conn, string&& r, string&& b, url_response_callback&& then ) {
+               auto* ce = my->plugin_state->find_category_executor(category);
+               if (ce && ce->thread_pool_size > 0) {
+                  // run on the thread pool of the category so slow requests do not hold up other categories
+                  boost::asio::post(ce->thread_pool.get_executor(),
+                                    [next_ptr, conn, r=std::move(r), b=std::move(b), then=std::move(then)]() mutable {
+                     try {
+                        (*next_ptr)(std::move(r), std::move(b), std::move(then));
+                     } catch( ... ) {
+                        conn->handle_exception();
+                     }
+                  });
+                  return;
+               }
                try {
-                  next(std::move(r), std::move(b), std::move(then));
+                  (*next_ptr)(std::move(r), std::move(b), std::move(then));
                } catch( ... ) {
                   conn->handle_exception();
                }
@@ -192,6 +209,44 @@ namespace eosio {
             return handler;
          }
          
+         /**
+          * Make an internal_url_handler that will run the url_stream_handler directly, see make_http_thread_url_handler
+          *
+          * @param next - the handler, which may stream its response
+          * @param my - the http_plugin_impl
+          * @return the constructed internal_url_handler
+          */
+         static detail::internal_url_handler make_http_thread_stream_handler(api_category category, url_stream_handler&& next, http_plugin_impl_ptr my) {
+            detail::internal_url_handler handler;
+            handler.content_type = http_content_type::json; // of responses through url_response_callback, e.g. errors
+            handler.category = category;
+            auto next_ptr = std::make_shared<url_stream_handler>(std::move(next));
+            handler.fn = [my=std::move(my), category, next_ptr=std::move(next_ptr)]( const detail::abstract_conn_ptr& conn, string&& r, string&& b, url_response_callback&& then ) {
+               auto call = [next_ptr, conn, r=std::move(r), b=std::move(b), then=std::move(then)]() mutable {
+                  try {
+                     if (!conn->allow_chunked_response()) {
+                        error_results results{400, "Streamed response requires chunked transfer encoding, e.g. HTTP/1.1"};
+                        then(400, fc::variant(results));
+                        return;
+                     }
+                     url_stream_callback stream = [conn](int code, std::string content_type, stream_producer producer) {
+                        conn->send_chunked_response(std::move(producer), code, std::move(content_type));
+                     };
+                     (*next_ptr)(std::move(r), std::move(b), std::move(then), std::move(stream));
+                  } catch( ... ) {
+                     conn->handle_exception();
+                  }
+               };
+               auto* ce = my->plugin_state->find_category_executor(category);
+               if (ce && ce->thread_pool_size > 0) {
+                  boost::asio::post(ce->thread_pool.get_executor(), std::move(call));
+                  return;
+               }
+               call();
+            };
+            return handler;
+         }
+
          bool is_unix_socket_address(const std::string& address) const {
             using boost::algorithm::starts_with;
             return starts_with(address, "/") || starts_with(address, "./") || starts_with(address, "../");
@@ -260,6 +315,30 @@ namespace eosio {
             }
          }
 
+         // parse "category,number" of http-category-threads and http-category-max-in-flight
+         static std::pair<api_category, int64_t> parse_category_spec(const char* option, const std::string& spec) {
+            auto comma_pos = spec.find(',');
+            EOS_ASSERT(comma_pos > 0 && comma_pos != std::string::npos, chain::plugin_config_exception,
+                       "${o} '${spec}' does not contain a required comma to separate the category and number",
+                       ("o", option)("spec", spec));
+            auto category_name = spec.substr(0, comma_pos);
+            auto category = category_name == "node" ? api_category::node : to_category(category_name);
+            EOS_ASSERT(category != api_category::unknown, chain::plugin_config_exception,
+                       "invalid category name `${name}` for ${o}", ("name", category_name)("o", option));
+            try {
+               return {category, std::stoll(spec.substr(comma_pos + 1))};
+            } catch (const std::exception&) {
+               EOS_THROW(chain::plugin_config_exception, "${o} '${spec}' number is not valid", ("o", option)("spec", spec));
+            }
+         }
+
+         http_plugin_state::category_executor& get_category_executor(api_category category) {
+            auto& ce = plugin_state->category_executors[category];
+            if (!ce)
+               ce = std::make_unique<http_plugin_state::category_executor>();
+            return *ce;
+         }
+
          std::string addresses_for_category(api_category category) const {
             std::string result;
             for (const auto& [address, categories] : categories_by_address) {
@@ -372,6 +451,29 @@ namespace eosio {
              "Number of worker threads in http thread pool")
             ("http-keep-alive", bpo::value<bool>()->default_value(true),
              "If set to false, do not keep HTTP connections alive, even if client requests.")
+            ("http-response-cache-ms", bpo::value<int64_t>()->default_value(0),
+             "Time in milliseconds to cache serialized responses of idempotent endpoints (e.g. get_info, get_block, get_abi).\n"
+             "Cached responses are also dropped on every new head or LIB. 0 to disable.")
+            ("http-compression-min-size", bpo::value<uint32_t>()->default_value(0),
+             "Minimum size in bytes of a response body to gzip when the client sends `Accept-Encoding: gzip`. 0 to disable compression.")
+            ("http-chunked-response-min-size", bpo::value<uint32_t>()->default_value(0),
+             "Minimum estimated size in bytes of a JSON response to stream with chunked transfer encoding instead of building its"
+             " text in memory first. The result itself is still built whole, and streamed responses are neither gzip encoded nor"
+             " cached. http-max-response-time-ms then applies to each chunk. 0 to disable.")
+            ("http-category-threads", bpo::value<std::vector<string>>()->composing(),
+             "Dedicated http worker threads for an API category, can be specified multiple times. The async handlers and the"
+             " response serialization of the category run there instead of on the shared http threads. Handlers queued for"
+             " the main application, e.g. get_info and get_table_rows, still run on its read-only threads by priority;"
+             " use http-category-max-in-flight to bound how many of them a category can queue.  Syntax: category,threads\n"
+             "  Valid categories are node and those of http-category-address.\n"
+             "  Example: chain_ro,4")
+            ("http-category-max-in-flight", bpo::value<std::vector<string>>()->composing(),
+             "Maximum number of requests of an API category being processed at once, can be specified multiple times."
+             " 503 error response when exceeded.  Syntax: category,requests\n"
+             "  Example: chain_ro,64")
+            ("http-max-pipelined-requests", bpo::value<uint16_t>()->default_value(my->plugin_state->max_pipelined_requests),
+             "Maximum number of requests read ahead of their responses on a single connection (HTTP/1.1 pipelining)."
+             " Responses are always sent in request order. 1 disables pipelining.")
             ;
    }
 
@@ -411,6 +513,35 @@ namespace eosio {
 
          my->plugin_state->keep_alive = options.at("http-keep-alive").as<bool>();
 
+         int64_t response_cache_ms = options.at("http-response-cache-ms").as<int64_t>();
+         EOS_ASSERT( response_cache_ms >= 0, chain::plugin_config_exception,
+                     "http-response-cache-ms must be non-negative: ${m}", ("m", response_cache_ms) );
+         my->plugin_state->response_cache.configure( fc::milliseconds(response_cache_ms),
+                                                     options.at("http-compression-min-size").as<uint32_t>() );
+         my->plugin_state->chunked_response_min_size = options.at("http-chunked-response-min-size").as<uint32_t>();
+
+         my->plugin_state->max_pipelined_requests = options.at("http-max-pipelined-requests").as<uint16_t>();
+         EOS_ASSERT( my->plugin_state->max_pipelined_requests > 0, chain::plugin_config_exception,
+                     "http-max-pipelined-requests must be greater than 0" );
+
+         if( options.count( "http-category-threads" )) {
+            for( const auto& spec : options["http-category-threads"].as<vector<string>>() ) {
+               auto [category, num] = my->parse_category_spec( "http-category-threads", spec );
+               EOS_ASSERT( num > 0 && num <= std::numeric_limits<uint16_t>::max(), chain::plugin_config_exception,
+                           "http-category-threads '${spec}' thread count must be greater than 0", ("spec", spec) );
+               my->get_category_executor(category).thread_pool_size = num;
+            }
+         }
+
+         if( options.count( "http-category-max-in-flight" )) {
+            for( const auto& spec : options["http-category-max-in-flight"].as<vector<string>>() ) {
+               auto [category, num] = my->parse_category_spec( "http-category-max-in-flight", spec );
+               EOS_ASSERT( num >= 0 && num <= std::numeric_limits<int32_t>::max(), chain::plugin_config_exception,
+                           "http-category-max-in-flight '${spec}' request count must be non-negative", ("spec", spec) );
+               my->get_category_executor(category).max_requests_in_flight = num;
+            }
+         }
+
          std::string http_server_address;
          if (options.count("http-server-address")) {
             http_server_address = options.at("http-server-address").as<string>();
@@ -484,6 +615,16 @@ namespace eosio {
                app().quit();
             } );
 
+            for (auto& [category, ce] : my->plugin_state->category_executors) {
+               if (ce->thread_pool_size == 0)
+                  continue;
+               fc_ilog( logger(), "starting ${n} http threads for ${c}", ("n", ce->thread_pool_size)("c", from_category(category)) );
+               ce->thread_pool.start( ce->thread_pool_size, [](const fc::exception& e) {
+                  fc_elog( logger(), "Exception in http category thread pool, exiting: ${e}", ("e", e.to_detail_string()) );
+                  app().quit();
+               } );
+            }
+
             for (const auto& [address, categories]: my->categories_by_address) {
                my->create_beast_server(address, categories);
             }
@@ -507,6 +648,8 @@ namespace eosio {
    }
 
    void http_plugin::plugin_shutdown() {
+      for (auto& [category, ce] : my->plugin_state->category_executors)
+         ce->thread_pool.stop();
       my->plugin_state->thread_pool.stop();
 
       // release http_plugin_impl_ptr shared_ptrs captured in url handlers
@@ -535,7 +678,14 @@ namespace eosio {
    void http_plugin::add_async_handler(api_entry&& entry, http_content_type content_type) {
       log_add_handler(my.get(), entry);
       std::string path  = entry.path;
-      auto p = my->plugin_state->url_handlers.emplace(path, my->make_http_thread_url_handler(std::move(entry), content_type));
+      auto p = my->plugin_state->url_handlers.emplace(path, my->make_http_thread_url_handler(std::move(entry), my, content_type));
+      EOS_ASSERT( p.second, chain::plugin_config_exception, "http url ${u} is not unique", ("u", path) );
+   }
+
+   void http_plugin::add_async_stream_handler(string path, api_category category, url_stream_handler handler) {
+      api_entry entry{.path = path, .category = category};
+      log_add_handler(my.get(), entry);
+      auto p = my->plugin_state->url_handlers.emplace(path, my->make_http_thread_stream_handler(category, std::move(handler), my));
       EOS_ASSERT( p.second, chain::plugin_config_exception, "http url ${u} is not unique", ("u", path) );
    }
 
@@ -544,6 +694,11 @@ namespace eosio {
          boost::asio::post( my->plugin_state->thread_pool.get_executor(), f );
    }
 
+   void http_plugin::post_http_thread_pool(std::function<void()> f, api_category category) {
+      if( f )
+         boost::asio::post( my->plugin_state->executor_for(category), f );
+   }
+
    void http_plugin::handle_exception( const char* api_name, const char* call_name, const string& body, const url_response_callback& cb) {
       try {
          try {
@@ -624,6 +779,11 @@ namespace eosio {
       my->plugin_state->update_metrics = std::move(fun);
    }
 
+   void http_plugin::invalidate_response_cache() {
+      if (my->plugin_state->response_cache.enabled())
+         my->plugin_state->response_cache.invalidate();
+   }
+
    std::atomic<bool>& http_plugin::listening() {
       return my->listening;
    }
@@ -9,9 +9,10 @@
 #include <boost/iostreams/device/array.hpp>
 #include <boost/iostreams/stream.hpp>
 
+#include <charconv>
+#include <deque>
 #include <memory>
 #include <string>
-#include <charconv>
 
 namespace eosio {
 
@@ -66,24 +67,97 @@ std::string to_log_string(const T& req, size_t max_size = 1024) {
 
 // use the Curiously Recurring Template Pattern so that
 // the same code works with both regular TCP sockets and UNIX sockets
+//
+// Requests on a connection may be pipelined: up to http_plugin_state::max_pipelined_requests requests are read and
+// passed to their handlers before the oldest one is answered. Responses are queued in request order and each is written
+// as soon as it reaches the front of the queue. Session state is only accessed on strand_.
 template <class Socket>
-class beast_http_session : public detail::abstract_conn,
-                           public std::enable_shared_from_this<beast_http_session<Socket>> {
+class beast_http_session : public std::enable_shared_from_this<beast_http_session<Socket>> {
+
+   // abstract_conn of a single request, sends its response to the request's slot in the pipeline
+   class request_conn : public detail::abstract_conn {
+      std::shared_ptr<beast_http_session> session_;
+      uint64_t                            seq_;
+      bool                                accept_gzip_;    // whether the request allows a gzip encoded response
+      bool                                allow_chunked_;  // whether the request allows a chunked response
+
+   public:
+      request_conn(std::shared_ptr<beast_http_session> session, uint64_t seq, bool accept_gzip, bool allow_chunked)
+          : session_(std::move(session)), seq_(seq), accept_gzip_(accept_gzip), allow_chunked_(allow_chunked) {}
+
+      std::string verify_max_bytes_in_flight(size_t extra_bytes) final {
+         return session_->verify_max_bytes_in_flight(extra_bytes);
+      }
+
+      std::string verify_max_requests_in_flight() final {
+         return session_->verify_max_requests_in_flight();
+      }
+
+      void send_busy_response(std::string&& what) final {
+         session_->send_busy_response(seq_, std::move(what));
+      }
+
+      void handle_exception() final {
+         session_->handle_exception(seq_);
+      }
+
+      void send_response(std::string&& json, unsigned int code) final {
+         if(accept_gzip_ && json.size() >= session_->plugin_state_->response_cache.compress_min_size())
+            session_->write_response(seq_, fc::gzip_compress(json), code, true);
+         else
+            session_->write_response(seq_, std::move(json), code, false);
+      }
+
+      void send_response(response_cache::entry_ptr cached, unsigned int code) final {
+         if(accept_gzip_ && !cached->gzip.empty())
+            session_->write_response(seq_, std::string(cached->gzip), code, true);
+         else
+            session_->write_response(seq_, std::string(cached->json), code, false);
+      }
+
+      bool allow_chunked_response() const final {
+         return allow_chunked_;
+      }
+
+      void send_chunked_response(detail::chunk_producer next, unsigned int code, std::string content_type) final {
+         session_->write_chunked_response(seq_, std::move(next), code, std::move(content_type));
+      }
+   };
 
    std::shared_ptr<http_plugin_state> plugin_state_;
    Socket             socket_;
+   asio::strand<typename Socket::executor_type> strand_;
    api_category_set   categories_;
    beast::flat_buffer buffer_;
 
    // time points for timeout measurement and perf metrics
-   steady_clock::time_point session_begin_, read_begin_, handle_begin_, write_begin_;
+   steady_clock::time_point session_begin_, read_begin_, write_begin_;
    uint64_t read_time_us_ = 0, handle_time_us_ = 0, write_time_us_ = 0;
 
    // HTTP parser object
    std::optional<http::request_parser<http::string_body>> req_parser_;
 
-   // HTTP response object
-   std::optional<http::response<http::string_body>> res_;
+   // HTTP response of a read request, queued in request order until written
+   struct pending_response {
+      http::response<http::string_body>      res;
+      steady_clock::time_point               handle_begin;
+      size_t                                 payload_size = 0;
+      bool                                   ready = false;       // res is complete and can be written
+      http_plugin_state::category_executor*  admitted = nullptr;  // category in-flight slot to release once answered
+      api_category                           category = api_category::node;
+
+      // chunked response, the body is produced piece by piece while it is written
+      detail::chunk_producer                 next_chunk;
+      std::optional<http::response_serializer<http::string_body>> header_sr;
+      std::string                            chunk;
+   };
+   std::deque<pending_response> pipeline_;
+   uint64_t pipeline_front_seq_ = 0;   // sequence number of pipeline_.front()
+   bool writing_ = false;              // an async_write of pipeline_.front() is outstanding
+   bool read_paused_ = false;          // reading stopped because max_pipelined_requests responses are pending
+   bool read_done_ = false;            // no further requests are read from this connection
+   bool continue_deferred_ = false;    // "Expect: 100-continue" received while responses were pending
+   bool closed_ = false;
 
    std::string remote_endpoint_;
    std::string local_address_;
@@ -91,37 +165,49 @@ class beast_http_session : public detail::abstract_conn,
    // whether response should be sent back to client when an exception occurs
    bool is_send_exception_response_ = true;
 
-   void set_content_type_header(http_content_type content_type) {
+   static void set_content_type_header(http::response<http::string_body>& res, http_content_type content_type) {
       switch (content_type) {
          case http_content_type::plaintext:
-            res_->set(http::field::content_type, "text/plain");
+            res.set(http::field::content_type, "text/plain");
             break;
 
          case http_content_type::json:
          default:
-            res_->set(http::field::content_type, "application/json");
+            res.set(http::field::content_type, "application/json");
       }
    }
 
-   enum class continue_state_t { none, read_body, reject };
-   continue_state_t continue_state_ { continue_state_t::none };
+   uint64_t add_pending_response(unsigned version, bool keep_alive) {
+      auto& p = pipeline_.emplace_back();
+      p.res.version(version);
+      p.res.set(http::field::content_type, "application/json");
+      p.res.keep_alive(keep_alive);
+      p.handle_begin = steady_clock::now();
+      return pipeline_front_seq_ + pipeline_.size() - 1;
+   }
+
+   pending_response& pending(uint64_t seq) {
+      return pipeline_[seq - pipeline_front_seq_];
+   }
 
    template<
          class Body, class Allocator>
    void
    handle_request(http::request<Body, http::basic_fields<Allocator>>&& req) {
-      res_->version(req.version());
-      res_->set(http::field::content_type, "application/json");
-      res_->keep_alive(req.keep_alive());
+      const uint64_t seq = add_pending_response(req.version(), req.keep_alive());
+      auto& res = pending(seq).res;
+      auto conn = std::make_shared<request_conn>(this->shared_from_this(), seq,
+                                                 plugin_state_->response_cache.compress_min_size() && accepts_gzip(req[http::field::accept_encoding]),
+                                                 req.version() >= 11);
       if(plugin_state_->server_header.size())
-         res_->set(http::field::server, plugin_state_->server_header);
+         res.set(http::field::server, plugin_state_->server_header);
 
       // Request path must be absolute and not contain "..".
       if(req.target().empty() || req.target()[0] != '/' || req.target().find("..") != beast::string_view::npos) {
          fc_dlog( plugin_state_->get_logger(), "Return bad_reqest:  ${target}",  ("target", std::string(req.target())) );
          error_results results{static_cast<uint16_t>(http::status::bad_request), "Illegal request-target"};
-         send_response( fc::json::to_string( results, fc::time_point::maximum() ),
-                        static_cast<unsigned int>(http::status::bad_request) );
+         conn->send_response( fc::json::to_string( results, fc::time_point::maximum() ),
+                              static_cast<unsigned int>(http::status::bad_request) );
          return;
       }
 
@@ -129,27 +215,27 @@ class beast_http_session : public detail::abstract_conn,
          if(!allow_host(req)) {
             fc_dlog( plugin_state_->get_logger(), "bad host:  ${HOST}", ("HOST", std::string(req["host"])));
             error_results results{static_cast<uint16_t>(http::status::bad_request), "Disallowed HTTP HOST header in the request"};
-            send_response( fc::json::to_string( results, fc::time_point::maximum() ),
-                        static_cast<unsigned int>(http::status::bad_request) );
+            conn->send_response( fc::json::to_string( results, fc::time_point::maximum() ),
+                                 static_cast<unsigned int>(http::status::bad_request) );
             return;
          }
 
          if(!plugin_state_->access_control_allow_origin.empty()) {
-            res_->set("Access-Control-Allow-Origin", plugin_state_->access_control_allow_origin);
+            res.set("Access-Control-Allow-Origin", plugin_state_->access_control_allow_origin);
          }
          if(!plugin_state_->access_control_allow_headers.empty()) {
-            res_->set("Access-Control-Allow-Headers", plugin_state_->access_control_allow_headers);
+            res.set("Access-Control-Allow-Headers", plugin_state_->access_control_allow_headers);
          }
          if(!plugin_state_->access_control_max_age.empty()) {
-            res_->set("Access-Control-Max-Age", plugin_state_->access_control_max_age);
+            res.set("Access-Control-Max-Age", plugin_state_->access_control_max_age);
          }
          if(plugin_state_->access_control_allow_credentials) {
-            res_->set("Access-Control-Allow-Credentials", "true");
+            res.set("Access-Control-Allow-Credentials", "true");
          }
 
          // Respond to options request
          if(req.method() == http::verb::options) {
-            send_response("{}", static_cast<unsigned int>(http::status::ok));
+            conn->send_response("{}", static_cast<unsigned int>(http::status::ok));
             return;
          }
 
@@ -164,70 +250,115 @@ class beast_http_session : public detail::abstract_conn,
                plugin_state_->get_logger().log(FC_LOG_MESSAGE(all, "resource: ${ep}", ("ep", resource)));
             std::string body = req.body();
             auto content_type = handler_itr->second.content_type;
-            set_content_type_header(content_type);
+            auto category = handler_itr->second.category;
+            set_content_type_header(res, content_type);
+            pending(seq).category = category;
+
+            std::optional<response_cache_key> cache_key;
+            if (handler_itr->second.cacheable && plugin_state_->response_cache.enabled()) {
+               cache_key.emplace(response_cache_key{resource + '\n' + body, plugin_state_->response_cache.generation()});
+               if (auto cached = plugin_state_->response_cache.find(cache_key->key)) {
+                  if (plugin_state_->update_metrics)
+                     plugin_state_->update_metrics({.target = resource, .cacheable = true, .cache_hit = true});
+                  conn->send_response(std::move(cached), static_cast<unsigned int>(http::status::ok));
+                  return;
+               }
+            }
+
+            if (auto* ce = plugin_state_->find_category_executor(category)) {
+               if (!ce->try_admit()) {
+                  fc_dlog(plugin_state_->get_logger(), "503 - too many requests in flight for ${r}", ("r", resource));
+                  conn->send_busy_response("Too many requests in flight for API category of " + resource + ": " +
+                                           std::to_string(ce->requests_in_flight.load()));
+                  return;
+               }
+               pending(seq).admitted = ce;
+            }
 
             if (plugin_state_->update_metrics)
-               plugin_state_->update_metrics({resource});
+               plugin_state_->update_metrics({.target = resource, .cacheable = cache_key.has_value()});
 
-            handler_itr->second.fn(this->shared_from_this(),
+            handler_itr->second.fn(conn,
                                 std::move(resource),
                                 std::move(body),
-                                make_http_response_handler(*plugin_state_, this->shared_from_this(), content_type));
+                                make_http_response_handler(*plugin_state_, conn, content_type, category, std::move(cache_key)));
          } else if (resource == "/v1/node/get_supported_apis") {
             http_plugin::get_supported_apis_result result;
             for (const auto& handler : plugin_state_->url_handlers) {
                if (categories_.contains(handler.second.category))
                   result.apis.push_back(handler.first);
             }
-            send_response(fc::json::to_string(fc::variant(result), fc::time_point::maximum()), 200);
+            conn->send_response(fc::json::to_string(fc::variant(result), fc::time_point::maximum()), 200);
          } else {
             fc_dlog( plugin_state_->get_logger(), "404 - not found: ${ep}", ("ep", resource) );
             error_results results{static_cast<uint16_t>(http::status::not_found), "Not Found",
                                   error_results::error_info( fc::exception( FC_LOG_MESSAGE( error, "Unknown Endpoint" ) ),
                                                              http_plugin::verbose_errors() )};
-            send_response( fc::json::to_string( results, fc::time_point::maximum() ),
-                           static_cast<unsigned int>(http::status::not_found) );
+            conn->send_response( fc::json::to_string( results, fc::time_point::maximum() ),
+                                 static_cast<unsigned int>(http::status::not_found) );
          }
       } catch(...) {
-         handle_exception();
+         conn->handle_exception();
       }
    }
 
 private:
+   void handle_expect_continue() {
+      bool do_continue = true;
+      auto sv = req_parser_->get()[http::field::content_length];
+      if (uint64_t sz; !sv.empty() && std::from_chars(sv.data(), sv.data() + sv.size(), sz).ec == std::errc() &&
+          sz > plugin_state_->max_body_size) {
+         do_continue = false;
+      }
+      send_100_continue_response(do_continue);
+   }
+
    void send_100_continue_response(bool do_continue) {
       auto res = std::make_shared<http::response<http::empty_body>>();
          
       res->version(11);
       if (do_continue) {
          res->result(http::status::continue_);
-         continue_state_ = continue_state_t::read_body;   // after sending the continue response, just read the body with the same parser
       } else {
          res->result(http::status::unauthorized);
-         continue_state_ = continue_state_t::reject;
       }
       res->set(http::field::server, plugin_state_->server_header);
       
       http::async_write(
          socket_,
          *res,
-         [self = this->shared_from_this(), res](beast::error_code ec, std::size_t bytes_transferred) {
-            self->on_write(ec, bytes_transferred, false);
-         });
+         asio::bind_executor(strand_, [self = this->shared_from_this(), res, do_continue](beast::error_code ec, std::size_t) {
+            self->on_continue_write(ec, do_continue);
+         }));
+   }
+
+   void on_continue_write(beast::error_code ec, bool do_continue) {
+      if(ec) {
+         return fail(ec, "write", plugin_state_->get_logger(), "closing connection");
+      }
+
+      if(do_continue) {
+         // just sent "100-continue" response - now read the body with same parser
+         do_read();
+      } else {
+         // request body too large. After issuing 401 response, close connection
+         do_eof();
+      }
    }
 
 public:
 
-   virtual void send_busy_response(std::string&& what) final {
+   void send_busy_response(uint64_t seq, std::string&& what) {
       error_results::error_info ei;
       ei.code = static_cast<int64_t>(http::status::service_unavailable);
       ei.name = "Busy";
       ei.what = std::move(what);
       error_results results{static_cast<uint16_t>(http::status::service_unavailable), "Busy", ei};
-      send_response(fc::json::to_string(results, fc::time_point::maximum()),
-                    static_cast<unsigned int>(http::status::service_unavailable) );
+      write_response(seq, fc::json::to_string(results, fc::time_point::maximum()),
+                     static_cast<unsigned int>(http::status::service_unavailable), false );
    }
    
-   virtual std::string verify_max_bytes_in_flight(size_t extra_bytes) final {
+   std::string verify_max_bytes_in_flight(size_t extra_bytes) {
       auto bytes_in_flight_size = plugin_state_->bytes_in_flight.load() + extra_bytes;
       if(bytes_in_flight_size > plugin_state_->max_bytes_in_flight) {
          fc_dlog(plugin_state_->get_logger(), "503 - too many bytes in flight: ${bytes}", ("bytes", bytes_in_flight_size));
@@ -236,7 +367,7 @@ public:
       return {};
    }
 
-   virtual std::string verify_max_requests_in_flight() final {
+   std::string verify_max_requests_in_flight() {
       if(plugin_state_->max_requests_in_flight < 0)
          return {};
 
@@ -254,12 +385,11 @@ public:
 
    beast_http_session(Socket&& socket, std::shared_ptr<http_plugin_state> plugin_state, std::string remote_endpoint,
                       api_category_set categories, const std::string& local_address)
-       : plugin_state_(std::move(plugin_state)), socket_(std::move(socket)), categories_(categories),
-         remote_endpoint_(std::move(remote_endpoint)), local_address_(local_address) {
+       : plugin_state_(std::move(plugin_state)), socket_(std::move(socket)), strand_(socket_.get_executor()),
+         categories_(categories), remote_endpoint_(std::move(remote_endpoint)), local_address_(local_address) {
       plugin_state_->requests_in_flight += 1;
       req_parser_.emplace();
       req_parser_->body_limit(plugin_state_->max_body_size);
-      res_.emplace();
 
       session_begin_ = steady_clock::now();
       read_time_us_ = handle_time_us_ = write_time_us_ = 0;
@@ -271,6 +401,13 @@ public:
    virtual ~beast_http_session() {
       is_send_exception_response_ = false;
       plugin_state_->requests_in_flight -= 1;
+      // responses never written because the connection closed early
+      for(auto& p : pipeline_) {
+         if(p.ready)
+            decrement_bytes_in_flight(p.payload_size);
+         if(p.admitted)
+            p.admitted->release();
+      }
       if(plugin_state_->get_logger().is_enabled(fc::log_level::all)) {
          auto session_time = steady_clock::now() - session_begin_;
          auto session_time_us = std::chrono::duration_cast<std::chrono::microseconds>(session_time).count();
@@ -289,30 +426,29 @@ public:
             socket_,
             buffer_,
             *req_parser_,
-            [self = this->shared_from_this()](beast::error_code ec, std::size_t bytes_transferred) {
+            asio::bind_executor(strand_, [self = this->shared_from_this()](beast::error_code ec, std::size_t bytes_transferred) {
                self->on_read_header(ec, bytes_transferred);
-            });
+            }));
    }
 
    void on_read_header(beast::error_code ec, std::size_t /* bytes_transferred */) {
       if(ec) {
          // See on_read comment below
          if(ec == http::error::end_of_stream || ec == asio::error::connection_reset)
-            return do_eof();
+            return on_read_eof();
 
+         read_done_ = true;
          return fail(ec, "read_header", plugin_state_->get_logger(), "closing connection");
       }
 
       // Check for the Expect field value
       if (req_parser_->get()[http::field::expect] == "100-continue") {
-         bool do_continue = true;
-         auto sv = req_parser_->get()[http::field::content_length];
-         if (uint64_t sz; !sv.empty() && std::from_chars(sv.data(), sv.data() + sv.size(), sz).ec == std::errc() &&
-             sz > plugin_state_->max_body_size) {
-            do_continue = false;
+         // the interim response must not be interleaved with the responses of earlier requests
+         if (!pipeline_.empty()) {
+            continue_deferred_ = true;
+            return;
          }
-         send_100_continue_response(do_continue);
-         return;
+         return handle_expect_continue();
       }
 
       // Read the rest of the message.
@@ -325,9 +461,9 @@ public:
             socket_,
             buffer_,
             *req_parser_,
-            [self = this->shared_from_this()](beast::error_code ec, std::size_t bytes_transferred) {
+            asio::bind_executor(strand_, [self = this->shared_from_this()](beast::error_code ec, std::size_t bytes_transferred) {
                self->on_read(ec, bytes_transferred);
-            });
+            }));
    }
 
    void on_read(beast::error_code ec, std::size_t /* bytes_transferred */) {
@@ -338,27 +474,57 @@ public:
          // on another read. If the client disconnects, we may get
          // http::error::end_of_stream or asio::error::connection_reset.
          if(ec == http::error::end_of_stream || ec == asio::error::connection_reset)
-            return do_eof();
+            return on_read_eof();
 
+         read_done_ = true;
          return fail(ec, "read", plugin_state_->get_logger(), "closing connection");
       }
 
       auto req = req_parser_->release();
 
-      handle_begin_ = steady_clock::now();
-      auto dt = handle_begin_ - read_begin_;
+      auto dt = steady_clock::now() - read_begin_;
       read_time_us_ += std::chrono::duration_cast<std::chrono::microseconds>(dt).count();
 
+      // create a new parser to clear state
+      req_parser_.emplace();
+      req_parser_->body_limit(plugin_state_->max_body_size);
+
+      // the response to this request closes the connection
+      if(!req.keep_alive() || !plugin_state_->keep_alive)
+         read_done_ = true;
+
       // Send the response
       handle_request(std::move(req));
+
+      // Read another request, unless too many responses are pending
+      if(read_done_ || closed_)
+         return;
+      if(pipeline_.size() < plugin_state_->max_pipelined_requests)
+         do_read_header();
+      else
+         read_paused_ = true;
+   }
+
+   void on_read_eof() {
+      read_done_ = true;
+      // client may half-close after pipelining its requests, answer them first
+      if(pipeline_.empty())
+         do_eof();
    }
 
    void on_write(beast::error_code ec,
-                 std::size_t bytes_transferred,
-                 bool close) {
+                 std::size_t bytes_transferred) {
       boost::ignore_unused(bytes_transferred);
 
+      writing_ = false;
+      decrement_bytes_in_flight(pipeline_.front().payload_size);
+      // Determine if we should close the connection after
+      bool close = !(plugin_state_->keep_alive) || pipeline_.front().res.need_eof();
+      pipeline_.pop_front();
+      ++pipeline_front_seq_;
+
       if(ec) {
+         closed_ = true;
          return fail(ec, "write", plugin_state_->get_logger(), "closing connection");
       }
 
@@ -371,36 +537,24 @@ public:
          return do_eof();
       }
 
-      // create a new response object
-      res_.emplace();
+      if(read_paused_ && pipeline_.size() < plugin_state_->max_pipelined_requests) {
+         read_paused_ = false;
+         do_read_header();
+      }
 
-      switch(continue_state_) {
-      case continue_state_t::read_body:
-         // just sent "100-continue" response - now read the body with same parser
-         continue_state_ = continue_state_t::none;
-         do_read();
-         break;
-         
-      case continue_state_t::reject:
-         // request body too large. After issuing 401 response, close connection
-         continue_state_ = continue_state_t::none;
-         do_eof();
-         break;
-         
-      default:
-         assert(continue_state_ == continue_state_t::none);
-         
-         // create a new parser to clear state
-         req_parser_.emplace();
-         req_parser_->body_limit(plugin_state_->max_body_size);
+      if(!pipeline_.empty())
+         return do_write();
 
-         // Read another request
-         do_read_header();
-         break;
+      if(continue_deferred_) {
+         continue_deferred_ = false;
+         return handle_expect_continue();
       }
+
+      if(read_done_)
+         do_eof();
    }
 
-   virtual void handle_exception() final {
+   void handle_exception(uint64_t seq) {
       std::string err_str;
       try {
          try {
@@ -446,12 +600,8 @@ public:
 
 
       if(is_send_exception_response_) {
-         set_content_type_header(http_content_type::json);
-         res_->keep_alive(false);
-         res_->set(http::field::server, BOOST_BEAST_VERSION_STRING);
-
-         send_response(std::move(err_str), static_cast<unsigned int>(http::status::internal_server_error));
-         do_eof();
+         // connection is closed once the error response is written
+         write_response(seq, std::move(err_str), static_cast<unsigned int>(http::status::internal_server_error), false, true);
       }
    }
 
@@ -463,37 +613,183 @@ public:
       plugin_state_->bytes_in_flight -= sz;
    }
 
-   virtual void send_response(std::string&& json, unsigned int code) final {
-      auto payload_size = json.size();
-      increment_bytes_in_flight(payload_size);
-      write_begin_ = steady_clock::now();
-      auto dt = write_begin_ - handle_begin_;
+   // thread safe, completes the response of request seq
+   void write_response(uint64_t seq, std::string&& body, unsigned int code, bool gzip, bool error_close = false) {
+      increment_bytes_in_flight(body.size());
+      asio::dispatch(strand_, [self = this->shared_from_this(), seq, body = std::move(body), code, gzip, error_close]() mutable {
+         self->complete_response(seq, std::move(body), code, gzip, error_close);
+      });
+   }
+
+   // the pending response of seq, nullptr if it has already been answered, e.g. by handle_exception
+   pending_response* answer(uint64_t seq) {
+      if(seq < pipeline_front_seq_ || seq - pipeline_front_seq_ >= pipeline_.size() || pending(seq).ready)
+         return nullptr;
+
+      auto& p = pending(seq);
+      auto dt = steady_clock::now() - p.handle_begin;
       handle_time_us_ += std::chrono::duration_cast<std::chrono::microseconds>(dt).count();
+      if(p.admitted) {
+         p.admitted->release();
+         p.admitted = nullptr;
+      }
+      return &p;
+   }
 
-      res_->result(code);
-      res_->body() = std::move(json);
-      res_->prepare_payload();
+   void complete_response(uint64_t seq, std::string&& body, unsigned int code, bool gzip, bool error_close) {
+      auto payload_size = body.size();
+      auto* pp = answer(seq);
+      if(!pp) {
+         decrement_bytes_in_flight(payload_size);
+         return;
+      }
 
-      // Determine if we should close the connection after
-      bool close = !(plugin_state_->keep_alive) || res_->need_eof();
+      auto& p = *pp;
+      auto& res = p.res;
+      if(error_close) {
+         set_content_type_header(res, http_content_type::json);
+         res.keep_alive(false);
+         res.set(http::field::server, BOOST_BEAST_VERSION_STRING);
+      }
+      res.result(code);
+      if(gzip)
+         res.set(http::field::content_encoding, "gzip");
+      if(plugin_state_->response_cache.compress_min_size())
+         res.set(http::field::vary, "Accept-Encoding");
+      res.body() = std::move(body);
+      res.prepare_payload();
+      p.payload_size = payload_size;
+      p.ready = true;
+
+      do_write();
+   }
+
+   // thread safe, answers request seq with a body written chunk by chunk as next produces it
+   void write_chunked_response(uint64_t seq, detail::chunk_producer next, unsigned int code, std::string content_type = {}) {
+      asio::dispatch(strand_, [self = this->shared_from_this(), seq, next = std::move(next), code, content_type = std::move(content_type)]() mutable {
+         auto* p = self->answer(seq);
+         if(!p)
+            return;
+
+         auto& res = p->res;
+         res.result(code);
+         if(!content_type.empty())
+            res.set(http::field::content_type, content_type);
+         if(self->plugin_state_->response_cache.compress_min_size())
+            res.set(http::field::vary, "Accept-Encoding");
+         res.chunked(true);
+         p->next_chunk = std::move(next);
+         p->ready = true;
+
+         self->do_write();
+      });
+   }
+
+   void do_write() {
+      if(writing_ || closed_ || pipeline_.empty() || !pipeline_.front().ready)
+         return;
+
+      writing_ = true;
+      write_begin_ = steady_clock::now();
+      auto& res = pipeline_.front().res;
 
       fc_dlog( plugin_state_->get_logger(), "Response: ${ep} ${b}",
-               ("ep", remote_endpoint_)("b", to_log_string(*res_)) );
+               ("ep", remote_endpoint_)("b", to_log_string(res)) );
+
+      if(pipeline_.front().next_chunk) {
+         // write the header now, the body follows as it is produced
+         auto& sr = pipeline_.front().header_sr.emplace(res);
+         http::async_write_header(
+            socket_,
+            sr,
+            asio::bind_executor(strand_, [self = this->shared_from_this()](beast::error_code ec, std::size_t bytes_transferred) {
+               if(ec)
+                  return self->on_write(ec, bytes_transferred);
+               self->produce_chunk();
+            }));
+         return;
+      }
 
       // Write the response
       http::async_write(
          socket_,
-         *res_,
-         [self = this->shared_from_this(), payload_size, close](beast::error_code ec, std::size_t bytes_transferred) {
-            self->decrement_bytes_in_flight(payload_size);
-            self->on_write(ec, bytes_transferred, close);
+         res,
+         asio::bind_executor(strand_, [self = this->shared_from_this()](beast::error_code ec, std::size_t bytes_transferred) {
+            self->on_write(ec, bytes_transferred);
+         }));
+   }
+
+   // produce the next chunk of pipeline_.front() on an http thread, then write it
+   void produce_chunk() {
+      const auto& p = pipeline_.front();
+      asio::post(plugin_state_->executor_for(p.category), [self = this->shared_from_this(), next = p.next_chunk]() mutable {
+         std::string chunk;
+         bool more = false;
+         bool failed = true;
+         try {
+            more = next(chunk);
+            failed = false;
+         } catch(const fc::exception& e) {
+            fc_elog(self->plugin_state_->get_logger(), "Unable to produce chunked response: ${e}", ("e", e.to_detail_string()));
+         } catch(const std::exception& e) {
+            fc_elog(self->plugin_state_->get_logger(), "Unable to produce chunked response: ${e}", ("e", e.what()));
+         } catch(...) {
+            fc_elog(self->plugin_state_->get_logger(), "Unable to produce chunked response: unknown exception");
+         }
+         if(failed) {
+            asio::dispatch(self->strand_, [self]() { self->abort_chunked_response(); });
+            return;
+         }
+         self->increment_bytes_in_flight(chunk.size());
+         asio::dispatch(self->strand_, [self, chunk = std::move(chunk), more]() mutable {
+            self->write_chunk(std::move(chunk), more);
          });
+      });
+   }
+
+   void write_chunk(std::string&& chunk, bool more) {
+      auto chunk_size = chunk.size();
+      if(chunk.empty()) {
+         if(more)
+            produce_chunk();
+         else
+            write_last_chunk();
+         return;
+      }
+      auto& p = pipeline_.front();
+      p.chunk = std::move(chunk);
+      asio::async_write(
+         socket_,
+         http::make_chunk(asio::buffer(p.chunk)),
+         asio::bind_executor(strand_, [self = this->shared_from_this(), chunk_size, more](beast::error_code ec, std::size_t bytes_transferred) {
+            self->decrement_bytes_in_flight(chunk_size);
+            if(ec)
+               return self->on_write(ec, bytes_transferred);
+            if(more)
+               return self->produce_chunk();
+            self->write_last_chunk();
+         }));
+   }
+
+   void write_last_chunk() {
+      asio::async_write(
+         socket_,
+         http::make_chunk_last(),
+         asio::bind_executor(strand_, [self = this->shared_from_this()](beast::error_code ec, std::size_t bytes_transferred) {
+            self->on_write(ec, bytes_transferred);
+         }));
+   }
+
+   // the header has been sent so the failure can not be reported to the client, drop the connection instead
+   void abort_chunked_response() {
+      do_eof();
+      on_write(asio::error::operation_aborted, 0);
    }
 
    void run_session() {
       if(auto error_str = verify_max_requests_in_flight(); !error_str.empty()) {
-         res_->keep_alive(false);
-         send_busy_response(std::move(error_str));
+         read_done_ = true;
+         send_busy_response(add_pending_response(11, false), std::move(error_str));
          return;
       }
 
@@ -502,15 +798,13 @@ public:
 
    void do_eof() {
       is_send_exception_response_ = false;
-      try {
-         // Send a shutdown signal
-         beast::error_code ec;
-         socket_.shutdown(Socket::shutdown_both, ec);
-         socket_.close(ec);
-         // At this point the connection is closed gracefully
-      } catch(...) {
-         handle_exception();
-      }
+      closed_ = true;
+      read_done_ = true;
+      // Send a shutdown signal
+      beast::error_code ec;
+      socket_.shutdown(Socket::shutdown_both, ec);
+      socket_.close(ec);
+      // At this point the connection is closed gracefully
    }
 
 
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <fc/exception/exception.hpp>
+#include <fc/io/json.hpp>
+#include <fc/time.hpp>
+#include <fc/variant.hpp>
+#include <fc/variant_object.hpp>
+
+#include <string>
+#include <vector>
+
+namespace eosio {
+
+/**
+ * Writes the JSON text of a fc::variant in pieces of about chunk_size bytes, so that a large result can be sent with
+ * chunked transfer encoding without materializing the whole string.
+ *
+ * Objects and arrays above max_depth are written member by member; values at max_depth (e.g. a row of get_table_rows
+ * or a transaction of get_block) are written whole. The output is identical to fc::json::to_string of the value.
+ */
+class chunked_json_writer {
+public:
+   static constexpr size_t   default_chunk_size = 64 * 1024;
+   static constexpr uint32_t max_depth = 2;
+
+   explicit chunked_json_writer(fc::variant v, size_t chunk_size = default_chunk_size)
+      : value_(std::move(v)), chunk_size_(chunk_size) {}
+
+   /// replaces chunk with the next piece of JSON text, deadline only applies to this piece
+   /// @return false once the last piece has been written
+   bool next(std::string& chunk, const fc::time_point& deadline) {
+      chunk.clear();
+      if (!started_) {
+         started_ = true;
+         open(value_, chunk, deadline);
+      }
+      while (!stack_.empty() && chunk.size() < chunk_size_) {
+         frame& f = stack_.back();
+         if (f.value->is_object()) {
+            const auto& obj = f.value->get_object();
+            if (f.index == obj.size()) {
+               chunk += '}';
+               stack_.pop_back();
+               continue;
+            }
+            const auto& member = *(obj.begin() + f.index);
+            if (f.index++)
+               chunk += ',';
+            write(fc::variant(member.key()), chunk, deadline);
+            chunk += ':';
+            open(member.value(), chunk, deadline); // invalidates f
+         } else {
+            const auto& arr = f.value->get_array();
+            if (f.index == arr.size()) {
+               chunk += ']';
+               stack_.pop_back();
+               continue;
+            }
+            if (f.index)
+               chunk += ',';
+            open(arr[f.index++], chunk, deadline); // invalidates f
+         }
+      }
+      return !stack_.empty();
+   }
+
+private:
+   struct frame {
+      const fc::variant* value;
+      size_t             index = 0; // next member or element to write
+   };
+
+   // write v whole, or its opening bracket if its members are to be written one by one
+   void open(const fc::variant& v, std::string& chunk, const fc::time_point& deadline) {
+      if (stack_.size() < max_depth && (v.is_object() || v.is_array())) {
+         chunk += v.is_object() ? '{' : '[';
+         stack_.push_back(frame{&v});
+      } else {
+         write(v, chunk, deadline);
+      }
+   }
+
+   static void write(const fc::variant& v, std::string& chunk, const fc::time_point& deadline) {
+      chunk += fc::json::to_string(v, [&](size_t) { FC_CHECK_DEADLINE(deadline); });
+   }
+
+   fc::variant        value_;
+   size_t             chunk_size_;
+   bool               started_ = false;
+   std::vector<frame> stack_;
+};
+
+} // namespace eosio
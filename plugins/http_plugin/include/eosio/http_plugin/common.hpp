@@ -1,7 +1,9 @@
 #pragma once
 
 #include <eosio/chain/thread_utils.hpp>// for thread pool
+#include <eosio/http_plugin/chunked_json_writer.hpp>
 #include <eosio/http_plugin/http_plugin.hpp>
+#include <eosio/http_plugin/response_cache.hpp>
 
 #include <fc/io/raw.hpp>
 #include <fc/log/logger_config.hpp>
@@ -27,7 +29,9 @@
 #include <boost/asio/basic_stream_socket.hpp>
 #include <boost/asio/detail/config.hpp>
 
+#include <algorithm>
 #include <atomic>
+#include <limits>
 #include <map>
 #include <optional>
 #include <regex>
@@ -51,6 +55,11 @@ using boost::asio::ip::tcp;// from <boost/asio/ip/tcp.hpp>
 
 
 namespace detail {
+/**
+* produces the next piece of a chunked response body, returns false with the last piece
+*/
+using chunk_producer = stream_producer;
+
 /**
 * virtualized wrapper for the various underlying connection functions needed in req/resp processng
 */
@@ -62,6 +71,13 @@ struct abstract_conn {
    virtual void handle_exception() = 0;
 
    virtual void send_response(std::string&& json_body, unsigned int code) = 0;
+   virtual void send_response(response_cache::entry_ptr cached, unsigned int code) = 0;
+
+   // false if the client can not receive a chunked transfer encoding, e.g. HTTP/1.0
+   virtual bool allow_chunked_response() const = 0;
+   // next is called from an http thread for each chunk while the previous one is being written,
+   // content_type replaces the content type of the handler if not empty
+   virtual void send_chunked_response(chunk_producer next, unsigned int code, std::string content_type = {}) = 0;
 };
 
 using abstract_conn_ptr = std::shared_ptr<abstract_conn>;
@@ -74,6 +90,15 @@ struct internal_url_handler {
    internal_url_handler_fn fn;
    api_category category;
    http_content_type content_type = http_content_type::json;
+   bool cacheable = false;
+};
+
+/**
+* identifies where the response to a cacheable request is stored in http_plugin_state::response_cache
+*/
+struct response_cache_key {
+   std::string key;
+   uint64_t    generation = 0;
 };
 /**
 * Helper method to calculate the "in flight" size of a fc::variant
@@ -134,33 +159,117 @@ struct http_plugin_state {
    struct http; // http is a namespace so use an embedded type for the named_thread_pool tag
    eosio::chain::named_thread_pool<http> thread_pool;
 
+   /**
+   * Optional dedicated thread pool and in-flight limit of a single api_category. The thread pool runs the async
+   * handlers, the http thread stage of the *_POST calls and the response serialization of the category. Handlers
+   * posted to an appbase exec_queue, which includes all of chain_ro, run on the application threads regardless, so
+   * only the in-flight limit keeps slow requests of one category (e.g. get_table_rows of chain_ro) from crowding out
+   * another (e.g. get_info).
+   */
+   struct category_executor {
+      uint16_t thread_pool_size = 0;        // 0 to share thread_pool
+      int32_t max_requests_in_flight = -1;  // -1 for unlimited
+      std::atomic<int32_t> requests_in_flight{0};
+      struct httpc;
+      eosio::chain::named_thread_pool<httpc> thread_pool;
+
+      /// thread safe, reserve an in-flight slot for a request of this category, false if none available
+      bool try_admit() {
+         auto n = requests_in_flight.load();
+         do {
+            if (max_requests_in_flight >= 0 && n >= max_requests_in_flight)
+               return false;
+         } while (!requests_in_flight.compare_exchange_weak(n, n + 1));
+         return true;
+      }
+
+      /// thread safe, release a slot reserved by try_admit()
+      void release() { --requests_in_flight; }
+   };
+   std::map<api_category, std::unique_ptr<category_executor>> category_executors;
+
+   // maximum number of requests read ahead of their responses on a single connection, 1 disables pipelining
+   uint16_t max_pipelined_requests = 1;
+
+   eosio::response_cache response_cache;
+
+   // json responses estimated at this size or larger are streamed with chunked transfer encoding, 0 to disable
+   size_t chunked_response_min_size = 0;
+
    fc::logger& logger;
    std::function<void(http_plugin::metrics)> update_metrics;
 
    fc::logger& get_logger() { return logger; }
 
+   category_executor* find_category_executor(api_category category) {
+      auto itr = category_executors.find(category);
+      return itr == category_executors.end() ? nullptr : itr->second.get();
+   }
+
+   /// io_context on which to run http thread work of the given category
+   boost::asio::io_context& executor_for(api_category category) {
+      if (auto* ce = find_category_executor(category); ce && ce->thread_pool_size > 0)
+         return ce->thread_pool.get_executor();
+      return thread_pool.get_executor();
+   }
+
    explicit http_plugin_state(fc::logger& log)
        : logger(log) {}
 
 };
 
+/**
+* Bytes counted in http_plugin_state::bytes_in_flight, given back at most once: in parts by release(n), all of what is left
+* by release(), or on destruction
+*/
+class in_flight_bytes {
+public:
+   in_flight_bytes(std::atomic<size_t>& counter, size_t size)
+      : counter_(counter), remaining_(size) {}
+   ~in_flight_bytes() { release(); }
+
+   in_flight_bytes(const in_flight_bytes&) = delete;
+   in_flight_bytes& operator=(const in_flight_bytes&) = delete;
+
+   /// thread safe, gives back up to n of the bytes not yet given back
+   void release(size_t n) {
+      size_t remaining = remaining_.load();
+      size_t give = 0;
+      do {
+         give = std::min(remaining, n);
+      } while (give && !remaining_.compare_exchange_weak(remaining, remaining - give));
+      counter_ -= give;
+   }
+
+   /// thread safe
+   void release() { release(std::numeric_limits<size_t>::max()); }
+
+private:
+   std::atomic<size_t>& counter_;
+   std::atomic<size_t>  remaining_;
+};
+
 /**
 * Construct a lambda appropriate for url_response_callback that will
 * JSON-stringify the provided response
 *
 * @param plugin_state - plugin state object, shared state of http_plugin
 * @param session_ptr - beast_http_session object on which to invoke send_response
+* @param category - api_category of the request, selects the thread pool the response is serialized on
+* @param cache_key - if provided, a successful response is stored in the response cache under this key
 * @return lambda suitable for url_response_callback
 */
-inline auto make_http_response_handler(http_plugin_state& plugin_state, detail::abstract_conn_ptr session_ptr, http_content_type content_type) {
+inline auto make_http_response_handler(http_plugin_state& plugin_state, detail::abstract_conn_ptr session_ptr, http_content_type content_type,
+                                       api_category category, std::optional<response_cache_key> cache_key = {}) {
    return [&plugin_state,
-           session_ptr{std::move(session_ptr)}, content_type](int code, std::optional<fc::variant> response) mutable {
+           session_ptr{std::move(session_ptr)}, content_type, category, cache_key{std::move(cache_key)}](int code, std::optional<fc::variant> response) mutable {
       auto payload_size = detail::in_flight_sizeof(response);
       plugin_state.bytes_in_flight += payload_size;
 
       // post back to an HTTP thread to allow the response handler to be called from any thread
-      boost::asio::dispatch(plugin_state.thread_pool.get_executor(),
-                        [&plugin_state, session_ptr{std::move(session_ptr)}, code, payload_size, response = std::move(response), content_type]() {
+      boost::asio::dispatch(plugin_state.executor_for(category),
+                        [&plugin_state, session_ptr{std::move(session_ptr)}, code, payload_size, response = std::move(response), content_type,
+                         cache_key{std::move(cache_key)}]() mutable {
                            auto on_exit = fc::scoped_exit<std::function<void()>>([&](){plugin_state.bytes_in_flight -= payload_size;});
 
                            if(auto error_str = session_ptr->verify_max_bytes_in_flight(0); !error_str.empty()) {
@@ -170,11 +279,32 @@ inline auto make_http_response_handler(http_plugin_state& plugin_state, detail::
 
                            try {
                               if (response.has_value()) {
+                                 if (content_type == http_content_type::json && !cache_key && plugin_state.chunked_response_min_size > 0 &&
+                                     payload_size >= plugin_state.chunked_response_min_size && session_ptr->allow_chunked_response()) {
+                                    // write the json text piece by piece instead of building the whole string up front
+                                    auto writer = std::make_shared<chunked_json_writer>(std::move(*response));
+                                    // the session counts every chunk in flight, so the estimated size of the response is
+                                    // handed over to the chunks as they are produced rather than counted twice; what is
+                                    // left is given back after the last chunk, or when the producer is dropped
+                                    auto in_flight = std::make_shared<in_flight_bytes>(plugin_state.bytes_in_flight, payload_size);
+                                    on_exit.cancel();
+                                    session_ptr->send_chunked_response([&plugin_state, writer, in_flight](std::string& chunk) {
+                                       bool more = writer->next(chunk, fc::time_point::now().safe_add(plugin_state.max_response_time));
+                                       if (more)
+                                          in_flight->release(chunk.size());
+                                       else
+                                          in_flight->release();
+                                       return more;
+                                    }, code);
+                                    return;
+                                 }
                                  std::string json = (content_type == http_content_type::plaintext) ? response->as_string() : fc::json::to_string(*response, fc::time_point::maximum());
-                                 if (auto error_str = session_ptr->verify_max_bytes_in_flight(json.size()); error_str.empty())
-                                    session_ptr->send_response(std::move(json), code);
-                                 else
+                                 if (auto error_str = session_ptr->verify_max_bytes_in_flight(json.size()); !error_str.empty())
                                     session_ptr->send_busy_response(std::move(error_str));
+                                 else if (cache_key && code == 200)
+                                    session_ptr->send_response(plugin_state.response_cache.store(cache_key->key, cache_key->generation, std::move(json)), code);
+                                 else
+                                    session_ptr->send_response(std::move(json), code);
                               } else {
                                  session_ptr->send_response("{}", code);
                               }
@@ -186,6 +316,31 @@ inline auto make_http_response_handler(http_plugin_state& plugin_state, detail::
 
 }
 
+// true if an Accept-Encoding header value allows a gzip encoded response, e.g. "gzip, deflate" or "gzip;q=0.8"
+inline bool accepts_gzip(beast::string_view accept_encoding) {
+   while(!accept_encoding.empty()) {
+      auto comma = accept_encoding.find(',');
+      auto coding = accept_encoding.substr(0, comma);
+      accept_encoding = comma == beast::string_view::npos ? beast::string_view{} : accept_encoding.substr(comma + 1);
+
+      auto params = coding.find(';');
+      auto name = coding.substr(0, params);
+      while(!name.empty() && name.front() == ' ') name.remove_prefix(1);
+      while(!name.empty() && name.back() == ' ') name.remove_suffix(1);
+      if(!beast::iequals(name, "gzip") && name != "*")
+         continue;
+      // "q=0" explicitly refuses the coding
+      if(params != beast::string_view::npos) {
+         auto q = coding.substr(params + 1);
+         while(!q.empty() && q.front() == ' ') q.remove_prefix(1);
+         if(q.starts_with("q=0") && q.find_first_not_of("0.", 2) == beast::string_view::npos)
+            continue;
+      }
+      return true;
+   }
+   return false;
+}
+
 inline bool host_is_valid(const http_plugin_state& plugin_state,
                    const std::string& header_host_port,
                    const asio::ip::address& addr) {
@@ -29,6 +29,34 @@ namespace eosio {
     **/
    using url_handler = std::function<void(string&&, string&&, url_response_callback&&)>;
 
+   /**
+    * @brief Produces the body of a streamed response piece by piece
+    *
+    * Called from an http thread for each piece, after the previous one has been written. Sets its argument to the
+    * next piece and returns false with the last one. A throw drops the connection, the status has already been sent.
+    */
+   using stream_producer = std::function<bool(std::string&)>;
+
+   /**
+    * @brief A callback function provided to a stream handler to start a streamed response
+    *
+    * The body is sent with chunked transfer encoding as stream_producer produces it, so its size is not bounded by
+    * the memory of the node.
+    *
+    * Arguments: response_code, content_type (e.g. "application/x-ndjson"), producer of the body
+    */
+   using url_stream_callback = std::function<void(int, std::string, stream_producer)>;
+
+   /**
+    * @brief Callback type for a URL handler with a streamed response
+    *
+    * The handler must call exactly one of url_response_callback(), e.g. to report a bad request, or
+    * url_stream_callback().
+    *
+    * Arguments: url, request_body, response_callback, stream_callback
+    **/
+   using url_stream_handler = std::function<void(string&&, string&&, url_response_callback&&, url_stream_callback&&)>;
+
    /**
     * @brief An API, containing URLs and handlers
     *
@@ -40,6 +68,7 @@ namespace eosio {
       string path;
       api_category category;
       url_handler handler;
+      bool cacheable = false; ///< idempotent for a given head block, see http-response-cache-ms
    };
 
    using api_description = std::vector<api_entry>;
@@ -106,10 +135,18 @@ namespace eosio {
               add_async_handler(std::move(call), content_type);
         }
 
+        /**
+         * Add a handler, called on an http thread like the handlers of add_async_handler, which may answer with a
+         * streamed response. Clients that can not receive chunked transfer encoding (HTTP/1.0) get a 400 instead.
+         */
+        void add_async_stream_handler(string path, api_category category, url_stream_handler handler);
+
         // standard exception handling for api handlers
         static void handle_exception( const char *api_name, const char *call_name, const string& body, const url_response_callback& cb );
 
         void post_http_thread_pool(std::function<void()> f);
+        // post to the thread pool configured for category via http-category-threads, the shared pool otherwise
+        void post_http_thread_pool(std::function<void()> f, api_category category);
 
         bool is_on_loopback(api_category category) const;
 
@@ -126,10 +163,15 @@ namespace eosio {
 
         struct metrics {
            std::string target;
+           bool        cacheable = false; ///< target may be served from the response cache
+           bool        cache_hit = false;
         };
 
         void register_update_metrics(std::function<void(metrics)>&& fun);
 
+        /// drop all cached responses, call on any state change visible to cacheable endpoints (e.g. new head or LIB)
+        void invalidate_response_cache();
+
         std::atomic<bool>& listening();
    private:
         std::shared_ptr<class http_plugin_impl> my;
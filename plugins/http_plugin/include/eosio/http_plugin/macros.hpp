@@ -35,7 +35,7 @@
                     } else {                                                                                    \
                        cb(resp_code, fc::variant(std::get<call_result>(std::move(result))));                    \
                     }                                                                                           \
-                 });                                                                                            \
+                 }, api_category::category);                                                                    \
               }                                                                                                 \
            });                                                                                                  \
      } catch (...) {                                                                                            \
@@ -75,7 +75,7 @@
                 } catch (...) {                                                                                 \
                    http_plugin::handle_exception(#api_name, #call_name, body, cb);                              \
                 }                                                                                               \
-             });                                                                                                \
+             }, api_category::category);                                                                        \
           } catch (...) {                                                                                       \
              http_plugin::handle_exception(#api_name, #call_name, body, cb);                                    \
           }                                                                                                     \
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <fc/compress/zlib.hpp>
+#include <fc/mutex.hpp>
+#include <fc/time.hpp>
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+namespace eosio {
+
+/**
+ * Serialized response bodies of idempotent endpoints, keyed by url and request body.
+ *
+ * Entries are only valid for the generation they were computed in. The generation is advanced by
+ * http_plugin::invalidate_response_cache() (e.g. on new head or LIB), which drops all entries, and each
+ * entry also expires after a short ttl. The gzip encoding of a body is computed once when the entry is
+ * stored so that a burst of identical requests costs a single serialization and compression.
+ */
+class response_cache {
+public:
+   struct entry {
+      std::string      json;
+      std::string      gzip;    // empty if the body is below the compression threshold
+      fc::time_point   expires;
+   };
+   using entry_ptr = std::shared_ptr<const entry>;
+
+   static constexpr size_t max_entries = 1024;
+
+   void configure(fc::microseconds ttl, size_t compress_min_size) {
+      ttl_               = ttl;
+      compress_min_size_ = compress_min_size;
+   }
+
+   bool enabled() const { return ttl_ > fc::microseconds(); }
+
+   /// thread safe, size below which a response body is not worth compressing; 0 disables compression
+   size_t compress_min_size() const { return compress_min_size_; }
+
+   /// thread safe, generation to record with a request so its response is not stored after an invalidation
+   uint64_t generation() const { return generation_.load(std::memory_order_acquire); }
+
+   /// thread safe
+   void invalidate() {
+      fc::lock_guard g(mtx_);
+      ++generation_;
+      entries_.clear();
+   }
+
+   /// thread safe, returns nullptr if no valid entry exists
+   entry_ptr find(const std::string& key) {
+      fc::lock_guard g(mtx_);
+      auto itr = entries_.find(key);
+      if (itr == entries_.end())
+         return {};
+      if (itr->second->expires < fc::time_point::now()) {
+         entries_.erase(itr);
+         return {};
+      }
+      return itr->second;
+   }
+
+   /// thread safe, stores json for key unless the cache has been invalidated since generation
+   entry_ptr store(const std::string& key, uint64_t generation, std::string json) {
+      auto e = std::make_shared<entry>();
+      if (compress_min_size_ && json.size() >= compress_min_size_)
+         e->gzip = fc::gzip_compress(json);
+      e->json    = std::move(json);
+      e->expires = fc::time_point::now().safe_add(ttl_);
+
+      fc::lock_guard g(mtx_);
+      if (generation != generation_.load(std::memory_order_relaxed))
+         return e;
+      if (entries_.size() >= max_entries) {
+         const auto now = fc::time_point::now();
+         std::erase_if(entries_, [&](const auto& i) { return i.second->expires < now; });
+         if (entries_.size() >= max_entries)
+            return e;
+      }
+      entries_.insert_or_assign(key, e);
+      return e;
+   }
+
+private:
+   fc::microseconds      ttl_;
+   size_t                compress_min_size_ = 0;
+   std::atomic<uint64_t> generation_{0};
+
+   fc::mutex                                  mtx_;
+   std::unordered_map<std::string, entry_ptr> entries_ GUARDED_BY(mtx_);
+};
+
+} // namespace eosio
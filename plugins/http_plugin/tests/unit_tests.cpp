@@ -9,6 +9,9 @@
 
 #include <boost/asio/basic_stream_socket.hpp>
 #include <boost/asio/local/stream_protocol.hpp>
+#include <boost/iostreams/filtering_stream.hpp>
+#include <boost/iostreams/device/back_inserter.hpp>
+#include <boost/iostreams/filter/gzip.hpp>
 #include <fc/scoped_exit.hpp>
 #include <fc/crypto/rand.hpp>
 
@@ -716,5 +719,320 @@ BOOST_FIXTURE_TEST_CASE(requests_in_flight, http_plugin_test_fixture) {
    connections.clear();
 }
 
+BOOST_FIXTURE_TEST_CASE(response_cache_and_compression, http_plugin_test_fixture) {
+   http_plugin* http_plugin = init({"--plugin=eosio::http_plugin",
+                                    "--http-server-address=127.0.0.1:8893",
+                                    "--http-response-cache-ms=60000",
+                                    "--http-compression-min-size=64"});
+   BOOST_REQUIRE(http_plugin);
+
+   std::atomic<uint32_t> calls = 0;
+   const std::string long_str(1024, 'a');
+   api_entry entry{std::string("/cached"), api_category::node,
+                   [&](string&&, string&& body, url_response_callback&& cb) {
+                      ++calls;
+                      cb(200, fc::variant(long_str + body));
+                   }};
+   entry.cacheable = true;
+   http_plugin->add_api({std::move(entry)}, appbase::exec_queue::read_write);
+
+   boost::asio::io_context ctx;
+   boost::asio::ip::tcp::resolver resolver(ctx);
+   boost::asio::ip::tcp::socket s(ctx, boost::asio::ip::tcp::v4());
+   boost::asio::connect(s, resolver.resolve("127.0.0.1", "8893"));
+
+   auto request = [&](const std::string& body, bool gzip) {
+      http::request<http::string_body> req(http::verb::post, "/cached", 11);
+      req.keep_alive(true);
+      req.set(http::field::host, "127.0.0.1:8893");
+      if (gzip)
+         req.set(http::field::accept_encoding, "deflate, gzip;q=0.8");
+      req.body() = body;
+      req.prepare_payload();
+      http::write(s, req);
+
+      http::response<http::string_body> resp;
+      beast::flat_buffer buffer;
+      http::read(s, buffer, resp);
+      BOOST_REQUIRE(resp.result() == http::status::ok);
+      BOOST_REQUIRE_EQUAL(resp[http::field::content_encoding] == "gzip", gzip);
+      if (!gzip)
+         return resp.body();
+
+      std::string decompressed;
+      boost::iostreams::filtering_ostream decomp;
+      decomp.push(boost::iostreams::gzip_decompressor());
+      decomp.push(boost::iostreams::back_inserter(decompressed));
+      boost::iostreams::write(decomp, resp.body().data(), resp.body().size());
+      boost::iostreams::close(decomp);
+      return decompressed;
+   };
+
+   const std::string expected = fc::json::to_string(fc::variant(long_str + "x"), fc::time_point::maximum());
+   BOOST_CHECK_EQUAL(request("x", false), expected);
+   BOOST_CHECK_EQUAL(request("x", true), expected);
+   BOOST_CHECK_EQUAL(calls.load(), 1u);
+
+   // different body is a different cache entry
+   request("y", true);
+   BOOST_CHECK_EQUAL(calls.load(), 2u);
+
+   http_plugin->invalidate_response_cache();
+   BOOST_CHECK_EQUAL(request("x", true), expected);
+   BOOST_CHECK_EQUAL(calls.load(), 3u);
+}
+
+BOOST_FIXTURE_TEST_CASE(pipelined_requests, http_plugin_test_fixture) {
+   http_plugin* http_plugin = init({"--plugin=eosio::http_plugin",
+                                    "--http-server-address=127.0.0.1:8894",
+                                    "--http-max-pipelined-requests=4",
+                                    "--http-category-threads=node,2",
+                                    "--http-category-threads=chain_ro,1",
+                                    "--http-category-max-in-flight=chain_ro,1"});
+   BOOST_REQUIRE(http_plugin);
+
+   std::promise<void> entered;
+   std::promise<void> release;
+   std::shared_future<void> released = release.get_future().share();
+   std::atomic<bool> first_call = true;
+   http_plugin->add_async_api({
+      {std::string("/sleep"), api_category::node,
+       [](string&&, string&& body, url_response_callback&& cb) {
+          std::this_thread::sleep_for(std::chrono::milliseconds(std::stoi(body)));
+          cb(200, fc::variant(body));
+       }},
+      {std::string("/v1/chain/slow"), api_category::chain_ro,
+       [&](string&&, string&& body, url_response_callback&& cb) {
+          if (first_call.exchange(false))
+             entered.set_value();
+          released.wait();
+          cb(200, fc::variant(body));
+       }}});
+
+   boost::asio::io_context ctx;
+   boost::asio::ip::tcp::resolver resolver(ctx);
+   auto connect = [&](boost::asio::ip::tcp::socket& s) {
+      boost::asio::connect(s, resolver.resolve("127.0.0.1", "8894"));
+   };
+   auto send = [&](boost::asio::ip::tcp::socket& s, const char* target, const std::string& body) {
+      http::request<http::string_body> req(http::verb::post, target, 11);
+      req.keep_alive(true);
+      req.set(http::field::host, "127.0.0.1:8894");
+      req.body() = body;
+      req.prepare_payload();
+      http::write(s, req);
+   };
+   auto receive = [&](boost::asio::ip::tcp::socket& s, beast::flat_buffer& buffer) {
+      http::response<http::string_body> resp;
+      http::read(s, buffer, resp);
+      return resp;
+   };
+
+   // responses are returned in request order even though the later requests complete first
+   {
+      boost::asio::ip::tcp::socket s(ctx, boost::asio::ip::tcp::v4());
+      connect(s);
+      send(s, "/sleep", "300");
+      send(s, "/sleep", "100");
+      send(s, "/sleep", "0");
+      beast::flat_buffer buffer;
+      for (const char* expected : {"\"300\"", "\"100\"", "\"0\""}) {
+         auto resp = receive(s, buffer);
+         BOOST_REQUIRE(resp.result() == http::status::ok);
+         BOOST_CHECK_EQUAL(resp.body(), expected);
+      }
+   }
+
+   // a request over the in-flight limit of its category is rejected while other categories are still served
+   boost::asio::ip::tcp::socket slow(ctx, boost::asio::ip::tcp::v4());
+   boost::asio::ip::tcp::socket rejected(ctx, boost::asio::ip::tcp::v4());
+   connect(slow);
+   connect(rejected);
+   beast::flat_buffer slow_buffer, rejected_buffer;
+
+   send(slow, "/v1/chain/slow", "a");
+   entered.get_future().wait();
+
+   send(rejected, "/v1/chain/slow", "b");
+   BOOST_CHECK(receive(rejected, rejected_buffer).result() == http::status::service_unavailable);
+   send(rejected, "/sleep", "0");
+   BOOST_CHECK(receive(rejected, rejected_buffer).result() == http::status::ok);
+
+   release.set_value();
+   BOOST_CHECK(receive(slow, slow_buffer).result() == http::status::ok);
+   send(rejected, "/v1/chain/slow", "c");
+   BOOST_CHECK(receive(rejected, rejected_buffer).result() == http::status::ok);
+}
+
+BOOST_AUTO_TEST_CASE(chunked_json_writer_output) {
+   fc::mutable_variant_object row;
+   row("id", 7)("name", "a \"quoted\" name")("values", fc::variants{1, 2, fc::variants{3}});
+   fc::variants rows(100, fc::variant(row));
+   fc::mutable_variant_object result;
+   result("rows", rows)("more", true)("next_key", "")("empty", fc::variants{})("nested", fc::mutable_variant_object("a", fc::mutable_variant_object()));
+
+   for (const fc::variant& v : {fc::variant(result), fc::variant(rows), fc::variant("scalar"), fc::variant(fc::variants{})}) {
+      const std::string expected = fc::json::to_string(v, fc::time_point::maximum());
+      for (size_t chunk_size : {1u, 64u, 1024u * 1024u}) {
+         chunked_json_writer writer(v, chunk_size);
+         std::string out, chunk;
+         size_t chunks = 0;
+         bool more = true;
+         while (more) {
+            more = writer.next(chunk, fc::time_point::maximum());
+            out += chunk;
+            ++chunks;
+         }
+         BOOST_CHECK_EQUAL(out, expected);
+         if (chunk_size == 64u && v.is_object())
+            BOOST_CHECK_GT(chunks, 10u);
+      }
+   }
+}
+
+BOOST_AUTO_TEST_CASE(in_flight_bytes_released_once) {
+   std::atomic<size_t> counter{100};
+   {
+      in_flight_bytes bytes(counter, 40);
+      bytes.release();
+      BOOST_CHECK_EQUAL(counter.load(), 60u);
+      bytes.release();
+      BOOST_CHECK_EQUAL(counter.load(), 60u);
+   }
+   BOOST_CHECK_EQUAL(counter.load(), 60u);
+   {
+      in_flight_bytes bytes(counter, 10);
+   }
+   BOOST_CHECK_EQUAL(counter.load(), 50u);
+   {
+      // given back in parts, never more than was counted
+      in_flight_bytes bytes(counter, 30);
+      bytes.release(20);
+      BOOST_CHECK_EQUAL(counter.load(), 30u);
+      bytes.release(20);
+      BOOST_CHECK_EQUAL(counter.load(), 20u);
+      bytes.release();
+      BOOST_CHECK_EQUAL(counter.load(), 20u);
+   }
+   BOOST_CHECK_EQUAL(counter.load(), 20u);
+}
+
+BOOST_FIXTURE_TEST_CASE(chunked_response, http_plugin_test_fixture) {
+   http_plugin* http_plugin = init({"--plugin=eosio::http_plugin",
+                                    "--http-server-address=127.0.0.1:8895",
+                                    "--http-chunked-response-min-size=4096"});
+   BOOST_REQUIRE(http_plugin);
+
+   fc::variants rows;
+   for (uint32_t i = 0; i < 10000; ++i)
+      rows.emplace_back(fc::mutable_variant_object("id", i)("value", std::string(32, 'a' + i % 26)));
+   const fc::variant large = fc::mutable_variant_object("rows", rows)("more", false);
+   http_plugin->add_api({{std::string("/small"), api_category::node,
+                          [&](string&&, string&& body, url_response_callback&& cb) {
+                             cb(200, fc::variant("small"));
+                          }},
+                         {std::string("/large"), api_category::node,
+                          [&](string&&, string&& body, url_response_callback&& cb) {
+                             cb(200, large);
+                          }}}, appbase::exec_queue::read_write);
+
+   boost::asio::io_context ctx;
+   boost::asio::ip::tcp::resolver resolver(ctx);
+   boost::asio::ip::tcp::socket s(ctx, boost::asio::ip::tcp::v4());
+   boost::asio::connect(s, resolver.resolve("127.0.0.1", "8895"));
+   beast::flat_buffer buffer;
+
+   auto request = [&](const char* target, unsigned version) {
+      http::request<http::empty_body> req(http::verb::get, target, version);
+      req.keep_alive(true);
+      req.set(http::field::host, "127.0.0.1:8895");
+      http::write(s, req);
+
+      http::response<http::string_body> resp;
+      http::read(s, buffer, resp);
+      BOOST_REQUIRE(resp.result() == http::status::ok);
+      return resp;
+   };
+
+   auto resp = request("/large", 11);
+   BOOST_CHECK(resp.chunked());
+   BOOST_CHECK_EQUAL(resp.body(), fc::json::to_string(large, fc::time_point::maximum()));
+
+   // connection is still usable after a chunked response
+   resp = request("/small", 11);
+   BOOST_CHECK(!resp.chunked());
+   BOOST_CHECK_EQUAL(resp.body(), "\"small\"");
+
+   // HTTP/1.0 clients do not understand chunked responses
+   resp = request("/large", 10);
+   BOOST_CHECK(!resp.chunked());
+   BOOST_CHECK_EQUAL(resp.body(), fc::json::to_string(large, fc::time_point::maximum()));
+}
+
+BOOST_FIXTURE_TEST_CASE(stream_handler, http_plugin_test_fixture) {
+   http_plugin* http_plugin = init({"--plugin=eosio::http_plugin",
+                                    "--http-server-address=127.0.0.1:8896"});
+   BOOST_REQUIRE(http_plugin);
+
+   http_plugin->add_async_stream_handler("/lines", api_category::node,
+                                         [](string&&, string&& body, url_response_callback&& cb, url_stream_callback&& stream) {
+      if (body.empty()) {
+         cb(400, fc::variant("missing count"));
+         return;
+      }
+      auto remaining = std::make_shared<uint32_t>(std::stoul(body));
+      stream(200, "application/x-ndjson", [remaining](std::string& chunk) {
+         chunk = std::to_string(*remaining) + "\n";
+         return --*remaining > 0;
+      });
+   });
+
+   boost::asio::io_context ctx;
+   boost::asio::ip::tcp::resolver resolver(ctx);
+   boost::asio::ip::tcp::socket s(ctx, boost::asio::ip::tcp::v4());
+   boost::asio::connect(s, resolver.resolve("127.0.0.1", "8896"));
+   beast::flat_buffer buffer;
+
+   auto request = [&](std::string body, unsigned version) {
+      http::request<http::string_body> req(http::verb::post, "/lines", version);
+      req.keep_alive(true);
+      req.set(http::field::host, "127.0.0.1:8896");
+      req.body() = std::move(body);
+      req.prepare_payload();
+      http::write(s, req);
+
+      http::response<http::string_body> resp;
+      http::read(s, buffer, resp);
+      return resp;
+   };
+
+   auto resp = request("3", 11);
+   BOOST_REQUIRE(resp.result() == http::status::ok);
+   BOOST_CHECK(resp.chunked());
+   BOOST_CHECK_EQUAL(resp[http::field::content_type], "application/x-ndjson");
+   BOOST_CHECK_EQUAL(resp.body(), "3\n2\n1\n");
+
+   // errors are answered through the response callback
+   resp = request("", 11);
+   BOOST_CHECK(resp.result() == http::status::bad_request);
+   BOOST_CHECK(!resp.chunked());
+
+   // HTTP/1.0 clients can not receive a streamed response
+   resp = request("3", 10);
+   BOOST_CHECK(resp.result() == http::status::bad_request);
+   BOOST_CHECK(!resp.chunked());
+}
+
+BOOST_AUTO_TEST_CASE(accept_encoding_gzip) {
+   BOOST_CHECK(accepts_gzip("gzip"));
+   BOOST_CHECK(accepts_gzip("deflate, gzip"));
+   BOOST_CHECK(accepts_gzip("GZIP;q=0.5"));
+   BOOST_CHECK(accepts_gzip("*"));
+   BOOST_CHECK(!accepts_gzip(""));
+   BOOST_CHECK(!accepts_gzip("deflate, br"));
+   BOOST_CHECK(!accepts_gzip("gzip;q=0"));
+   BOOST_CHECK(!accepts_gzip("gzip; q=0.0"));
+}
+
 //A warning for future tests: destruction of http_plugin_test_fixture sometimes does not destroy http_plugin's listeners. Tests
 // added in the future should avoid reusing ports of other tests in http_plugin_unit_tests.
\ No newline at end of file
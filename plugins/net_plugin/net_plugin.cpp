@@ -83,6 +83,8 @@ namespace eosio {
    using connection_ptr = std::shared_ptr<connection>;
    using connection_wptr = std::weak_ptr<connection>;
 
+   using send_buffer_type = std::shared_ptr<std::vector<char>>;
+
    static constexpr int64_t block_interval_ns =
       std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::milliseconds(config::block_interval_ms)).count();
 
@@ -147,6 +149,23 @@ namespace eosio {
       >
       > peer_block_state_index;
 
+   /// framed bytes of a block or transaction as received from a peer, relayed as-is instead of re-serialized
+   template<typename Id>
+   struct received_buffer_state {
+      Id               id;
+      uint32_t         expiry = 0;   // block num for blocks, expiration in seconds since epoch for transactions
+      send_buffer_type buffer;
+   };
+
+   template<typename Id>
+   using received_buffer_index = multi_index_container<
+      received_buffer_state<Id>,
+      indexed_by<
+         ordered_unique< tag<by_id>, member<received_buffer_state<Id>, Id, &received_buffer_state<Id>::id>, sha256_less >,
+         ordered_non_unique< tag<by_expiry>, member<received_buffer_state<Id>, uint32_t, &received_buffer_state<Id>::expiry> >
+      >
+   >;
+
    struct unlinkable_block_state {
       block_id_type    id;
       signed_block_ptr block;
@@ -281,8 +300,16 @@ namespace eosio {
       mutable fc::mutex      local_txns_mtx;
       node_transaction_index  local_txns GUARDED_BY(local_txns_mtx);
 
+      alignas(hardware_destructive_interference_size)
+      mutable fc::mutex                            recv_buffers_mtx;
+      received_buffer_index<block_id_type>         recv_blk_buffers GUARDED_BY(recv_buffers_mtx);
+      received_buffer_index<transaction_id_type>   recv_trx_buffers GUARDED_BY(recv_buffers_mtx);
+
       unlinkable_block_state_cache unlinkable_block_cache;
 
+      template<typename Index, typename Id>
+      send_buffer_type take_recv_buffer( Index& index, const Id& id );
+
    public:
       boost::asio::io_context::strand  strand;
 
@@ -310,6 +337,10 @@ namespace eosio {
       bool have_txn( const transaction_id_type& tid ) const;
       void expire_txns();
 
+      void add_recv_block_buffer( const block_id_type& id, send_buffer_type sb );
+      void add_recv_trx_buffer( const transaction_id_type& id, const time_point_sec& trx_expires, send_buffer_type sb );
+      void drop_recv_trx_buffer( const transaction_id_type& id );
+
       void add_unlinkable_block( signed_block_ptr b, const block_id_type& id ) {
          std::optional<block_id_type> rm_blk_id = unlinkable_block_cache.add_unlinkable_block(std::move(b), id);
          if (rm_blk_id) {
@@ -993,6 +1024,7 @@ namespace eosio {
 
       bool process_next_block_message(uint32_t message_length);
       bool process_next_trx_message(uint32_t message_length);
+      send_buffer_type read_framed_message(uint32_t message_length);
       void update_endpoints(const tcp::endpoint& endpoint = tcp::endpoint());
    public:
 
@@ -1788,8 +1820,6 @@ namespace eosio {
 
    //------------------------------------------------------------------------
 
-   using send_buffer_type = std::shared_ptr<std::vector<char>>;
-
    struct buffer_factory {
 
       /// caches result for subsequent calls, only provide same net_message instance for each invocation
@@ -1840,6 +1870,11 @@ namespace eosio {
 
    struct block_buffer_factory : public buffer_factory {
 
+      block_buffer_factory() = default;
+
+      /// use already framed bytes, e.g. as received from a peer, if provided instead of serializing the block
+      explicit block_buffer_factory( send_buffer_type sb ) { send_buffer = std::move( sb ); }
+
       /// caches result for subsequent calls, only provide same signed_block_ptr instance for each invocation.
       const send_buffer_type& get_send_buffer( const signed_block_ptr& sb ) {
          if( !send_buffer ) {
@@ -1861,6 +1896,11 @@ namespace eosio {
 
    struct trx_buffer_factory : public buffer_factory {
 
+      trx_buffer_factory() = default;
+
+      /// use already framed bytes, e.g. as received from a peer, if provided instead of serializing the transaction
+      explicit trx_buffer_factory( send_buffer_type sb ) { send_buffer = std::move( sb ); }
+
       /// caches result for subsequent calls, only provide same packed_transaction_ptr instance for each invocation.
       const send_buffer_type& get_send_buffer( const packed_transaction_ptr& trx ) {
          if( !send_buffer ) {
@@ -2580,6 +2620,32 @@ namespace eosio {
       return added;
    }
 
+   template<typename Index, typename Id>
+   send_buffer_type dispatch_manager::take_recv_buffer( Index& index, const Id& id ) {
+      fc::lock_guard g( recv_buffers_mtx );
+      auto itr = index.find( id );
+      if( itr == index.end() )
+         return {};
+      send_buffer_type sb = itr->buffer;
+      index.erase( itr );
+      return sb;
+   }
+
+   void dispatch_manager::add_recv_block_buffer( const block_id_type& id, send_buffer_type sb ) {
+      fc::lock_guard g( recv_buffers_mtx );
+      recv_blk_buffers.insert( {id, block_header::num_from_id(id), std::move(sb)} ); // does not insert if already there
+   }
+
+   void dispatch_manager::add_recv_trx_buffer( const transaction_id_type& id, const time_point_sec& trx_expires, send_buffer_type sb ) {
+      fc::lock_guard g( recv_buffers_mtx );
+      recv_trx_buffers.insert( {id, trx_expires.sec_since_epoch(), std::move(sb)} ); // does not insert if already there
+   }
+
+   // called from any thread, the trx will not be relayed
+   void dispatch_manager::drop_recv_trx_buffer( const transaction_id_type& id ) {
+      take_recv_buffer( recv_trx_buffers, id );
+   }
+
    bool dispatch_manager::have_txn( const transaction_id_type& tid ) const {
       fc::lock_guard g( local_txns_mtx );
       const auto tptr = local_txns.get<by_id>().find( tid );
@@ -2598,12 +2664,24 @@ namespace eosio {
       old.erase( ex_lo, ex_up );
       g.unlock();
 
+      {
+         fc::lock_guard bg( recv_buffers_mtx );
+         auto& stale_buffers = recv_trx_buffers.get<by_expiry>();
+         stale_buffers.erase( stale_buffers.begin(), stale_buffers.upper_bound( now.sec_since_epoch() ) );
+      }
+
       fc_dlog( logger, "expire_local_txns size ${s} removed ${r}", ("s", start_size)( "r", start_size - end_size ) );
    }
 
    void dispatch_manager::expire_blocks( uint32_t lib_num ) {
       unlinkable_block_cache.expire_blocks( lib_num );
 
+      {
+         fc::lock_guard g( recv_buffers_mtx );
+         auto& stale_buffers = recv_blk_buffers.get<by_expiry>();
+         stale_buffers.erase( stale_buffers.begin(), stale_buffers.upper_bound( lib_num ) );
+      }
+
       fc::lock_guard g( blk_state_mtx );
       auto& stale_blk = blk_state.get<by_connection_id>();
       stale_blk.erase( stale_blk.lower_bound( 1 ), stale_blk.upper_bound( lib_num ) );
@@ -2613,9 +2691,10 @@ namespace eosio {
    void dispatch_manager::bcast_block(const signed_block_ptr& b, const block_id_type& id) {
       fc_dlog( logger, "bcast block ${b}", ("b", b->block_num()) );
 
+      block_buffer_factory buff_factory( take_recv_buffer( recv_blk_buffers, id ) );
+
       if(my_impl->sync_master->syncing_from_peer() ) return;
 
-      block_buffer_factory buff_factory;
       const auto bnum = b->block_num();
       my_impl->connections.for_each_block_connection( [this, &id, &bnum, &b, &buff_factory]( auto& cp ) {
          fc_dlog( logger, "socket_is_open ${s}, state ${c}, syncing ${ss}, connection ${cid}",
@@ -2659,11 +2738,12 @@ namespace eosio {
 
    void dispatch_manager::rejected_block(const block_id_type& id) {
       fc_dlog( logger, "rejected block ${id}", ("id", id) );
+      take_recv_buffer( recv_blk_buffers, id );
    }
 
    // called from any thread
    void dispatch_manager::bcast_transaction(const packed_transaction_ptr& trx) {
-      trx_buffer_factory buff_factory;
+      trx_buffer_factory buff_factory( take_recv_buffer( recv_trx_buffers, trx->id() ) );
       const fc::time_point_sec now{fc::time_point::now()};
       my_impl->connections.for_each_connection( [this, &trx, &now, &buff_factory]( const connection_ptr& cp ) {
          if( !cp->is_transactions_connection() || !cp->current() ) {
@@ -2684,6 +2764,7 @@ namespace eosio {
    // called from any thread
    void dispatch_manager::rejected_transaction(const packed_transaction_ptr& trx) {
       fc_dlog( logger, "not sending rejected transaction ${tid}", ("tid", trx->id()) );
+      take_recv_buffer( recv_trx_buffers, trx->id() );
       // keep rejected transaction around for awhile so we don't broadcast it, don't remove from local_txns
    }
 
@@ -3103,10 +3184,12 @@ namespace eosio {
          }
       }
 
-      auto ds = pending_message_buffer.create_datastream();
+      auto ds = pending_message_buffer.create_peek_datastream();
+      const uint32_t bytes_to_read = pending_message_buffer.bytes_to_read();
       fc::raw::unpack( ds, which );
       shared_ptr<signed_block> ptr = std::make_shared<signed_block>();
       fc::raw::unpack( ds, *ptr );
+      const uint32_t bytes_unpacked = bytes_to_read - ds.remaining();
 
       auto is_webauthn_sig = []( const fc::crypto::signature& s ) {
          return s.which() == fc::get_index<fc::crypto::signature::storage_type, fc::crypto::webauthn::signature>();
@@ -3126,10 +3209,28 @@ namespace eosio {
          return false;
       }
 
+      // keep the received bytes for relay, unless they are not the canonical encoding of the block or blocks are not
+      // relayed while syncing
+      if( bytes_unpacked == message_length && fc::raw::pack_size( which ) + fc::raw::pack_size( *ptr ) == message_length &&
+          !my_impl->sync_master->syncing_from_peer() ) {
+         my_impl->dispatcher.add_recv_block_buffer( blk_id, read_framed_message( message_length ) );
+      } else {
+         pending_message_buffer.advance_read_ptr( message_length );
+      }
+
       handle_message( blk_id, std::move( ptr ) );
       return true;
    }
 
+   // called from connection strand
+   send_buffer_type connection::read_framed_message( uint32_t message_length ) {
+      // one contiguous copy out of the chained receive buffers, framed exactly as buffer_factory would
+      auto recv_buffer = std::make_shared<std::vector<char>>( message_header_size + message_length );
+      memcpy( recv_buffer->data(), &message_length, message_header_size );
+      pending_message_buffer.read( recv_buffer->data() + message_header_size, message_length );
+      return recv_buffer;
+   }
+
    // called from connection strand
    bool connection::process_next_trx_message(uint32_t message_length) {
       if( !my_impl->p2p_accept_transactions ) {
@@ -3145,12 +3246,16 @@ namespace eosio {
 
       const unsigned long trx_in_progress_sz = this->trx_in_progress_size.load();
 
-      auto ds = pending_message_buffer.create_datastream();
+      // peek so that the bytes are only copied for relay once the trx is known not to be a duplicate
+      auto ds = pending_message_buffer.create_peek_datastream();
+      const uint32_t bytes_to_read = pending_message_buffer.bytes_to_read();
       unsigned_int which{};
       fc::raw::unpack( ds, which );
       shared_ptr<packed_transaction> ptr = std::make_shared<packed_transaction>();
       fc::raw::unpack( ds, *ptr );
+      const uint32_t bytes_unpacked = bytes_to_read - ds.remaining();
       if( trx_in_progress_sz > def_max_trx_in_progress_size) {
+         pending_message_buffer.advance_read_ptr( message_length );
          char reason[72];
          snprintf(reason, 72, "Dropping trx, too many trx in progress %lu bytes", trx_in_progress_sz);
          my_impl->producer_plug->log_failed_transaction(ptr->id(), ptr, reason);
@@ -3168,9 +3273,17 @@ namespace eosio {
 
       if( have_trx ) {
          peer_dlog( this, "got a duplicate transaction - dropping" );
+         pending_message_buffer.advance_read_ptr( message_length );
          return true;
       }
 
+      // keep the received bytes for relay once the trx is accepted, unless they are not its canonical encoding
+      if( bytes_unpacked == message_length && fc::raw::pack_size( which ) + fc::raw::pack_size( *ptr ) == message_length ) {
+         my_impl->dispatcher.add_recv_trx_buffer( ptr->id(), ptr->expiration(), read_framed_message( message_length ) );
+      } else {
+         pending_message_buffer.advance_read_ptr( message_length );
+      }
+
       handle_message( std::move( ptr ) );
       return true;
    }
@@ -3665,16 +3778,18 @@ namespace eosio {
       size_t trx_size = calc_trx_size( trx );
       trx_in_progress_size += trx_size;
       my_impl->chain_plug->accept_transaction( trx,
-         [weak = weak_from_this(), trx_size](const next_function_variant<transaction_trace_ptr>& result) mutable {
+         [weak = weak_from_this(), trx_size, tid](const next_function_variant<transaction_trace_ptr>& result) mutable {
          // next (this lambda) called from application thread
          if (std::holds_alternative<fc::exception_ptr>(result)) {
             fc_dlog( logger, "bad packed_transaction : ${m}", ("m", std::get<fc::exception_ptr>(result)->what()) );
+            my_impl->dispatcher.drop_recv_trx_buffer( tid );
          } else {
             const transaction_trace_ptr& trace = std::get<transaction_trace_ptr>(result);
             if( !trace->except ) {
                fc_dlog( logger, "chain accepted transaction, bcast ${id}", ("id", trace->id) );
             } else {
                fc_ilog( logger, "bad packed_transaction : ${m}", ("m", trace->except->what()));
+               my_impl->dispatcher.drop_recv_trx_buffer( tid );
             }
          }
          connection_ptr conn = weak.lock();
@@ -2,6 +2,8 @@
 
 #include <eosio/chain_plugin/chain_plugin.hpp>
 #include <eosio/chain/snapshot_scheduler.hpp>
+#include <eosio/chain/webassembly/intrinsic_profiler.hpp>
+#include <eosio/chain/webassembly/eos-vm-oc/profiler.hpp>
 #include <eosio/signature_provider_plugin/signature_provider_plugin.hpp>
 
 #include <eosio/chain/application.hpp>
@@ -135,6 +137,25 @@ public:
 
    get_unapplied_transactions_result get_unapplied_transactions( const get_unapplied_transactions_params& params, const fc::time_point& deadline ) const;
 
+   struct intrinsic_profile {
+      uint32_t                                                  block_num = 0;
+      chain::block_id_type                                      block_id;
+      std::vector<chain::webassembly::intrinsic_profiler::entry> entries; ///< most cycles first
+   };
+
+   /// the host function calls of the last block accepted, empty unless profile-intrinsics is set
+   intrinsic_profile get_intrinsic_profile() const;
+
+   struct start_oc_profile_params {
+      uint32_t interval_us = 1000; ///< cpu time between two samples of a thread running contract code
+   };
+
+   /// starts sampling the contracts run by EOS VM OC, dropping what was sampled before
+   void start_oc_profile(const start_oc_profile_params& params);
+   /// stops sampling the contracts run by EOS VM OC, keeping what was sampled for get_oc_profile
+   void stop_oc_profile();
+   chain::eosvmoc::profiler::profile get_oc_profile() const;
+
 
    void log_failed_transaction(const transaction_id_type& trx_id, const chain::packed_transaction_ptr& packed_trx_ptr, const char* reason) const;
 
@@ -188,6 +209,7 @@ public:
    void register_update_produced_block_metrics(std::function<void(produced_block_metrics)>&&);
    void register_update_speculative_block_metrics(std::function<void(speculative_block_metrics)>&&);
    void register_update_incoming_block_metrics(std::function<void(incoming_block_metrics)>&&);
+   void register_update_intrinsic_profile(std::function<void(const intrinsic_profile&)>&&);
 
    inline static bool test_mode_{false}; // to be moved into appbase (application_base)
 
@@ -208,3 +230,5 @@ FC_REFLECT(eosio::producer_plugin::get_account_ram_corrections_result, (rows)(mo
 FC_REFLECT(eosio::producer_plugin::get_unapplied_transactions_params, (lower_bound)(limit)(time_limit_ms))
 FC_REFLECT(eosio::producer_plugin::unapplied_trx, (trx_id)(expiration)(trx_type)(first_auth)(first_receiver)(first_action)(total_actions)(billed_cpu_time_us)(size))
 FC_REFLECT(eosio::producer_plugin::get_unapplied_transactions_result, (size)(incoming_size)(trxs)(more))
+FC_REFLECT(eosio::producer_plugin::intrinsic_profile, (block_num)(block_id)(entries))
+FC_REFLECT(eosio::producer_plugin::start_oc_profile_params, (interval_us))
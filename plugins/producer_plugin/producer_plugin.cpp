@@ -78,6 +78,9 @@ fc::logger        _transient_trx_successful_trace_log;
 const std::string transient_trx_failed_trace_logger_name("transient_trx_failure_tracing");
 fc::logger        _transient_trx_failed_trace_log;
 
+const std::string intrinsic_profile_logger_name("intrinsic_profile");
+fc::logger        _intrinsic_profile_log;
+
 namespace eosio {
 
 static auto _producer_plugin = application::register_plugin<producer_plugin>();
@@ -545,6 +548,11 @@ public:
    std::function<void(producer_plugin::produced_block_metrics)> _update_produced_block_metrics;
    std::function<void(producer_plugin::speculative_block_metrics)> _update_speculative_block_metrics;
    std::function<void(producer_plugin::incoming_block_metrics)> _update_incoming_block_metrics;
+   std::function<void(const producer_plugin::intrinsic_profile&)> _update_intrinsic_profile;
+
+   // profile the host functions called on the main thread, read-only transactions are not profiled
+   bool                                _profile_intrinsics = false;
+   producer_plugin::intrinsic_profile _last_intrinsic_profile;
 
    // ro for read-only
    struct ro_trx_t {
@@ -631,6 +639,19 @@ public:
       }
    }
 
+   // the profile accumulated since the block started, which includes the transactions that failed during the block
+   void on_block_intrinsic_profile(const signed_block_ptr& block, const block_id_type& id) {
+      _last_intrinsic_profile = {.block_num = block->block_num(), .block_id = id, .entries = webassembly::intrinsic_profiler::take()};
+      if (_intrinsic_profile_log.is_enabled(fc::log_level::debug)) {
+         for (const auto& e : _last_intrinsic_profile.entries) {
+            fc_dlog(_intrinsic_profile_log, "Block #${n} ${c} ${i} calls: ${calls}, cycles: ${cycles}",
+                    ("n", _last_intrinsic_profile.block_num)("c", e.contract)("i", e.intrinsic)("calls", e.calls)("cycles", e.cycles));
+         }
+      }
+      if (_update_intrinsic_profile)
+         _update_intrinsic_profile(_last_intrinsic_profile);
+   }
+
    void on_block_header(chain::account_name producer, uint32_t block_num, chain::block_timestamp_type timestamp) {
       if (_producers.contains(producer))
          _producer_watermarks.consider_new_watermark(producer, block_num, timestamp);
@@ -1088,6 +1109,10 @@ void producer_plugin::set_program_options(
           "Time in microseconds the write window lasts.")
          ("read-only-read-window-time-us", bpo::value<uint32_t>()->default_value(my->_ro_read_window_time_us.count()),
           "Time in microseconds the read window lasts.")
+         ("profile-intrinsics", boost::program_options::bool_switch()->notifier([this](bool p){my->_profile_intrinsics = p;}),
+          "Count the calls of each host function and the cycles spent in them per contract, for each block. "
+          "Available from /v1/producer/get_intrinsic_profile and the intrinsic_profile logger at debug level; prometheus sums them over the contracts. "
+          "Read-only transactions are not profiled.")
          ;
    config_file_options.add(producer_options);
 }
@@ -1337,6 +1362,8 @@ void producer_plugin_impl::plugin_startup() {
          _accepted_block_connection.emplace(chain.accepted_block.connect([this](const block_signal_params& t) {
             const auto& [ block, id ] = t;
             on_block(block);
+            if (_profile_intrinsics)
+               on_block_intrinsic_profile(block, id);
           }));
          _accepted_block_header_connection.emplace(chain.accepted_block_header.connect([this](const block_signal_params& t) {
             const auto& [ block, id ] = t;
@@ -1347,7 +1374,15 @@ void producer_plugin_impl::plugin_startup() {
             on_irreversible_block(block);
          }));
 
+         if (_profile_intrinsics) {
+            // blocks are applied on this thread
+            webassembly::intrinsic_profiler::set_enabled(true);
+         }
+
          _block_start_connection.emplace(chain.block_start.connect([this, &chain](uint32_t bs) {
+            // drop what was profiled in an aborted block
+            if (_profile_intrinsics)
+               webassembly::intrinsic_profiler::reset();
             try {
                _snapshot_scheduler.on_start_block(bs, chain);
             } catch (const snapshot_execution_exception& e) {
@@ -1431,6 +1466,7 @@ void producer_plugin::handle_sighup() {
    fc::logger::update(trx_logger_name, _trx_log);
    fc::logger::update(transient_trx_successful_trace_logger_name, _transient_trx_successful_trace_log);
    fc::logger::update(transient_trx_failed_trace_logger_name, _transient_trx_failed_trace_log);
+   fc::logger::update(intrinsic_profile_logger_name, _intrinsic_profile_log);
 }
 
 void producer_plugin::pause() {
@@ -1668,6 +1704,36 @@ producer_plugin::get_account_ram_corrections(const get_account_ram_corrections_p
    return result;
 }
 
+producer_plugin::intrinsic_profile producer_plugin::get_intrinsic_profile() const {
+   return my->_last_intrinsic_profile;
+}
+
+void producer_plugin::start_oc_profile(const start_oc_profile_params& params) {
+#ifdef EOSIO_EOS_VM_OC_RUNTIME_ENABLED
+   EOS_ASSERT(my->chain_plug->chain().is_eos_vm_oc_enabled(), chain::unsupported_feature,
+              "EOS VM OC is not enabled, there is nothing to profile");
+   EOS_ASSERT(params.interval_us >= 100, chain::invalid_http_request, "interval_us must be at least 100");
+   chain::eosvmoc::profiler::clear();
+   chain::eosvmoc::profiler::start(params.interval_us);
+#else
+   EOS_THROW(chain::unsupported_feature, "EOS VM OC is not available on this platform");
+#endif
+}
+
+void producer_plugin::stop_oc_profile() {
+#ifdef EOSIO_EOS_VM_OC_RUNTIME_ENABLED
+   chain::eosvmoc::profiler::stop();
+#endif
+}
+
+chain::eosvmoc::profiler::profile producer_plugin::get_oc_profile() const {
+#ifdef EOSIO_EOS_VM_OC_RUNTIME_ENABLED
+   return chain::eosvmoc::profiler::get();
+#else
+   return {};
+#endif
+}
+
 producer_plugin::get_unapplied_transactions_result producer_plugin::get_unapplied_transactions(const get_unapplied_transactions_params& p,
                                                                                                const fc::time_point& deadline) const {
 
@@ -2901,4 +2967,8 @@ void producer_plugin::register_update_incoming_block_metrics(std::function<void(
    my->_update_incoming_block_metrics = std::move(fun);
 }
 
+void producer_plugin::register_update_intrinsic_profile(std::function<void(const intrinsic_profile&)>&& fun) {
+   my->_update_intrinsic_profile = std::move(fun);
+}
+
 } // namespace eosio
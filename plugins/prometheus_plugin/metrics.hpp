@@ -3,6 +3,7 @@
 #include <eosio/http_plugin/http_plugin.hpp>
 #include <eosio/net_plugin/net_plugin.hpp>
 #include <eosio/producer_plugin/producer_plugin.hpp>
+#include <eosio/trace_api/trace_api_plugin.hpp>
 
 #include <prometheus/counter.h>
 #include <prometheus/info.h>
@@ -32,6 +33,7 @@ struct catalog_type {
    prometheus::Info info_details;
    // http plugin
    prometheus::Family<Counter>& http_request_counts;
+   prometheus::Family<Counter>& http_response_cache_counts;
 
    // net plugin failed p2p connection
    Counter& failed_p2p_connections;
@@ -108,6 +110,16 @@ struct catalog_type {
    Counter& latency_us_incoming_block;
    Counter& blocks_incoming;
 
+   // intrinsic profile, one series per host function called; the contracts calling it are in the producer api and log
+   prometheus::Family<Counter>& intrinsic_calls;
+   prometheus::Family<Counter>& intrinsic_cycles;
+
+   // trace api plugin
+   Counter& trace_api_blocks_appended;
+   Counter& trace_api_append_time_us;
+   Gauge&   trace_api_append_time_us_last_block;
+   Gauge&   trace_api_queued_blocks;
+
    // prometheus exporter
    Counter& bytes_transferred;
    Counter& num_scrapes;
@@ -116,6 +128,7 @@ struct catalog_type {
    catalog_type()
        : info(family<prometheus::Info>("nodeos", "static information about the server"))
        , http_request_counts(family<Counter>("nodeos_http_requests_total", "number of HTTP requests"))
+       , http_response_cache_counts(family<Counter>("nodeos_http_response_cache_total", "number of HTTP requests to cacheable endpoints by cache result"))
        , failed_p2p_connections(build<Counter>("nodeos_p2p_failed_connections", "total number of failed out-going p2p connections"))
        , dropped_trxs_total(build<Counter>("nodeos_p2p_dropped_trxs_total", "total number of dropped transactions by net plugin"))
        , p2p_metrics{
@@ -184,6 +197,12 @@ struct catalog_type {
        , net_usage_us_incoming_block(net_usage_us.Add({{"block_type", "incoming"}}))
        , latency_us_incoming_block(build<Counter>("nodeos_incoming_us_block_latency", "total incoming block latency"))
        , blocks_incoming(build<Counter>("nodeos_blocks_incoming", "number of incoming blocks"))
+       , intrinsic_calls(family<Counter>("nodeos_intrinsic_calls_total", "number of calls of a host function, with profile-intrinsics"))
+       , intrinsic_cycles(family<Counter>("nodeos_intrinsic_cycles_total", "cycles spent in a host function, with profile-intrinsics"))
+       , trace_api_blocks_appended(build<Counter>("nodeos_trace_api_blocks_appended_total", "number of blocks appended to trace api slice files"))
+       , trace_api_append_time_us(build<Counter>("nodeos_trace_api_append_us_total", "total time converting and appending block traces"))
+       , trace_api_append_time_us_last_block(build<Gauge>("nodeos_trace_api_append_us_block", "time converting and appending the traces of the last block"))
+       , trace_api_queued_blocks(build<Gauge>("nodeos_trace_api_queued_blocks", "number of blocks waiting for their traces to be appended"))
        , bytes_transferred(build<Counter>("exposer_transferred_bytes_total",
                                           "total number of bytes for responses to prometheus scrape requests"))
        , num_scrapes(build<Counter>("exposer_scrapes_total", "total number of prometheus scrape requests received")) {}
@@ -198,6 +217,8 @@ struct catalog_type {
 
    void update(const http_plugin::metrics& metrics) {
       http_request_counts.Add({{"handler", metrics.target}}).Increment(1);
+      if (metrics.cacheable)
+         http_response_cache_counts.Add({{"handler", metrics.target}, {"result", metrics.cache_hit ? "hit" : "miss"}}).Increment(1);
    }
 
    void update(const net_plugin::p2p_connections_metrics& metrics) {
@@ -281,6 +302,22 @@ struct catalog_type {
       head_block_num.Set(metrics.head_block_num);
    }
 
+   void update(const producer_plugin::intrinsic_profile& profile) {
+      // summed over the contracts, whose number is unbounded
+      for (const auto& e : profile.entries) {
+         const prometheus::Labels labels{{"intrinsic", e.intrinsic}};
+         intrinsic_calls.Add(labels).Increment(e.calls);
+         intrinsic_cycles.Add(labels).Increment(e.cycles);
+      }
+   }
+
+   void update(const trace_api_plugin::append_metrics& metrics) {
+      trace_api_blocks_appended.Increment(1);
+      trace_api_append_time_us.Increment(metrics.append_time_us);
+      trace_api_append_time_us_last_block.Set(metrics.append_time_us);
+      trace_api_queued_blocks.Set(metrics.queued_blocks);
+   }
+
    void update_prometheus_info() {
       info_details = info.Add({
             {"server_version", chain_apis::itoh(static_cast<uint32_t>(app().version()))},
@@ -323,6 +360,16 @@ struct catalog_type {
           [&strand, this](const producer_plugin::incoming_block_metrics& metrics) {
              strand.post([metrics, this]() { update(metrics); });
           });
+      producer.register_update_intrinsic_profile(
+          [&strand, this](const producer_plugin::intrinsic_profile& profile) {
+             strand.post([profile, this]() { update(profile); });
+          });
+
+      // trace_api_plugin is optional
+      if (auto* trace_api = app().find_plugin<trace_api_plugin>()) {
+         trace_api->register_update_append_metrics(
+             [&strand, this](trace_api_plugin::append_metrics metrics) { strand.post([metrics, this]() { update(metrics); }); });
+      }
    }
 };
 
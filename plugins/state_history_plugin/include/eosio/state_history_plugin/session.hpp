@@ -1,5 +1,6 @@
 #pragma once
 #include <eosio/state_history/compression.hpp>
+#include <eosio/state_history/filter.hpp>
 #include <eosio/state_history/log.hpp>
 #include <eosio/state_history/serialization.hpp>
 #include <eosio/state_history/types.hpp>
@@ -9,6 +10,8 @@
 #include <boost/asio/local/stream_protocol.hpp>
 #include <boost/asio/error.hpp>
 #include <boost/beast/websocket.hpp>
+#include <list>
+#include <map>
 #include <memory>
 
 
@@ -29,6 +32,7 @@ struct session_base {
    virtual ~session_base()                                                    = default;
 
    std::optional<state_history::get_blocks_request_v0> current_request;
+   std::optional<state_history::entry_filter>          current_filter; // set by a get_blocks_request_v1 with filters
    bool need_to_send_update = false;
 };
 
@@ -51,6 +55,72 @@ public:
    }
 };
 
+/// Decompressed trace and delta log entries of recent blocks, framed as the `traces` or `deltas` field of a
+/// get_blocks_result_v0, shared by all sessions. An entry wanted by several clients, e.g. the head block when they are
+/// caught up, is read from the log and decompressed once. Keyed by block id so entries of a forked out block are
+/// simply never found again and age out.
+/// accessed from ship thread
+class log_entry_cache {
+public:
+   using entry_ptr = std::shared_ptr<const std::vector<char>>;
+
+   /// 0 disables the cache
+   void set_max_size(size_t bytes) {
+      max_size = bytes;
+      evict(max_size);
+   }
+
+   bool enabled() const { return max_size > 0; }
+
+   /// larger entries, e.g. the initial chain state, are streamed from the log instead
+   uint64_t max_entry_size() const { return max_size / 4; }
+
+   entry_ptr find(const chain::block_id_type& id, bool is_deltas) {
+      auto itr = entries.find(key_t{id, is_deltas});
+      if (itr == entries.end())
+         return {};
+      lru.splice(lru.begin(), lru, itr->second.lru_pos);
+      return itr->second.entry;
+   }
+
+   void insert(const chain::block_id_type& id, bool is_deltas, entry_ptr entry) {
+      if (entry->size() > max_entry_size())
+         return;
+      key_t key{id, is_deltas};
+      if (auto itr = entries.find(key); itr != entries.end()) {
+         size -= itr->second.entry->size();
+         lru.erase(itr->second.lru_pos);
+         entries.erase(itr);
+      }
+      evict(max_size - entry->size());
+      lru.push_front(key);
+      size += entry->size();
+      entries.emplace(key, cached{std::move(entry), lru.begin()});
+   }
+
+private:
+   using key_t = std::pair<chain::block_id_type, bool>;
+   struct cached {
+      entry_ptr                 entry;
+      std::list<key_t>::iterator lru_pos;
+   };
+
+   // remove least recently used entries until at most max_bytes are cached
+   void evict(size_t max_bytes) {
+      while (size > max_bytes && !lru.empty()) {
+         auto itr = entries.find(lru.back());
+         size -= itr->second.entry->size();
+         entries.erase(itr);
+         lru.pop_back();
+      }
+   }
+
+   size_t                    max_size = 0;
+   size_t                    size     = 0;
+   std::map<key_t, cached>   entries;
+   std::list<key_t>          lru; // most recently used first
+};
+
 /// Coordinate sending of queued entries. Only one session can read from the ship logs at a time so coordinate
 /// their execution on the ship thread.
 /// accessed from ship thread
@@ -62,11 +132,14 @@ private:
    std::set<std::shared_ptr<session_base>> session_set;
    bool sending  = false;
    std::deque<std::pair<std::shared_ptr<session_base>, entry_ptr>> send_queue;
+   log_entry_cache cache;
 
 public:
    explicit session_manager(boost::asio::io_context& ship_io_context)
    : ship_io_context(ship_io_context) {}
 
+   log_entry_cache& entry_cache() { return cache; }
+
    void insert(std::shared_ptr<session_base> s) {
       session_set.insert(std::move(s));
    }
@@ -174,14 +247,17 @@ template <typename Session>
 class blocks_request_send_queue_entry : public send_queue_entry_base {
    std::shared_ptr<Session> session;
    eosio::state_history::get_blocks_request_v0 req;
+   std::optional<state_history::entry_filter>  filter;
 
 public:
-   blocks_request_send_queue_entry(std::shared_ptr<Session> s, state_history::get_blocks_request_v0&& r)
+   blocks_request_send_queue_entry(std::shared_ptr<Session> s, state_history::get_blocks_request_v0&& r,
+                                   std::optional<state_history::entry_filter> f = {})
    : session(std::move(s))
-   , req(std::move(r)) {}
+   , req(std::move(r))
+   , filter(std::move(f)) {}
 
    void send_entry() override {
-      session->update_current_request(req);
+      session->update_current_request(req, std::move(filter));
       session->send_update(true);
    }
 };
@@ -192,6 +268,7 @@ class blocks_result_send_queue_entry : public send_queue_entry_base, public std:
    state_history::get_blocks_result_v0                             r;
    std::vector<char>                                               data;
    std::optional<locked_decompress_stream>                         stream;
+   log_entry_cache::entry_ptr                                      cached;
 
    template <typename Next>
    void async_send(bool fin, const std::vector<char>& d, Next&& next) {
@@ -259,17 +336,135 @@ class blocks_result_send_queue_entry : public send_queue_entry_base, public std:
                 });
    }
 
-   void send_deltas() {
+   // frame prefix of an optional<bytes> holding entry_size bytes, returns the size of the prefix
+   static size_t pack_frame_prefix(std::vector<char>& framed, uint64_t entry_size) {
+      framed.resize(16);
+      fc::datastream<char*> ds(framed.data(), framed.size());
+      fc::raw::pack(ds, true); // optional true
+      history_pack_varuint64(ds, entry_size);
+      return ds.tellp();
+   }
+
+   // read the whole entry framed as an optional<bytes>
+   static std::vector<char> read_framed_entry(uint64_t entry_size, locked_decompress_stream& strm) {
+      std::vector<char> framed;
+      const size_t prefix_size = pack_frame_prefix(framed, entry_size);
+      framed.resize(prefix_size);
+      std::visit(chain::overloaded{
+         [&](std::vector<char>& d) {
+            EOS_ASSERT(d.size() == entry_size, chain::plugin_exception, "state history log entry does not have its recorded size");
+            framed.insert(framed.end(), d.begin(), d.end());
+         },
+         [&](std::unique_ptr<bio::filtering_istreambuf>& d) {
+            // the size recorded in the entry is only trusted as far as the decompressed data goes
+            constexpr uint64_t read_size = 1024 * 1024;
+            for (uint64_t left = entry_size; left;) {
+               const size_t pos = framed.size();
+               framed.resize(pos + std::min(left, read_size));
+               const auto n = d->sgetn(framed.data() + pos, framed.size() - pos);
+               EOS_ASSERT(static_cast<size_t>(n) == framed.size() - pos, chain::plugin_exception, "truncated state history log entry");
+               left -= n;
+            }
+            EOS_ASSERT(d->sgetc() == std::char_traits<char>::eof(), chain::plugin_exception,
+                       "state history log entry is larger than its recorded size");
+         }
+      }, strm.buf);
+      return framed;
+   }
+
+   // size of the frame prefix of an entry framed by read_framed_entry
+   static size_t frame_prefix_size(const std::vector<char>& framed) {
+      size_t prefix_size = 1; // optional true
+      while (framed[prefix_size++] & 0x80) {}
+      return prefix_size;
+   }
+
+   // frame a filtered entry as an optional<bytes>
+   static std::vector<char> frame_filtered_entry(const bytes& filtered) {
+      std::vector<char> result;
+      result.resize(pack_frame_prefix(result, filtered.size()));
+      result.insert(result.end(), filtered.begin(), filtered.end());
+      return result;
+   }
+
+   // apply the filter of the session to an entry framed by read_framed_entry, frame the result again
+   static std::vector<char> filter_framed_entry(const state_history::entry_filter& filter, bool is_deltas,
+                                                const std::vector<char>& framed) {
+      const size_t prefix_size = frame_prefix_size(framed);
+      const std::string_view entry(framed.data() + prefix_size, framed.size() - prefix_size);
+      return frame_filtered_entry(is_deltas ? filter.filter_deltas(entry) : filter.filter_traces(entry));
+   }
+
+   // apply the filter of the session to an entry as it is read from the log, for entries too large to read whole
+   static std::vector<char> filter_log_entry(const state_history::entry_filter& filter, bool is_deltas,
+                                             locked_decompress_stream& strm) {
+      return std::visit(chain::overloaded{
+         [&](std::vector<char>& d) {
+            const std::string_view entry(d.data(), d.size());
+            return frame_filtered_entry(is_deltas ? filter.filter_deltas(entry) : filter.filter_traces(entry));
+         },
+         [&](std::unique_ptr<bio::filtering_istreambuf>& d) {
+            return frame_filtered_entry(is_deltas ? filter.filter_deltas(*d) : filter.filter_traces(*d));
+         }
+      }, strm.buf);
+   }
+
+   uint64_t get_log_entry(bool is_deltas) {
+      return is_deltas ? session->get_delta_log_entry(r, stream) : session->get_trace_log_entry(r, stream);
+   }
+
+   template <typename Next>
+   void send_log_entry(bool is_deltas, Next&& next) {
       stream.reset();
-      send_log(session->get_delta_log_entry(r, stream), true, [me=this->shared_from_this()]() {
+      cached.reset();
+      auto& cache = session->session_mgr.entry_cache();
+      const bool requested = is_deltas ? r.deltas.has_value() : r.traces.has_value();
+      const bool use_cache = cache.enabled() && r.this_block;
+      // a filtered entry is read whole, filtered and sent from memory, one too large for that is filtered as it is read
+      const bool filtered = requested && session->current_filter.has_value();
+      if (!requested || (!use_cache && !filtered)) {
+         send_log(get_log_entry(is_deltas), is_deltas, std::forward<Next>(next));
+         return;
+      }
+
+      if (use_cache)
+         cached = cache.find(r.this_block->block_id, is_deltas);
+      if (!cached) {
+         uint64_t entry_size = get_log_entry(is_deltas);
+         if (entry_size == 0 || (!filtered && (!use_cache || entry_size > cache.max_entry_size()))) {
+            send_log(entry_size, is_deltas, std::forward<Next>(next));
+            return;
+         }
+         if (filtered && entry_size > state_history::entry_filter::max_entry_size) {
+            data = filter_log_entry(*session->current_filter, is_deltas, *stream);
+            stream.reset(); // release the log while sending
+            async_send(is_deltas, data, std::forward<Next>(next));
+            return;
+         }
+         cached = std::make_shared<const std::vector<char>>(read_framed_entry(entry_size, *stream));
+         stream.reset(); // release the log while sending
+         if (use_cache && entry_size <= cache.max_entry_size())
+            cache.insert(r.this_block->block_id, is_deltas, cached);
+      }
+      if (filtered) {
+         data = filter_framed_entry(*session->current_filter, is_deltas, *cached);
+         cached.reset();
+         async_send(is_deltas, data, std::forward<Next>(next));
+         return;
+      }
+      async_send(is_deltas, *cached, std::forward<Next>(next));
+   }
+
+   void send_deltas() {
+      send_log_entry(true, [me=this->shared_from_this()]() {
          me->stream.reset();
+         me->cached.reset();
          me->session->session_mgr.pop_entry();
       });
    }
 
    void send_traces() {
-      stream.reset();
-      send_log(session->get_trace_log_entry(r, stream), false, [me=this->shared_from_this()]() {
+      send_log_entry(false, [me=this->shared_from_this()]() {
          me->send_deltas();
       });
    }
@@ -332,6 +527,12 @@ public:
       }
       socket_stream->next_layer().set_option(boost::asio::socket_base::send_buffer_size(1024 * 1024));
       socket_stream->next_layer().set_option(boost::asio::socket_base::receive_buffer_size(1024 * 1024));
+      if (plugin.permessage_deflate) {
+         // only used with clients that offer the extension in their handshake
+         boost::beast::websocket::permessage_deflate pmd;
+         pmd.server_enable = true;
+         socket_stream->set_option(pmd);
+      }
 
       socket_stream->async_accept([self = this->shared_from_this()](boost::system::error_code ec) {
          self->callback(ec, false, "async_accept", [self] {
@@ -419,6 +620,19 @@ private:
       session_mgr.add_send_queue(std::move(self), std::move(entry_ptr));
    }
 
+   void process(state_history::get_blocks_request_v1& req) {
+      fc_dlog(plugin.get_logger(), "received get_blocks_request_v1 = ${req}", ("req", req));
+
+      std::optional<state_history::entry_filter> filter;
+      if (state_history::entry_filter f(req); !f.empty())
+         filter.emplace(std::move(f));
+
+      auto self = this->shared_from_this();
+      auto entry_ptr = std::make_unique<blocks_request_send_queue_entry<session>>(
+            self, std::move(static_cast<state_history::get_blocks_request_v0&>(req)), std::move(filter));
+      session_mgr.add_send_queue(std::move(self), std::move(entry_ptr));
+   }
+
    void process(state_history::get_blocks_ack_request_v0& req) {
       fc_dlog(plugin.get_logger(), "received get_blocks_ack_request_v0 = ${req}", ("req", req));
       if (!current_request) {
@@ -454,7 +668,8 @@ private:
       return result;
    }
 
-   void update_current_request(state_history::get_blocks_request_v0& req) {
+   void update_current_request(state_history::get_blocks_request_v0& req,
+                               std::optional<state_history::entry_filter> filter = {}) {
       fc_dlog(plugin.get_logger(), "replying get_blocks_request_v0 = ${req}", ("req", req));
       to_send_block_num = std::max(req.start_block_num, plugin.get_first_available_block_num());
       for (auto& cp : req.have_positions) {
@@ -480,6 +695,7 @@ private:
       }
 
       current_request = std::move(req);
+      current_filter  = std::move(filter);
    }
 
    void send_update(state_history::get_blocks_result_v0 result, const chain::signed_block_ptr& block, const chain::block_id_type& id) {
@@ -12,11 +12,13 @@
 
 #include <boost/asio/bind_executor.hpp>
 #include <boost/asio/ip/host_name.hpp>
+#include <boost/iostreams/device/back_inserter.hpp>
 
 #include <boost/asio/strand.hpp>
 #include <boost/beast/core.hpp>
 
 #include <boost/signals2/connection.hpp>
+#include <condition_variable>
 #include <mutex>
 
 #include <fc/network/listener.hpp>
@@ -49,6 +51,7 @@ auto catch_and_log(F f) {
 
 struct state_history_plugin_impl : std::enable_shared_from_this<state_history_plugin_impl> {
    constexpr static uint64_t default_frame_size = 1024 * 1024;
+   bool                      permessage_deflate = false;
 
 private:
    chain_plugin*                    chain_plug = nullptr;
@@ -72,7 +75,27 @@ private:
 
    session_manager                  session_mgr{thread_pool.get_executor()};
 
-   bool  plugin_started = false;
+   std::atomic<bool> plugin_started = false;
+
+   // log entries of a block captured on the main thread, to be packed, compressed and written by write_thread
+   struct pending_entry {
+      signed_block_ptr                                         block;
+      block_id_type                                            id;
+      block_id_type                                            lib_id;
+      time_point                                               head_timestamp;
+      std::optional<std::vector<augmented_transaction_trace>>  traces;
+      std::optional<std::vector<char>>                         deltas; // uncompressed
+      bool                                                     write_inline = false; // chain state packed while writing
+   };
+
+   // single thread so that entries are appended to the logs in block order
+   named_thread_pool<struct shipw> write_thread;
+   uint32_t                        max_pending_writes = 4;
+   std::mutex                      write_mtx;
+   std::condition_variable         write_cv;
+   uint32_t                        pending_writes = 0; // protected by write_mtx
+   std::atomic<bool>               write_failed = false;
+   bool                            chain_state_captured = false;
 
 public:
    void plugin_initialize(const variables_map& options);
@@ -194,19 +217,28 @@ public:
    // called from main thread
    void update_current() {
       const auto& chain = chain_plug->chain();
+      set_current(chain.head_block_id(), chain.last_irreversible_block_id(), chain.head_block_time());
+   }
+
+   // thread-safe
+   void set_current(const block_id_type& head, const block_id_type& lib, time_point timestamp) {
       std::lock_guard g(mtx);
-      head_id = chain.head_block_id();
-      lib_id = chain.last_irreversible_block_id();
-      head_timestamp = chain.head_block_time();
+      head_id = head;
+      lib_id = lib;
+      head_timestamp = timestamp;
    }
 
    // called from main thread
    void on_accepted_block(const signed_block_ptr& block, const block_id_type& id) {
-      update_current();
-
       try {
-         store_traces(block, id);
-         store_chain_state(id, static_cast<signed_block_header>(*block), block->block_num());
+         EOS_ASSERT(!write_failed, chain::state_history_write_exception, "previous state history write failed");
+         auto entry = capture_entry(block, id);
+         if (entry.write_inline) {
+            wait_for_pending_writes(0);
+            store_entry(entry);
+         } else {
+            queue_entry(std::move(entry));
+         }
       } catch (const fc::exception& e) {
          fc_elog(_log, "fc::exception: ${details}", ("details", e.to_detail_string()));
          // Both app().quit() and exception throwing are required. Without app().quit(),
@@ -218,17 +250,87 @@ public:
              "State history encountered an Error which it cannot recover from.  Please resolve the error and relaunch "
              "the process");
       }
+   }
+
+   // called from main thread, everything of the block that changes once the next block starts
+   pending_entry capture_entry(const signed_block_ptr& block, const block_id_type& id) {
+      const auto& chain = chain_plug->chain();
+      pending_entry entry{.block = block, .id = id, .lib_id = chain.last_irreversible_block_id(), .head_timestamp = chain.head_block_time()};
+      entry.write_inline = max_pending_writes == 0;
+      if (trace_log)
+         entry.traces = trace_converter.take_traces(block);
+      if (chain_state_log) {
+         bool fresh = !chain_state_captured && chain_state_log->empty();
+         chain_state_captured = true;
+         if (fresh) {
+            // a full snapshot of the chain state is too large to hold in memory, pack it straight into the log
+            entry.write_inline = true;
+         } else if (!entry.write_inline) {
+            auto& deltas = entry.deltas.emplace();
+            bio::filtering_ostreambuf buf;
+            buf.push(bio::back_inserter(deltas));
+            pack_deltas(buf, chain.db(), false);
+         }
+      }
+      return entry;
+   }
+
+   // called from main thread, blocks while max_pending_writes entries are already queued
+   void queue_entry(pending_entry&& entry) {
+      wait_for_pending_writes(max_pending_writes - 1);
+      {
+         std::lock_guard g(write_mtx);
+         ++pending_writes;
+      }
+      boost::asio::post(write_thread.get_executor(), [self = this->shared_from_this(), entry = std::move(entry)]() {
+         try {
+            self->store_entry(entry);
+         } catch (const fc::exception& e) {
+            fc_elog(_log, "Unable to write state history of block ${n}: ${e}", ("n", entry.block->block_num())("e", e.to_detail_string()));
+            self->write_failed = true;
+            app().quit();
+         } catch (const std::exception& e) {
+            fc_elog(_log, "Unable to write state history of block ${n}: ${e}", ("n", entry.block->block_num())("e", e.what()));
+            self->write_failed = true;
+            app().quit();
+         } catch (...) {
+            fc_elog(_log, "Unable to write state history of block ${n}", ("n", entry.block->block_num()));
+            self->write_failed = true;
+            app().quit();
+         }
+         {
+            std::lock_guard g(self->write_mtx);
+            --self->pending_writes;
+         }
+         self->write_cv.notify_all();
+      });
+   }
+
+   // thread-safe
+   void wait_for_pending_writes(uint32_t max_pending) {
+      std::unique_lock g(write_mtx);
+      write_cv.wait(g, [&]() { return pending_writes <= max_pending; });
+   }
+
+   // called from main thread or write_thread, writes the entries and then lets sessions know about the block
+   void store_entry(const pending_entry& entry) {
+      if (entry.traces)
+         store_traces(entry.block, entry.id, *entry.traces);
+      if (entry.deltas)
+         store_chain_state(entry.id, entry.block->previous, *entry.deltas);
+      else if (entry.write_inline)
+         store_chain_state(entry.id, static_cast<signed_block_header>(*entry.block), entry.block->block_num());
+
+      set_current(entry.id, entry.lib_id, entry.head_timestamp);
 
       // avoid accumulating all these posts during replay before ship threads started
       // that can lead to a large memory consumption and failures
       // this is safe as there are no clients connected until after replay is complete
-      // this method is called from the main thread and "plugin_started" is set on the main thread as well when plugin is started 
       if (plugin_started) {
-         boost::asio::post(get_ship_executor(), [self = this->shared_from_this(), block, id]() {
+         boost::asio::post(get_ship_executor(), [self = this->shared_from_this(), block = entry.block, id = entry.id]() {
             self->get_session_manager().send_update(block, id);
          });
       }
-
    }
 
    // called from main thread
@@ -242,16 +344,22 @@ public:
       trace_converter.onblock_trace.reset();
    }
 
-   // called from main thread
-   void store_traces(const signed_block_ptr& block, const block_id_type& id) {
-      if (!trace_log)
-         return;
-
+   // called from main thread or write_thread
+   void store_traces(const signed_block_ptr& block, const block_id_type& id, const std::vector<augmented_transaction_trace>& traces) {
       state_history_log_header header{.magic        = ship_magic(ship_current_version, 0),
                                       .block_id     = id,
                                       .payload_size = 0};
-      trace_log->pack_and_write_entry(header, block->previous, [this, &block](auto&& buf) {
-         trace_converter.pack(buf, trace_debug_mode, block);
+      trace_log->pack_and_write_entry(header, block->previous, [this, &traces](auto&& buf) {
+         trace_converter::pack(buf, trace_debug_mode, traces);
+      });
+   }
+
+   // called from main thread or write_thread
+   void store_chain_state(const block_id_type& id, const block_id_type& previous, const std::vector<char>& deltas) {
+      state_history_log_header header{
+          .magic = ship_magic(ship_current_version, 0), .block_id = id, .payload_size = 0};
+      chain_state_log->pack_and_write_entry(header, previous, [&deltas](auto&& buf) {
+         bio::write(buf, deltas.data(), deltas.size());
       });
    }
 
@@ -308,6 +416,23 @@ void state_history_plugin::set_program_options(options_description& cli, options
    options("state-history-unix-socket-path", bpo::value<string>(),
            "the path (relative to data-dir) to create a unix socket upon which to listen for incoming connections.");
    options("trace-history-debug-mode", bpo::bool_switch()->default_value(false), "enable debug mode for trace history");
+   options("state-history-write-queue-size", bpo::value<uint32_t>()->default_value(4),
+           "number of blocks whose state history may be waiting to be compressed and written by the background writer "
+           "before block processing waits for it. 0 to write on the main thread.");
+
+   options("state-history-cache-size", bpo::value<uint32_t>()->default_value(64),
+           "maximum size in MiB of the cache of decompressed trace and delta entries of recent blocks shared by all "
+           "state history clients, 0 to disable");
+   options("state-history-permessage-deflate", bpo::bool_switch()->default_value(false),
+           "compress websocket messages to state history clients that offer the permessage-deflate extension");
+   options("state-history-compression", bpo::value<string>()->default_value("zlib"),
+           "codec used to compress new state history log entries, zlib or zstd (zstd requires a build with ENABLE_ZSTD).\n"
+           "Entries already in the logs are read with the codec they were written with.");
+   options("state-history-compression-level", bpo::value<int>()->default_value(0),
+           "compression level of state-history-compression, 0 for the default level of the codec");
+   options("state-history-zstd-dictionary", bpo::value<std::filesystem::path>(),
+           "zstd dictionary (see leap-util state-history train-dictionary) used to compress chain state entries when "
+           "state-history-compression is zstd, and loaded to read entries compressed with it (absolute path or relative to state-history dir)");
 
    if(cfile::supports_hole_punching())
       options("state-history-log-retain-blocks", bpo::value<uint32_t>(), "if set, periodically prune the state history files to store only configured number of most recent blocks");
@@ -346,6 +471,8 @@ void state_history_plugin_impl::plugin_initialize(const variables_map& options)
          resmon_plugin->monitor_directory(state_history_dir);
 
       endpoint_address = options.at("state-history-endpoint").as<string>();
+      permessage_deflate = options.at("state-history-permessage-deflate").as<bool>();
+      session_mgr.entry_cache().set_max_size(uint64_t(options.at("state-history-cache-size").as<uint32_t>()) * 1024 * 1024);
 
       if (options.count("state-history-unix-socket-path")) {
          std::filesystem::path sock_path = options.at("state-history-unix-socket-path").as<string>();
@@ -389,10 +516,36 @@ void state_history_plugin_impl::plugin_initialize(const variables_map& options)
             config.max_retained_files = options.at("max-retained-history-files").as<uint32_t>();
       }
 
+      state_history::compression_config trace_compression;
+      trace_compression.codec = state_history::compression_codec_from_string(options.at("state-history-compression").as<string>());
+      trace_compression.level = options.at("state-history-compression-level").as<int>();
+      EOS_ASSERT(state_history::is_supported(trace_compression.codec), plugin_config_exception,
+                 "state-history-compression=zstd requires a build with ENABLE_ZSTD");
+      auto chain_state_compression = trace_compression;
+      if (options.count("state-history-zstd-dictionary")) {
+         auto dict_path = options.at("state-history-zstd-dictionary").as<std::filesystem::path>();
+         if (dict_path.is_relative())
+            dict_path = state_history_dir / dict_path;
+         auto dict = state_history::load_zstd_dictionary(dict_path);
+         fc_ilog(_log, "Loaded zstd dictionary ${id} from ${p}", ("id", dict->id())("p", dict_path.string()));
+         // the dictionary is trained on deltas, traces gain little from it
+         if (chain_state_compression.codec == state_history::compression_codec::zstd)
+            chain_state_compression.dictionary = std::move(dict);
+      }
+
       if (options.at("trace-history").as<bool>())
-         trace_log.emplace("trace_history", state_history_dir , ship_log_conf);
+         trace_log.emplace("trace_history", state_history_dir , ship_log_conf, trace_compression);
       if (options.at("chain-state-history").as<bool>())
-         chain_state_log.emplace("chain_state_history", state_history_dir, ship_log_conf);
+         chain_state_log.emplace("chain_state_history", state_history_dir, ship_log_conf, chain_state_compression);
+
+      max_pending_writes = options.at("state-history-write-queue-size").as<uint32_t>();
+      // started here since blocks are replayed before plugin_startup
+      if (max_pending_writes > 0 && (trace_log || chain_state_log)) {
+         write_thread.start( 1, [](const fc::exception& e) {
+            fc_elog( _log, "Exception in SHiP write thread, exiting: ${e}", ("e", e.to_detail_string()) );
+            app().quit();
+         });
+      }
    }
    FC_LOG_AND_RETHROW()
 } // state_history_plugin::plugin_initialize
@@ -444,6 +597,9 @@ void state_history_plugin_impl::plugin_shutdown() {
    applied_transaction_connection.reset();
    accepted_block_connection.reset();
    block_start_connection.reset();
+   // all accepted blocks have to be in the logs before they are closed
+   wait_for_pending_writes(0);
+   write_thread.stop();
    thread_pool.stop();
 }
 
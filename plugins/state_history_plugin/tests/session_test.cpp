@@ -29,6 +29,7 @@ namespace websocket = beast::websocket; // from <boost/beast/websocket.hpp>
 namespace net       = boost::asio;      // from <boost/asio.hpp>
 namespace bio       = boost::iostreams;
 using tcp           = boost::asio::ip::tcp; // from <boost/asio/ip/tcp.hpp>
+using namespace eosio::chain::literals;
 
 namespace eosio::state_history {
 
@@ -107,6 +108,7 @@ struct mock_state_history_plugin {
    eosio::session_manager                  session_mgr{ship_ioc};
 
    constexpr static uint32_t default_frame_size = 1024;
+   constexpr static bool     permessage_deflate = false;
 
    std::optional<eosio::state_history_log>& get_trace_log() { return trace_log; }
    std::optional<eosio::state_history_log>& get_chain_state_log() { return state_log; }
@@ -323,12 +325,61 @@ struct state_history_test_fixture {
       written_data[index - 1].swap(decompressed_data);
    }
 
+   // write traces and deltas entries of block index in the format with the decompressed size
+   void add_entries_to_log(uint32_t index, const std::vector<char>& traces, const std::vector<char>& deltas) {
+      auto write = [&](eosio::state_history_log& log, const std::vector<char>& entry) {
+         const uint32_t type                    = 1;
+         const uint64_t decompressed_byte_count = entry.size();
+         auto           compressed              = zlib_compress(entry.data(), entry.size());
+
+         eosio::state_history_log_header header;
+         header.block_id     = block_id_for(index);
+         header.payload_size = sizeof(type) + sizeof(decompressed_byte_count) + compressed.size();
+
+         std::unique_lock g(log._mx);
+         log.write_entry(header, block_id_for(index - 1), [&](auto& f) {
+            f.write((const char*)&type, sizeof(type));
+            f.write((const char*)&decompressed_byte_count, sizeof(decompressed_byte_count));
+            f.write(compressed.data(), compressed.size());
+         });
+      };
+      write(*server.trace_log, traces);
+      write(*server.state_log, deltas);
+   }
+
    ~state_history_test_fixture() { ws.close(websocket::close_code::normal); }
 };
 
-void store_read_test_case(uint64_t data_size, eosio::state_history_log_config config) {
+// chain state entry with a contract_row table of num_rows rows of row_size bytes, every 100th row is of contract matched
+std::vector<char> contract_rows_entry(uint32_t num_rows, uint32_t row_size, eosio::chain::name matched) {
+   std::vector<char> row(row_size, 'x');
+   row[0] = 0; // variant index
+   const uint64_t scope = "scope"_n.to_uint64_t(), table = "table"_n.to_uint64_t();
+   memcpy(row.data() + 1 + sizeof(uint64_t), &scope, sizeof(scope));
+   memcpy(row.data() + 1 + 2 * sizeof(uint64_t), &table, sizeof(table));
+
+   std::vector<char> entry;
+   auto append = [&](const auto& v) {
+      auto packed = fc::raw::pack(v);
+      entry.insert(entry.end(), packed.begin(), packed.end());
+   };
+   append(fc::unsigned_int(1));
+   append(fc::unsigned_int(0));
+   append(std::string("contract_row"));
+   append(fc::unsigned_int(num_rows));
+   for (uint32_t r = 0; r < num_rows; ++r) {
+      const uint64_t code = (r % 100 ? "other"_n : matched).to_uint64_t();
+      memcpy(row.data() + 1, &code, sizeof(code));
+      append(true);
+      append(row);
+   }
+   return entry;
+}
+
+void store_read_test_case(uint64_t data_size, eosio::state_history_log_config config,
+                          eosio::state_history::compression_config compression = {}) {
    fc::temp_directory       log_dir;
-   eosio::state_history_log log("ship", log_dir.path(), config);
+   eosio::state_history_log log("ship", log_dir.path(), config, compression);
 
 
    eosio::state_history_log_header header;
@@ -371,6 +422,38 @@ BOOST_AUTO_TEST_CASE(store_read_entry_prune_enabled) {
    store_read_test_case(1024, eosio::state_history::prune_config{.prune_blocks = 100});
 }
 
+#ifdef EOSIO_ZSTD_ENABLED
+BOOST_AUTO_TEST_CASE(store_read_entry_zstd) {
+   store_read_test_case(1024, {}, {.codec = eosio::state_history::compression_codec::zstd});
+}
+
+BOOST_AUTO_TEST_CASE(store_read_mixed_codecs) {
+   fc::temp_directory log_dir;
+   auto data = generate_data(1024);
+   auto write = [&](uint32_t block_num, eosio::state_history::compression_codec codec) {
+      eosio::state_history_log log("ship", log_dir.path(), {}, {.codec = codec});
+      eosio::state_history_log_header header;
+      header.block_id = block_id_for(block_num);
+      log.pack_and_write_entry(header, block_id_for(block_num - 1),
+         [&](auto&& buf) { bio::write(buf, (const char*)data.data(), data.size() * sizeof(data[0])); });
+   };
+   write(1, eosio::state_history::compression_codec::zlib);
+   write(2, eosio::state_history::compression_codec::zstd);
+   write(3, eosio::state_history::compression_codec::zlib);
+
+   // entries are read with the codec they were written with, regardless of the codec the log is opened with
+   eosio::state_history_log log("ship", log_dir.path(), {}, {.codec = eosio::state_history::compression_codec::zstd});
+   for (uint32_t block_num = 1; block_num <= 3; ++block_num) {
+      eosio::locked_decompress_stream buf = log.create_locked_decompress_stream();
+      BOOST_CHECK_EQUAL(log.get_unpacked_entry(block_num, buf), data.size() * sizeof(data[0]));
+      std::vector<char> decompressed;
+      bio::copy(*std::get<std::unique_ptr<bio::filtering_istreambuf>>(buf.buf), bio::back_inserter(decompressed));
+      BOOST_REQUIRE_EQUAL(data.size() * sizeof(data[0]), decompressed.size());
+      BOOST_CHECK(std::equal(decompressed.begin(), decompressed.end(), (const char*)data.data()));
+   }
+}
+#endif
+
 BOOST_AUTO_TEST_CASE(store_with_existing) {
    uint64_t data_size = 512;
    fc::temp_directory       log_dir;
@@ -454,6 +537,98 @@ BOOST_FIXTURE_TEST_CASE(test_session_no_prune, state_history_test_fixture) {
    FC_LOG_AND_RETHROW()
 }
 
+BOOST_FIXTURE_TEST_CASE(test_session_entry_cache, state_history_test_fixture) {
+   try {
+      server.setup_state_history_log();
+      server.session_mgr.entry_cache().set_max_size(1024 * 1024);
+      uint32_t head_block_num = 3;
+      server.block_head       = {head_block_num, block_id_for(head_block_num)};
+
+      uint32_t n = mock_state_history_plugin::default_frame_size;
+      add_to_log(1, n * sizeof(uint32_t), generate_data(n));
+      add_to_log(2, 0, generate_data(n));
+      add_to_log(3, 1, generate_data(n));
+
+      // the second request is served from the entries cached by the first
+      for (int request = 0; request < 2; ++request) {
+         send_request(eosio::state_history::get_blocks_request_v0{.start_block_num        = 1,
+                                                                  .end_block_num          = UINT32_MAX,
+                                                                  .max_messages_in_flight = 3,
+                                                                  .have_positions         = {},
+                                                                  .irreversible_only      = false,
+                                                                  .fetch_block            = true,
+                                                                  .fetch_traces           = true,
+                                                                  .fetch_deltas           = true});
+
+         eosio::state_history::state_result result;
+         for (int i = 0; i < 3; ++i) {
+            receive_result(result);
+            BOOST_REQUIRE(std::holds_alternative<eosio::state_history::get_blocks_result_v0>(result));
+            auto r = std::get<eosio::state_history::get_blocks_result_v0>(result);
+            BOOST_REQUIRE_EQUAL(r.this_block->block_num, i + 1u);
+            BOOST_REQUIRE(r.traces.has_value());
+            BOOST_REQUIRE(r.deltas.has_value());
+            auto  traces    = r.traces.value();
+            auto  deltas    = r.deltas.value();
+            auto& data      = written_data[i];
+            auto  data_size = data.size() * sizeof(int32_t);
+            BOOST_REQUIRE_EQUAL(traces.size(), data_size);
+            BOOST_REQUIRE_EQUAL(deltas.size(), data_size);
+
+            BOOST_REQUIRE(std::equal(traces.begin(), traces.end(), (const char*)data.data()));
+            BOOST_REQUIRE(std::equal(deltas.begin(), deltas.end(), (const char*)data.data()));
+         }
+      }
+   }
+   FC_LOG_AND_RETHROW()
+}
+
+BOOST_FIXTURE_TEST_CASE(test_session_filtered_entries, state_history_test_fixture) {
+   try {
+      server.setup_state_history_log();
+      uint32_t head_block_num = 2;
+      server.block_head       = {head_block_num, block_id_for(head_block_num)};
+
+      // block 1 has an entry too large to be filtered in memory, block 2 a small one
+      const std::vector<char> no_traces(1, 0);
+      std::vector<std::vector<char>> deltas_entries;
+      deltas_entries.push_back(contract_rows_entry(
+         eosio::state_history::entry_filter::max_entry_size / 1024 + 1024, 1024, "matched"_n));
+      deltas_entries.push_back(contract_rows_entry(1000, 64, "matched"_n));
+      BOOST_REQUIRE_GT(deltas_entries[0].size(), eosio::state_history::entry_filter::max_entry_size);
+      add_entries_to_log(1, no_traces, deltas_entries[0]);
+      add_entries_to_log(2, no_traces, deltas_entries[1]);
+
+      eosio::state_history::get_blocks_request_v1 req;
+      req.start_block_num        = 1;
+      req.end_block_num          = UINT32_MAX;
+      req.max_messages_in_flight = UINT32_MAX;
+      req.fetch_traces           = true;
+      req.fetch_deltas           = true;
+      req.contracts              = {"matched"_n};
+      send_request(req);
+
+      const eosio::state_history::entry_filter filter(req);
+      eosio::state_history::state_result       result;
+      for (uint32_t i = 0; i < head_block_num; ++i) {
+         receive_result(result);
+         BOOST_REQUIRE(std::holds_alternative<eosio::state_history::get_blocks_result_v0>(result));
+         auto r = std::get<eosio::state_history::get_blocks_result_v0>(result);
+         BOOST_REQUIRE_EQUAL(r.this_block->block_num, i + 1);
+         BOOST_REQUIRE(r.traces.has_value());
+         BOOST_REQUIRE(r.deltas.has_value());
+         BOOST_CHECK(*r.traces == filter.filter_traces({no_traces.data(), no_traces.size()}));
+
+         // only every 100th row is left
+         const auto& entry    = deltas_entries[i];
+         const auto  expected = filter.filter_deltas({entry.data(), entry.size()});
+         BOOST_CHECK_LT(expected.size(), entry.size() / 50);
+         BOOST_CHECK(*r.deltas == expected);
+      }
+   }
+   FC_LOG_AND_RETHROW()
+}
+
 BOOST_FIXTURE_TEST_CASE(test_split_log, state_history_test_fixture) {
    try {
       // setup block head for the server
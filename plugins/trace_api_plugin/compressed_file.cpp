@@ -2,6 +2,10 @@
 
 #include <zlib.h>
 
+#ifdef EOSIO_ZSTD_ENABLED
+#include <zstd.h>
+#endif
+
 namespace {
    using seek_point_entry = std::tuple<uint64_t, uint64_t>;
    constexpr size_t expected_seek_point_entry_size = 16;
@@ -11,6 +15,9 @@ namespace {
 
    constexpr int raw_zlib_window_bits = -15;
 
+   // every zstd frame starts with this magic number, which a raw deflate stream cannot start with
+   constexpr uint32_t zstd_frame_magic = 0xFD2FB528;
+
    // These are hard-coded expectations in the written file format
    //
    static_assert(sizeof(seek_point_entry) == expected_seek_point_entry_size, "unexpected size for seek point");
@@ -25,14 +32,56 @@ struct compressed_file_impl {
 
    ~compressed_file_impl()
    {
-      if (initialized) {
+      if (initialized && codec == compression_codec::zlib) {
          inflateEnd(&strm);
          initialized = false;
       }
+#ifdef EOSIO_ZSTD_ENABLED
+      ZSTD_freeDCtx(dctx);
+#endif
+   }
+
+   // the codec is recognized by the first bytes of the file, for zstd the seek point map is excluded from the data
+   void detect_codec( fc::cfile& file ) {
+      if (codec_detected) {
+         return;
+      }
+
+      const auto pos = file.tellp();
+      uint32_t magic = 0;
+      if (file_size >= sizeof(magic)) {
+         file.seek(0);
+         file.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+      }
+      codec = magic == zstd_frame_magic ? compression_codec::zstd : compression_codec::zlib;
+
+      if (codec == compression_codec::zstd) {
+#ifdef EOSIO_ZSTD_ENABLED
+         file.seek_end(-expected_seek_point_count_size);
+         seek_point_count_type seek_point_count = 0;
+         file.read(reinterpret_cast<char*>(&seek_point_count), sizeof(seek_point_count));
+         data_end = file_size - expected_seek_point_count_size - sizeof(seek_point_entry) * seek_point_count;
+         dctx = ZSTD_createDCtx();
+         if (!dctx) {
+            throw std::runtime_error("failed to initialize decompression");
+         }
+#else
+         throw compressed_file_error("Compressed file uses zstd which requires a build with ENABLE_ZSTD");
+#endif
+      }
+
+      file.seek(pos);
+      codec_detected = true;
    }
 
    void read( char* d, size_t n, fc::cfile& file )
    {
+      detect_codec(file);
+      if (codec == compression_codec::zstd) {
+         read_zstd(d, n, file);
+         return;
+      }
+
       if (!initialized) {
          if (Z_OK != inflateInit2(&strm, raw_zlib_window_bits)) {
             throw std::runtime_error("failed to initialize decompression");
@@ -109,11 +158,46 @@ struct compressed_file_impl {
       }
    }
 
+   void read_zstd( char* d, size_t n, fc::cfile& file ) {
+#ifdef EOSIO_ZSTD_ENABLED
+      if (!initialized) {
+         ZSTD_DCtx_reset(dctx, ZSTD_reset_session_only);
+         zstd_in = {compressed_buffer.data(), 0, 0};
+         initialized = true;
+      }
+
+      // consecutive frames are decompressed as one stream, so reads may span seek points
+      ZSTD_outBuffer out{d, n, 0};
+      while (out.pos < n) {
+         if (zstd_in.pos == zstd_in.size) {
+            const size_t remaining = data_end - file.tellp();
+            const size_t to_read = std::min(compressed_buffer.size(), remaining);
+            if (to_read > 0) {
+               file.read(reinterpret_cast<char*>(compressed_buffer.data()), to_read);
+            }
+            zstd_in = {compressed_buffer.data(), to_read, 0};
+         }
+
+         const auto out_before = out.pos;
+         const auto in_before = zstd_in.pos;
+         const auto ret = ZSTD_decompressStream(dctx, &out, &zstd_in);
+         if (ZSTD_isError(ret)) {
+            throw compressed_file_error("Error decompressing: " + std::string(ZSTD_getErrorName(ret)));
+         }
+
+         if (out.pos == out_before && zstd_in.pos == in_before) {
+            throw std::ios_base::failure("Attempting to read past the end of a compressed file");
+         }
+      }
+#endif
+   }
+
    void seek( uint64_t loc, fc::cfile& file ) {
-      if (initialized) {
+      detect_codec(file);
+      if (initialized && codec == compression_codec::zlib) {
          inflateEnd(&strm);
-         initialized = false;
       }
+      initialized = false;
 
       auto remaining = loc;
 
@@ -166,8 +250,159 @@ struct compressed_file_impl {
    size_t remaining_read_buffer = 0;
    bool initialized = false;
    size_t file_size = 0;
+
+   bool codec_detected = false;
+   compression_codec codec = compression_codec::zlib;
+#ifdef EOSIO_ZSTD_ENABLED
+   ZSTD_DCtx* dctx = nullptr;
+   ZSTD_inBuffer zstd_in = {};
+   size_t data_end = 0; // end of the zstd frames, followed by the seek point map
+#endif
 };
 
+namespace {
+   // compress input_size bytes of input_file into output_file, flushing the compressor at every seek point
+   bool compress_zlib( fc::cfile& input_file, fc::cfile& output_file, size_t input_size, size_t seek_point_stride,
+                       std::vector<seek_point_entry>& seek_point_map ) {
+      const auto seek_point_count = seek_point_map.size();
+
+      z_stream strm;
+      strm.zalloc = Z_NULL;
+      strm.zfree = Z_NULL;
+      strm.opaque = Z_NULL;
+
+      if (deflateInit2(&strm, Z_BEST_COMPRESSION, Z_DEFLATED, raw_zlib_window_bits, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+         return false;
+      }
+
+      constexpr size_t buffer_size = 64*1024;
+      auto input_buffer = std::vector<uint8_t>(buffer_size);
+      auto output_buffer = std::vector<uint8_t>(buffer_size);
+
+      auto bytes_remaining_before_sync = seek_point_stride;
+      size_t next_sync_point = 0;
+
+      // process a single chunk of input completely,
+      // this may sometime loop multiple times if the compressor state combined with input data creates more than a
+      // single buffer's worth of data
+      //
+      auto process_chunk = [&]( size_t input_size, int mode ) {
+         strm.avail_in = input_size;
+         strm.next_in = input_buffer.data();
+
+         do {
+            strm.avail_out = output_buffer.size();
+            strm.next_out = output_buffer.data();
+            auto ret = deflate(&strm, mode);
+
+            const bool success = ret == Z_OK || (mode == Z_FINISH && ret == Z_STREAM_END);
+            if (!success) {
+               return ret;
+            }
+
+            output_file.write(reinterpret_cast<const char*>(output_buffer.data()), output_buffer.size() - strm.avail_out);
+         } while (strm.avail_out == 0);
+
+         return Z_OK;
+      };
+
+      size_t read_offset = 0;
+      while (read_offset < input_size) {
+         const auto bytes_remaining = input_size - read_offset;
+         const auto read_size = std::min({ buffer_size, bytes_remaining, bytes_remaining_before_sync });
+         input_file.read(reinterpret_cast<char*>(input_buffer.data()), read_size);
+
+         auto ret = process_chunk(read_size, Z_NO_FLUSH);
+         if (ret != Z_OK) {
+            throw compressed_file_error(std::string("deflate failed: ") + std::to_string(ret));
+         }
+         read_offset += read_size;
+
+         if (read_size == bytes_remaining ) {
+            // finish the file out by draining remaining output
+            ret = process_chunk(0, Z_FINISH);
+            if (ret != Z_OK) {
+               throw compressed_file_error(std::string("failed to finalize file compression: ") + std::to_string(ret));
+            }
+         } else if ( read_size == bytes_remaining_before_sync ) {
+            // create a sync point by flushing the compressor so a decompressor can start at this offset
+            ret = process_chunk(0, Z_FULL_FLUSH);
+            if (ret != Z_OK) {
+               throw compressed_file_error(std::string("failed to create sync point: ") + std::to_string(ret));
+            }
+
+            seek_point_map.at(next_sync_point++) = {read_offset, output_file.tellp()};
+
+            if (next_sync_point == seek_point_count) {
+               // if we are out of sync points, set this value one past the end (disabling it)
+               bytes_remaining_before_sync = input_size - read_offset + 1;
+            } else {
+               bytes_remaining_before_sync = seek_point_stride;
+            }
+         } else {
+            bytes_remaining_before_sync -= read_size;
+         }
+      }
+
+      deflateEnd(&strm);
+      return true;
+   }
+
+   // compress input_size bytes of input_file into output_file, as one independent frame per seek point stride
+   bool compress_zstd( fc::cfile& input_file, fc::cfile& output_file, size_t input_size, size_t seek_point_stride,
+                       std::vector<seek_point_entry>& seek_point_map ) {
+#ifdef EOSIO_ZSTD_ENABLED
+      std::unique_ptr<ZSTD_CCtx, decltype(&ZSTD_freeCCtx)> cctx(ZSTD_createCCtx(), &ZSTD_freeCCtx);
+      if (!cctx) {
+         return false;
+      }
+
+      constexpr size_t buffer_size = 64*1024;
+      auto input_buffer = std::vector<char>(buffer_size);
+      auto output_buffer = std::vector<char>(ZSTD_CStreamOutSize());
+
+      size_t next_sync_point = 0;
+      size_t bytes_remaining_in_frame = seek_point_stride;
+      size_t read_offset = 0;
+      while (read_offset < input_size) {
+         const auto read_size = std::min({ buffer_size, input_size - read_offset, bytes_remaining_in_frame });
+         input_file.read(input_buffer.data(), read_size);
+         read_offset += read_size;
+         bytes_remaining_in_frame -= read_size;
+
+         const bool end_frame = bytes_remaining_in_frame == 0 || read_offset == input_size;
+         ZSTD_inBuffer in{input_buffer.data(), read_size, 0};
+         size_t frame_remaining = 0;
+         do {
+            ZSTD_outBuffer out{output_buffer.data(), output_buffer.size(), 0};
+            frame_remaining = ZSTD_compressStream2(cctx.get(), &out, &in, end_frame ? ZSTD_e_end : ZSTD_e_continue);
+            if (ZSTD_isError(frame_remaining)) {
+               throw compressed_file_error(std::string("zstd compression failed: ") + ZSTD_getErrorName(frame_remaining));
+            }
+            output_file.write(output_buffer.data(), out.pos);
+         } while (end_frame ? frame_remaining != 0 : in.pos < in.size);
+
+         if (end_frame && read_offset < input_size) {
+            // the next frame is a seek point, it can be decompressed without any of the prior data
+            seek_point_map.at(next_sync_point++) = {read_offset, output_file.tellp()};
+            bytes_remaining_in_frame = seek_point_stride;
+         }
+      }
+      return true;
+#else
+      throw compressed_file_error("zstd compression requires a build with ENABLE_ZSTD");
+#endif
+   }
+}
+
+bool is_supported( compression_codec codec ) {
+#ifdef EOSIO_ZSTD_ENABLED
+   return true;
+#else
+   return codec != compression_codec::zstd;
+#endif
+}
+
 compressed_file::compressed_file( std::filesystem::path file_path )
 :file_path(std::move(file_path))
 ,file_ptr(nullptr)
@@ -196,7 +431,7 @@ compressed_file::compressed_file( compressed_file&& ) = default;
 compressed_file& compressed_file::operator= ( compressed_file&& ) = default;
 
 
-bool compressed_file::process( const std::filesystem::path& input_path, const std::filesystem::path& output_path, size_t seek_point_stride  ) {
+bool compressed_file::process( const std::filesystem::path& input_path, const std::filesystem::path& output_path, size_t seek_point_stride, compression_codec codec ) {
    if (!std::filesystem::exists(input_path)) {
       throw std::ios_base::failure(std::string("Attempting to create compressed_file from file that does not exist: ") + input_path.generic_string());
    }
@@ -221,85 +456,12 @@ bool compressed_file::process( const std::filesystem::path& input_path, const st
    output_file.set_file_path(output_path);
    output_file.open("wb");
 
-   z_stream strm;
-   strm.zalloc = Z_NULL;
-   strm.zfree = Z_NULL;
-   strm.opaque = Z_NULL;
-
-   if (deflateInit2(&strm, Z_BEST_COMPRESSION, Z_DEFLATED, raw_zlib_window_bits, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+   const bool compressed = codec == compression_codec::zstd
+                           ? compress_zstd(input_file, output_file, input_size, seek_point_stride, seek_point_map)
+                           : compress_zlib(input_file, output_file, input_size, seek_point_stride, seek_point_map);
+   if (!compressed) {
       return false;
    }
-
-   constexpr size_t buffer_size = 64*1024;
-   auto input_buffer = std::vector<uint8_t>(buffer_size);
-   auto output_buffer = std::vector<uint8_t>(buffer_size);
-
-   auto bytes_remaining_before_sync = seek_point_stride;
-   size_t next_sync_point = 0;
-
-   // process a single chunk of input completely,
-   // this may sometime loop multiple times if the compressor state combined with input data creates more than a
-   // single buffer's worth of data
-   //
-   auto process_chunk = [&]( size_t input_size, int mode ) {
-      strm.avail_in = input_size;
-      strm.next_in = input_buffer.data();
-
-      do {
-         strm.avail_out = output_buffer.size();
-         strm.next_out = output_buffer.data();
-         auto ret = deflate(&strm, mode);
-
-         const bool success = ret == Z_OK || (mode == Z_FINISH && ret == Z_STREAM_END);
-         if (!success) {
-            return ret;
-         }
-
-         output_file.write(reinterpret_cast<const char*>(output_buffer.data()), output_buffer.size() - strm.avail_out);
-      } while (strm.avail_out == 0);
-
-      return Z_OK;
-   };
-
-   size_t read_offset = 0;
-   while (read_offset < input_size) {
-      const auto bytes_remaining = input_size - read_offset;
-      const auto read_size = std::min({ buffer_size, bytes_remaining, bytes_remaining_before_sync });
-      input_file.read(reinterpret_cast<char*>(input_buffer.data()), read_size);
-
-      auto ret = process_chunk(read_size, Z_NO_FLUSH);
-      if (ret != Z_OK) {
-         throw compressed_file_error(std::string("deflate failed: ") + std::to_string(ret));
-      }
-      read_offset += read_size;
-
-      if (read_size == bytes_remaining ) {
-         // finish the file out by draining remaining output
-         ret = process_chunk(0, Z_FINISH);
-         if (ret != Z_OK) {
-            throw compressed_file_error(std::string("failed to finalize file compression: ") + std::to_string(ret));
-         }
-      } else if ( read_size == bytes_remaining_before_sync ) {
-         // create a sync point by flushing the compressor so a decompressor can start at this offset
-         ret = process_chunk(0, Z_FULL_FLUSH);
-         if (ret != Z_OK) {
-            throw compressed_file_error(std::string("failed to create sync point: ") + std::to_string(ret));
-         }
-
-         seek_point_map.at(next_sync_point++) = {read_offset, output_file.tellp()};
-
-         if (next_sync_point == seek_point_count) {
-            // if we are out of sync points, set this value one past the end (disabling it)
-            bytes_remaining_before_sync = input_size - read_offset + 1;
-         } else {
-            bytes_remaining_before_sync = seek_point_stride;
-         }
-      } else {
-         bytes_remaining_before_sync -= read_size;
-      }
-   }
-
-   deflateEnd(&strm);
    input_file.close();
 
    // write out the seek point table
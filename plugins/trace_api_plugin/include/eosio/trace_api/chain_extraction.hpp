@@ -3,9 +3,12 @@
 #include <eosio/trace_api/common.hpp>
 #include <eosio/trace_api/trace.hpp>
 #include <eosio/trace_api/extract_util.hpp>
+#include <eosio/chain/thread_utils.hpp>
+#include <condition_variable>
 #include <exception>
 #include <functional>
 #include <map>
+#include <mutex>
 
 namespace eosio { namespace trace_api {
 
@@ -15,15 +18,41 @@ using chain::packed_transaction;
 template <typename StoreProvider>
 class chain_extraction_impl_type {
 public:
+   /// called by the thread appending with the block number, the time the conversion and appends of the block took and
+   /// the number of blocks still waiting to be written
+   using append_metrics_handler = std::function<void(uint32_t block_num, fc::microseconds append_time, uint32_t queued_blocks)>;
+
    /**
     * Chain Extractor for capturing transaction traces, action traces, and block info.
     * @param store provider of append & append_lib
     * @param except_handler called on exceptions, logging if any is left to the user
+    * @param max_queued_blocks if non-zero, traces are converted and appended on a dedicated writer thread and the
+    *        signals block while this many blocks are waiting to be written; 0 converts and appends within the signals
+    * @param metrics_handler optional, see append_metrics_handler
     */
-   chain_extraction_impl_type( StoreProvider store, exception_handler except_handler )
+   chain_extraction_impl_type( StoreProvider store, exception_handler except_handler, uint32_t max_queued_blocks = 0,
+                               append_metrics_handler metrics_handler = {} )
    : store(std::move(store))
    , except_handler(std::move(except_handler))
-   {}
+   , max_queued_blocks(max_queued_blocks)
+   , metrics_handler(std::move(metrics_handler))
+   {
+      if( max_queued_blocks ) {
+         writer_thread.start( 1, [this]( const fc::exception& e ) {
+            set_write_failure( MAKE_EXCEPTION_WITH_CONTEXT( std::make_exception_ptr( e ) ) );
+         } );
+      }
+   }
+
+   ~chain_extraction_impl_type() {
+      stop();
+   }
+
+   /// wait for the queued blocks to be written and stop the writer thread, the store is not used afterwards
+   void stop() {
+      wait_for_queued_blocks( 0 );
+      writer_thread.stop();
+   }
 
    /// connect to chain controller applied_transaction signal
    void signal_applied_transaction( const chain::transaction_trace_ptr& trace, const chain::packed_transaction_ptr& ptrx ) {
@@ -64,11 +93,24 @@ private:
    }
 
    void on_accepted_block(const chain::signed_block_ptr& block, const chain::block_id_type& id ) {
-      store_block_trace( block, id );
+      report_write_failure();
+      std::optional<pending_block> pb;
+      try {
+         pb = capture_block( block, id );
+      } catch( ... ) {
+         except_handler( MAKE_EXCEPTION_WITH_CONTEXT( std::current_exception() ) );
+         return;
+      }
+      write( [this, pb = std::move( *pb )]() mutable {
+         store_block_trace( std::move( pb ) );
+      } );
    }
 
    void on_irreversible_block( uint32_t block_num ) {
-      store_lib( block_num );
+      report_write_failure();
+      write( [this, block_num]() {
+         store_lib( block_num );
+      } );
    }
 
    void on_block_start( uint32_t block_num ) {
@@ -80,49 +122,139 @@ private:
       onblock_trace.reset();
    }
 
-   void store_block_trace( const chain::signed_block_ptr& block, const chain::block_id_type& id ) {
-      try {
-         using transaction_trace_t = transaction_trace_v3;
-         auto bt = create_block_trace( block, id );
-
-         std::vector<transaction_trace_t> traces;
-         traces.reserve( block->transactions.size() + 1 );
-         block_trxs_entry tt;
-         tt.ids.reserve(block->transactions.size() + 1);
-         if( onblock_trace )
-            traces.emplace_back( to_transaction_trace<transaction_trace_t>( *onblock_trace ));
-         for( const auto& r : block->transactions ) {
-            transaction_id_type id;
-            if( std::holds_alternative<transaction_id_type>(r.trx)) {
-               id = std::get<transaction_id_type>(r.trx);
-            } else {
-               id = std::get<packed_transaction>(r.trx).id();
-            }
-            const auto it = cached_traces.find( id );
-            if( it != cached_traces.end() ) {
-               traces.emplace_back( to_transaction_trace<transaction_trace_t>( it->second ));
-            }
-            tt.ids.emplace_back(id);
+   /// everything of a block the writer needs, captured on the thread emitting the signals before the caches are reused
+   struct pending_block {
+      chain::signed_block_ptr  block;
+      chain::block_id_type     id;
+      std::vector<cache_trace> traces; // onblock first, then in block order
+      block_trxs_entry         tt;
+   };
+
+   pending_block capture_block( const chain::signed_block_ptr& block, const chain::block_id_type& id ) {
+      pending_block pb{ .block = block, .id = id };
+      pb.traces.reserve( block->transactions.size() + 1 );
+      pb.tt.ids.reserve( block->transactions.size() + 1 );
+      if( onblock_trace )
+         pb.traces.emplace_back( std::move( *onblock_trace ));
+      for( const auto& r : block->transactions ) {
+         transaction_id_type id;
+         if( std::holds_alternative<transaction_id_type>(r.trx)) {
+            id = std::get<transaction_id_type>(r.trx);
+         } else {
+            id = std::get<packed_transaction>(r.trx).id();
+         }
+         const auto it = cached_traces.find( id );
+         if( it != cached_traces.end() ) {
+            pb.traces.emplace_back( std::move( it->second ));
          }
-         bt.transactions = std::move( traces );
-         clear_caches();
+         pb.tt.ids.emplace_back(id);
+      }
+      clear_caches();
+      // tt entry acts as a placeholder in a trx id slice if this block has no transaction
+      pb.tt.block_num = block->block_num();
+      return pb;
+   }
 
-         // tt entry acts as a placeholder in a trx id slice if this block has no transaction
-         tt.block_num = bt.number;
-         store.append_trx_ids( std::move(tt) );
+   // converts and appends the traces of a block, called on the writer thread if there is one
+   void store_block_trace( pending_block&& pb ) {
+      const auto start = fc::time_point::now();
+      using transaction_trace_t = transaction_trace_v3;
+      auto bt = create_block_trace( pb.block, pb.id );
 
-         store.append( std::move( bt ) );
-      } catch( ... ) {
-         except_handler( MAKE_EXCEPTION_WITH_CONTEXT( std::current_exception() ) );
+      std::vector<transaction_trace_t> traces;
+      traces.reserve( pb.traces.size() );
+      for( const auto& t : pb.traces ) {
+         traces.emplace_back( to_transaction_trace<transaction_trace_t>( t ));
+      }
+      bt.transactions = std::move( traces );
+
+      store.append_trx_ids( std::move(pb.tt) );
+
+      store.append( std::move( bt ) );
+
+      if( metrics_handler ) {
+         uint32_t queued = 0;
+         if( max_queued_blocks ) {
+            std::lock_guard g( queue_mtx );
+            queued = queued_blocks - 1; // not counting this block
+         }
+         metrics_handler( pb.block->block_num(), fc::time_point::now() - start, queued );
       }
    }
 
    void store_lib( uint32_t block_num ) {
-      try {
-         store.append_lib( block_num );
-      } catch( ... ) {
-         except_handler( MAKE_EXCEPTION_WITH_CONTEXT( std::current_exception() ) );
+      store.append_lib( block_num );
+   }
+
+   // runs f within the signal or queues it for the writer thread, waiting while max_queued_blocks are queued
+   template <typename F>
+   void write( F&& f ) {
+      if( !max_queued_blocks ) {
+         try {
+            f();
+         } catch( ... ) {
+            except_handler( MAKE_EXCEPTION_WITH_CONTEXT( std::current_exception() ) );
+         }
+         return;
+      }
+
+      {
+         std::unique_lock g( queue_mtx );
+         queue_cv.wait( g, [&]() { return queued_blocks < max_queued_blocks; } );
+         ++queued_blocks;
+      }
+      boost::asio::post( writer_thread.get_executor(), [this, f = std::forward<F>(f)]() mutable {
+         bool failed;
+         {
+            std::lock_guard g( queue_mtx );
+            failed = write_failed;
+         }
+         // once a write failed, later blocks are dropped so that the store is left without gaps
+         if( !failed ) {
+            try {
+               f();
+            } catch( ... ) {
+               set_write_failure( MAKE_EXCEPTION_WITH_CONTEXT( std::current_exception() ) );
+            }
+         }
+         {
+            std::lock_guard g( queue_mtx );
+            --queued_blocks;
+         }
+         queue_cv.notify_all();
+      } );
+   }
+
+   void wait_for_queued_blocks( uint32_t max_queued ) {
+      std::unique_lock g( queue_mtx );
+      queue_cv.wait( g, [&]() { return queued_blocks <= max_queued; } );
+   }
+
+   // exception_with_context refers to the exception_ptr, keep a copy until it is reported
+   struct write_failure_t {
+      std::exception_ptr eptr;
+      const char*        file;
+      uint64_t           line;
+      const char*        func;
+   };
+
+   void set_write_failure( const exception_with_context& e ) {
+      std::lock_guard g( queue_mtx );
+      write_failed = true;
+      if( !write_failure )
+         write_failure = write_failure_t{ std::get<0>(e), std::get<1>(e), std::get<2>(e), std::get<3>(e) };
+   }
+
+   // a failure of the writer thread is reported to except_handler by the next signal
+   void report_write_failure() {
+      std::optional<write_failure_t> failure;
+      {
+         std::lock_guard g( queue_mtx );
+         failure = std::move( write_failure );
+         write_failure.reset();
       }
+      if( failure )
+         except_handler( exception_with_context( failure->eptr, failure->file, failure->line, failure->func ));
    }
 
 private:
@@ -131,6 +263,15 @@ private:
    std::map<transaction_id_type, cache_trace>                   cached_traces;
    std::optional<cache_trace>                                   onblock_trace;
 
+   const uint32_t                                               max_queued_blocks;
+   append_metrics_handler                                       metrics_handler;
+   // single thread so that blocks and lib are appended in order
+   chain::named_thread_pool<struct tracew>                      writer_thread;
+   std::mutex                                                   queue_mtx;
+   std::condition_variable                                      queue_cv;
+   uint32_t                                                     queued_blocks = 0;  // protected by queue_mtx
+   std::optional<write_failure_t>                               write_failure;      // protected by queue_mtx, not reported yet
+   bool                                                         write_failed = false; // protected by queue_mtx
 };
 
 }}
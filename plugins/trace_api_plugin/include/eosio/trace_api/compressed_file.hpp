@@ -7,6 +7,17 @@ namespace eosio::trace_api {
 
    class compressed_file_datastream;
    struct compressed_file_impl;
+
+   /**
+    * Codec of the compressed data of a compressed_file, recognized when reading so files of both codecs can be mixed
+    */
+   enum class compression_codec {
+      zlib, // raw deflate stream, fully flushed at every seek point
+      zstd  // one independent frame per seek point, requires a build with ENABLE_ZSTD
+   };
+
+   /// false for zstd when built without ENABLE_ZSTD
+   bool is_supported( compression_codec codec );
    /**
     * wrapper for read-only access to a compressed file.
     * compressed files support seeking and reading
@@ -40,7 +51,7 @@ namespace eosio::trace_api {
     * seek points should be traversable by a decompressor so that reads which span
     * seek points do not have to be aware of them
     *
-    * In zlib this is created by doing a complete flush of the stream
+    * In zlib this is created by doing a complete flush of the stream, in zstd by starting a new frame
     */
    class compressed_file {
    public:
@@ -113,11 +124,13 @@ namespace eosio::trace_api {
        * @param input_path - the path to the input file
        * @param output_path - the path to write the output file to (overwriting an existing file at that path)
        * @param seek_point_stride - the number of uncompressed bytes between seek points
+       * @param codec - the codec to compress the data with
        * @return true if successful, false if there was no error but the process could not complete
        * @throws std::ios_base::failure if the input_path does not exist or the output_path cannot be written to
        * @throws compressed_file_error if there is an issue during compression of the data stream
        */
-      static bool process( const std::filesystem::path& input_path, const std::filesystem::path& output_path, size_t seek_point_stride );
+      static bool process( const std::filesystem::path& input_path, const std::filesystem::path& output_path, size_t seek_point_stride,
+                           compression_codec codec = compression_codec::zlib );
 
    private:
       std::filesystem::path file_path;
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <fc/variant.hpp>
+#include <fc/io/json.hpp>
+#include <fc/io/raw.hpp>
 #include <eosio/trace_api/metadata_log.hpp>
 #include <eosio/trace_api/data_log.hpp>
 #include <eosio/trace_api/common.hpp>
@@ -8,10 +10,38 @@
 namespace eosio::trace_api {
    using data_handler_function = std::function<std::tuple<fc::variant, std::optional<fc::variant>>( const std::variant<action_trace_v0, action_trace_v1> & action_trace_t)>;
 
+   /**
+    * Selects the actions of a bulk export: an action is selected if its receiver or account is one of accounts and its
+    * name is one of actions, an empty list matches everything.
+    */
+   class export_filter {
+   public:
+      export_filter() = default;
+      export_filter(std::vector<chain::name> accounts, std::vector<chain::name> actions);
+
+      bool empty() const { return _accounts.empty() && _actions.empty(); }
+      bool match(chain::name receiver, chain::name account, chain::name action) const;
+
+   private:
+      std::vector<chain::name> _accounts; // sorted
+      std::vector<chain::name> _actions;  // sorted
+   };
+
+   enum class export_format {
+      ndjson, ///< one line per block, the JSON of get_block_trace
+      binary  ///< per block a uint32_t size, a uint8_t irreversible flag and the packed data_log_entry of that size
+   };
+
    namespace detail {
       class response_formatter {
       public:
          static fc::variant process_block( const data_log_entry& trace, bool irreversible, const data_handler_function& data_handler );
+
+         /**
+          * Remove the actions of trace not selected by filter, and the transactions left without actions
+          * @return false if no transaction is left
+          */
+         static bool filter_block( data_log_entry& trace, const export_filter& filter );
       };
    }
 
@@ -42,13 +72,48 @@ namespace eosio::trace_api {
             return {};
          }
 
-         auto data_handler = [this](const auto& action) -> std::tuple<fc::variant, std::optional<fc::variant>> {
-            return std::visit([&](const auto& action_trace_t) {
-               return data_handler_provider.serialize_to_variant(action_trace_t);
-            }, action);
-         };
+         return detail::response_formatter::process_block(std::get<0>(*data), std::get<1>(*data), make_data_handler());
+      }
 
-         return detail::response_formatter::process_block(std::get<0>(*data), std::get<1>(*data), data_handler);
+      /**
+       * Export the traces of the blocks in [start_block, end_block) in block order, for bulk retrieval. The blocks are
+       * read sequentially from the store and formatted in pieces of about chunk_size bytes, see export_format. Blocks
+       * missing from the store are skipped, as are blocks without a selected action when filter is not empty.
+       *
+       * @return a producer which sets its argument to the next piece and returns false with the last one. It reads
+       * the store as it is called and must not outlive this request_handler.
+       */
+      std::function<bool(std::string&)> export_blocks( uint32_t start_block, uint32_t end_block, export_filter filter,
+                                                       export_format format, size_t chunk_size ) {
+         _log("export_blocks called for [" + std::to_string(start_block) + ", " + std::to_string(end_block) + ")");
+         auto reader = std::make_shared<decltype(logfile_provider.read_block_range(start_block, end_block))>(
+            logfile_provider.read_block_range(start_block, end_block));
+         return [this, reader, filter=std::move(filter), format, chunk_size](std::string& chunk) {
+            chunk.clear();
+            while (chunk.size() < chunk_size) {
+               auto data = reader->next();
+               if (!data) {
+                  return false;
+               }
+               auto& [entry, irreversible] = *data;
+               if (!filter.empty() && !detail::response_formatter::filter_block(entry, filter)) {
+                  continue;
+               }
+               if (format == export_format::binary) {
+                  const auto packed = fc::raw::pack(entry);
+                  const uint32_t size = packed.size();
+                  const uint8_t irreversible_flag = irreversible ? 1 : 0;
+                  chunk.append(reinterpret_cast<const char*>(&size), sizeof(size));
+                  chunk.append(reinterpret_cast<const char*>(&irreversible_flag), sizeof(irreversible_flag));
+                  chunk.append(packed.data(), packed.size());
+               } else {
+                  chunk += fc::json::to_string(detail::response_formatter::process_block(entry, irreversible, make_data_handler()),
+                                               fc::time_point::maximum());
+                  chunk += '\n';
+               }
+            }
+            return true;
+         };
       }
 
       /**
@@ -90,6 +155,14 @@ namespace eosio::trace_api {
       }
 
    private:
+      data_handler_function make_data_handler() {
+         return [this](const auto& action) -> std::tuple<fc::variant, std::optional<fc::variant>> {
+            return std::visit([&](const auto& action_trace_t) {
+               return data_handler_provider.serialize_to_variant(action_trace_t);
+            }, action);
+         };
+      }
+
       LogfileProvider logfile_provider;
       DataHandlerProvider data_handler_provider;
       log_handler _log;
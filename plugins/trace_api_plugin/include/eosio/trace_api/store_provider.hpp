@@ -4,6 +4,7 @@
 #include <thread>
 #include <mutex>
 #include <condition_variable>
+#include <map>
 #include <fc/io/cfile.hpp>
 #include <fc/variant.hpp>
 #include <eosio/trace_api/common.hpp>
@@ -87,6 +88,15 @@ namespace eosio::trace_api {
 
    class store_provider;
 
+   /**
+    * How the maintenance thread compresses irreversible trace slices
+    */
+   struct slice_compression_options {
+      compression_codec     codec = compression_codec::zlib;
+      uint32_t              threads = 1;  ///< number of slices compressed in parallel
+      std::filesystem::path cold_dir;     ///< if not empty, compressed slices are written here instead of the slice directory
+   };
+
    /**
     * Provides access to the slice directory.  It is only intended to be used by store_provider
     * and unit tests.
@@ -99,7 +109,8 @@ namespace eosio::trace_api {
 
       enum class open_state { read /*read from front to back*/, write /*write to end of file*/ };
       slice_directory(const std::filesystem::path& slice_dir, uint32_t width, std::optional<uint32_t> minimum_irreversible_history_blocks,
-                      std::optional<uint32_t> minimum_uncompressed_irreversible_history_blocks, size_t compression_seek_point_stride);
+                      std::optional<uint32_t> minimum_uncompressed_irreversible_history_blocks, size_t compression_seek_point_stride,
+                      slice_compression_options compression = {});
 
       /**
        * Return the slice number that would include the passed in block_height
@@ -111,6 +122,13 @@ namespace eosio::trace_api {
          return block_height / _width;
       }
 
+      /**
+       * @return the number of blocks in each slice
+       */
+      uint32_t width() const {
+         return _width;
+      }
+
       /**
        * Find or create the index file associated with the indicated slice_number
        *
@@ -160,7 +178,8 @@ namespace eosio::trace_api {
       bool find_trace_slice(uint32_t slice_number, open_state state, fc::cfile& trace_file, bool open_file = true) const;
 
       /**
-       * Find the read-only compressed trace file associated with the indicated slice_number
+       * Find the read-only compressed trace file associated with the indicated slice_number, looking in the slice
+       * directory first and then in the cold directory
        *
        * @param slice_number : slice number of the requested slice file
        * @param open_file : indicate if the file should be opened (if found) or not
@@ -226,6 +245,13 @@ namespace eosio::trace_api {
        */
       void run_maintenance_tasks(uint32_t lib, const log_handler& log);
 
+      /**
+       * Compress the trace file of a slice, if it exists, and remove it once the compressed file is complete
+       *
+       * @param slice_number : slice number of the slice to compress
+       */
+      void compress_slice(uint32_t slice_number, const log_handler& log) const;
+
    private:
       // returns true if slice is found, slice_file will always be set to the appropriate path for
       // the slice_prefix and slice_number, but will only be opened if found
@@ -248,6 +274,7 @@ namespace eosio::trace_api {
       const std::optional<uint32_t> _minimum_uncompressed_irreversible_history_blocks;
       std::optional<uint32_t> _last_compressed_slice;
       const size_t _compression_seek_point_stride;
+      const slice_compression_options _compression;
 
       std::mutex _maintenance_mtx;
       std::condition_variable _maintenance_condition;
@@ -256,6 +283,42 @@ namespace eosio::trace_api {
       uint32_t _best_known_lib{0};
    };
 
+   /**
+    * Reads the block traces of a range of blocks in block order, for bulk exports. Unlike store_provider::get_block,
+    * which scans the index slice for every block, the index of each slice is read once and its trace file, plain or
+    * compressed, is kept open and read front to back.
+    *
+    * Blocks missing from the store are skipped. Slices missing before the first slice found are assumed pruned, the
+    * first slice missing after it ends the range.
+    */
+   class block_range_reader {
+   public:
+      block_range_reader(const slice_directory& slice_directory, uint32_t start_block, uint32_t end_block);
+
+      /**
+       * Read the next block of the range
+       * @return empty optional once the range is exhausted OTHERWISE
+       *         optional containing a 2-tuple of the block_trace and a flag indicating irreversibility
+       */
+      get_block_t next(const yield_function& yield = {});
+
+   private:
+      // returns false if the slice does not exist
+      bool load_slice(uint32_t slice_number, const yield_function& yield);
+      data_log_entry read_data_log(uint64_t offset);
+
+      const slice_directory& _slice_directory;
+      uint32_t _next_block;
+      const uint32_t _end_block;
+      std::optional<uint32_t> _slice;              // slice currently loaded
+      bool _found_slice = false;                   // a slice of the range has been found
+      std::map<uint32_t, uint64_t> _offsets;      // block number -> trace offset in the loaded slice, latest entry wins
+      uint32_t _lib = 0;                           // highest lib recorded in the loaded slice
+      fc::cfile _trace;
+      std::optional<compressed_file> _ctrace;
+      std::optional<uint64_t> _position;           // offset following the last entry read, avoids seeks when sequential
+   };
+
    /**
     * Provides read and write access to block trace data.
     */
@@ -264,7 +327,8 @@ namespace eosio::trace_api {
       using open_state = slice_directory::open_state;
 
       store_provider(const std::filesystem::path& slice_dir, uint32_t stride_width, std::optional<uint32_t> minimum_irreversible_history_blocks,
-            std::optional<uint32_t> minimum_uncompressed_irreversible_history_blocks, size_t compression_seek_point_stride);
+            std::optional<uint32_t> minimum_uncompressed_irreversible_history_blocks, size_t compression_seek_point_stride,
+            slice_compression_options compression = {});
 
       template<typename BlockTrace>
       void append(const BlockTrace& bt);
@@ -281,6 +345,13 @@ namespace eosio::trace_api {
 
       get_block_n get_trx_block_number(const chain::transaction_id_type& trx_id, std::optional<uint32_t> minimum_irreversible_history_blocks, const yield_function& yield= {});
 
+      /**
+       * Sequential reader of the traces of the blocks in [start_block, end_block), see block_range_reader
+       */
+      block_range_reader read_block_range(uint32_t start_block, uint32_t end_block) const {
+         return block_range_reader(_slice_directory, start_block, end_block);
+      }
+
       void start_maintenance_thread( log_handler log ) {
          _slice_directory.start_maintenance_thread( std::move(log) );
       }
@@ -3,6 +3,8 @@
 #include <eosio/chain_plugin/chain_plugin.hpp>
 #include <eosio/http_plugin/http_plugin.hpp>
 
+#include <mutex>
+
 namespace eosio {
    /**
     * Plugin that runs both a data extraction  and the HTTP RPC in the same application
@@ -22,9 +24,22 @@ namespace eosio {
 
       void handle_sighup() override;
 
+      struct append_metrics {
+         uint32_t block_num      = 0;
+         int64_t  append_time_us = 0; // converting the traces of the block and appending them to the slice files
+         uint32_t queued_blocks  = 0; // blocks waiting to be written after this one
+      };
+
+      /// called from the thread writing the traces, once per block; may be registered while it runs
+      void register_update_append_metrics(std::function<void(append_metrics)>&&);
+
    private:
+      friend struct trace_api_plugin_impl;
+
       std::shared_ptr<struct trace_api_plugin_impl>     my;
       std::shared_ptr<struct trace_api_rpc_plugin_impl> rpc;
+      std::mutex                                        update_append_metrics_mtx;
+      std::function<void(append_metrics)>               update_append_metrics; // guarded by update_append_metrics_mtx
    };
 
    /**
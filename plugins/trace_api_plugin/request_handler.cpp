@@ -154,4 +154,61 @@ namespace eosio::trace_api::detail {
           return fc::mutable_variant_object();
        }
     }
+
+    namespace {
+       template<typename ActionTrace>
+       void filter_actions( std::vector<ActionTrace>& actions, const export_filter& filter ) {
+          std::erase_if(actions, [&filter](const ActionTrace& a) {
+             return !filter.match(a.receiver, a.account, a.action);
+          });
+       }
+
+       template<typename TransactionTrace>
+       bool filter_transactions( std::vector<TransactionTrace>& transactions, const export_filter& filter ) {
+          std::erase_if(transactions, [&filter](TransactionTrace& t) {
+             if constexpr(std::is_same_v<TransactionTrace, transaction_trace_v0> || std::is_same_v<TransactionTrace, transaction_trace_v1>) {
+                filter_actions(t.actions, filter);
+                return t.actions.empty();
+             } else {
+                return std::visit([&filter](auto& actions) {
+                   filter_actions(actions, filter);
+                   return actions.empty();
+                }, t.actions);
+             }
+          });
+          return !transactions.empty();
+       }
+    }
+
+    bool response_formatter::filter_block( data_log_entry& trace, const export_filter& filter ) {
+       if (std::holds_alternative<block_trace_v0>(trace)) {
+          return filter_transactions(std::get<block_trace_v0>(trace).transactions, filter);
+       } else if (std::holds_alternative<block_trace_v1>(trace)) {
+          auto& block_trace = std::get<block_trace_v1>(trace);
+          filter_transactions(block_trace.transactions, filter);
+          return filter_transactions(block_trace.transactions_v1, filter);
+       } else if (std::holds_alternative<block_trace_v2>(trace)) {
+          return std::visit([&filter](auto& transactions) {
+             return filter_transactions(transactions, filter);
+          }, std::get<block_trace_v2>(trace).transactions);
+       }
+       return false;
+    }
+}
+
+namespace eosio::trace_api {
+   export_filter::export_filter(std::vector<chain::name> accounts, std::vector<chain::name> actions)
+   :_accounts(std::move(accounts))
+   ,_actions(std::move(actions))
+   {
+      std::sort(_accounts.begin(), _accounts.end());
+      std::sort(_actions.begin(), _actions.end());
+   }
+
+   bool export_filter::match(chain::name receiver, chain::name account, chain::name action) const {
+      const bool account_match = _accounts.empty() ||
+                                 std::binary_search(_accounts.begin(), _accounts.end(), receiver) ||
+                                 std::binary_search(_accounts.begin(), _accounts.end(), account);
+      return account_match && (_actions.empty() || std::binary_search(_actions.begin(), _actions.end(), action));
+   }
 }
@@ -3,6 +3,11 @@
 #include <fc/variant_object.hpp>
 #include <fc/log/logger_config.hpp>
 
+#include <algorithm>
+#include <atomic>
+
+#include <fcntl.h>
+
 namespace {
       static constexpr uint32_t _current_version = 1;
       static constexpr const char* _trace_prefix = "trace_";
@@ -31,8 +36,9 @@ namespace {
 
 namespace eosio::trace_api {
       store_provider::store_provider(const std::filesystem::path& slice_dir, uint32_t stride_width, std::optional<uint32_t> minimum_irreversible_history_blocks,
-                                  std::optional<uint32_t> minimum_uncompressed_irreversible_history_blocks, size_t compression_seek_point_stride)
-   : _slice_directory(slice_dir, stride_width, minimum_irreversible_history_blocks, minimum_uncompressed_irreversible_history_blocks, compression_seek_point_stride) {
+                                  std::optional<uint32_t> minimum_uncompressed_irreversible_history_blocks, size_t compression_seek_point_stride,
+                                  slice_compression_options compression)
+   : _slice_directory(slice_dir, stride_width, minimum_irreversible_history_blocks, minimum_uncompressed_irreversible_history_blocks, compression_seek_point_stride, std::move(compression)) {
    }
 
    template<typename BlockTrace>
@@ -149,16 +155,112 @@ namespace eosio::trace_api {
       return get_block_n{};
    }
 
-   slice_directory::slice_directory(const std::filesystem::path& slice_dir, uint32_t width, std::optional<uint32_t> minimum_irreversible_history_blocks, std::optional<uint32_t> minimum_uncompressed_irreversible_history_blocks, size_t compression_seek_point_stride)
+   block_range_reader::block_range_reader(const slice_directory& slice_directory, uint32_t start_block, uint32_t end_block)
+   : _slice_directory(slice_directory)
+   , _next_block(start_block)
+   , _end_block(end_block) {
+   }
+
+   get_block_t block_range_reader::next(const yield_function& yield) {
+      while (_next_block < _end_block) {
+         const uint32_t slice_number = _slice_directory.slice_number(_next_block);
+         if (_slice != slice_number) {
+            const bool found = load_slice(slice_number, yield);
+            if (!found && _found_slice) {
+               break;
+            }
+            _found_slice = _found_slice || found;
+         }
+
+         auto itr = _offsets.lower_bound(_next_block);
+         if (itr == _offsets.end()) {
+            // nothing left in this slice, continue with the first block of the next one
+            const uint64_t next_slice_start = (static_cast<uint64_t>(slice_number) + 1) * _slice_directory.width();
+            _next_block = static_cast<uint32_t>(std::min<uint64_t>(next_slice_start, _end_block));
+            continue;
+         }
+         if (itr->first >= _end_block) {
+            break;
+         }
+
+         const uint32_t block_num = itr->first;
+         _next_block = block_num + 1;
+         yield();
+         return std::make_tuple(read_data_log(itr->second), _lib >= block_num);
+      }
+      _next_block = _end_block;
+      return {};
+   }
+
+   bool block_range_reader::load_slice(uint32_t slice_number, const yield_function& yield) {
+      _slice = slice_number;
+      _offsets.clear();
+      _lib = 0;
+      _trace.close();
+      _ctrace.reset();
+      _position.reset();
+
+      fc::cfile index;
+      if (!_slice_directory.find_index_slice(slice_number, slice_directory::open_state::read, index)) {
+         return false;
+      }
+      const uint64_t end = file_size(index.get_file_path());
+      uint64_t offset = index.tellp();
+      while (offset < end) {
+         yield();
+         const auto metadata = extract_store<metadata_log_entry>(index);
+         if (std::holds_alternative<block_entry_v0>(metadata)) {
+            const auto& block = std::get<block_entry_v0>(metadata);
+            _offsets[block.number] = block.offset;
+         } else if (std::holds_alternative<lib_entry_v0>(metadata)) {
+            _lib = std::max(_lib, std::get<lib_entry_v0>(metadata).lib);
+         }
+         offset = index.tellp();
+      }
+
+      if (_slice_directory.find_trace_slice(slice_number, slice_directory::open_state::read, _trace)) {
+#if defined(POSIX_FADV_SEQUENTIAL)
+         // blocks are read in increasing offsets, let the kernel read ahead further than it would by default
+         posix_fadvise(_trace.fileno(), 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+      } else {
+         _ctrace = _slice_directory.find_compressed_trace_slice(slice_number);
+         if (!_ctrace) {
+            // the index may be created before the trace file, there are no traces to read
+            _offsets.clear();
+         }
+      }
+      return true;
+   }
+
+   data_log_entry block_range_reader::read_data_log(uint64_t offset) {
+      // a compressed file decompresses from the preceding seek point on every seek, only seek when not sequential
+      if (_position != offset) {
+         if (_ctrace) {
+            _ctrace->seek(offset);
+         } else {
+            _trace.seek(offset);
+         }
+      }
+      auto entry = _ctrace ? extract_store<data_log_entry>(*_ctrace) : extract_store<data_log_entry>(_trace);
+      _position = offset + fc::raw::pack_size(entry);
+      return entry;
+   }
+
+   slice_directory::slice_directory(const std::filesystem::path& slice_dir, uint32_t width, std::optional<uint32_t> minimum_irreversible_history_blocks, std::optional<uint32_t> minimum_uncompressed_irreversible_history_blocks, size_t compression_seek_point_stride, slice_compression_options compression)
    : _slice_dir(slice_dir)
    , _width(width)
    , _minimum_irreversible_history_blocks(minimum_irreversible_history_blocks)
    , _minimum_uncompressed_irreversible_history_blocks(minimum_uncompressed_irreversible_history_blocks)
    , _compression_seek_point_stride(compression_seek_point_stride)
+   , _compression(std::move(compression))
    , _best_known_lib(0) {
       if (!exists(_slice_dir)) {
          std::filesystem::create_directories(slice_dir);
       }
+      if (!_compression.cold_dir.empty() && !exists(_compression.cold_dir)) {
+         std::filesystem::create_directories(_compression.cold_dir);
+      }
    }
 
    bool slice_directory::find_or_create_index_slice(uint32_t slice_number, open_state state, fc::cfile& index_file) const {
@@ -225,8 +327,12 @@ namespace eosio::trace_api {
 
    std::optional<compressed_file> slice_directory::find_compressed_trace_slice(uint32_t slice_number, bool open_file ) const {
       auto filename = make_filename(_trace_prefix, _compressed_trace_ext, slice_number, _width);
-      const auto slice_path = _slice_dir / filename;
-      const bool file_exists = exists(slice_path);
+      auto slice_path = _slice_dir / filename;
+      bool file_exists = exists(slice_path);
+      if (!file_exists && !_compression.cold_dir.empty()) {
+         slice_path = _compression.cold_dir / filename;
+         file_exists = exists(slice_path);
+      }
 
       if (file_exists) {
          auto result = compressed_file(slice_path);
@@ -391,25 +497,73 @@ namespace eosio::trace_api {
       if (_minimum_uncompressed_irreversible_history_blocks &&
           (!_minimum_irreversible_history_blocks || *_minimum_uncompressed_irreversible_history_blocks < *_minimum_irreversible_history_blocks) )
       {
-         process_irreversible_slice_range(lib, *_minimum_uncompressed_irreversible_history_blocks, _last_compressed_slice, [this, &log](uint32_t slice_to_compress){
-            fc::cfile trace;
-            const bool dont_open_file = false;
-            const bool trace_found = find_trace_slice(slice_to_compress, open_state::read, trace, dont_open_file);
+         std::vector<uint32_t> slices_to_compress;
+         process_irreversible_slice_range(lib, *_minimum_uncompressed_irreversible_history_blocks, _last_compressed_slice, [&slices_to_compress](uint32_t slice_to_compress){
+            slices_to_compress.push_back(slice_to_compress);
+         });
+         if (slices_to_compress.empty())
+            return;
+
+         // slices are independent files, so a backlog of them (e.g. after a restart or a replay) is compressed in parallel
+         std::atomic<size_t> next = 0;
+         std::mutex failure_mtx;
+         std::optional<uint32_t> failed_slice;
+         std::exception_ptr failure;
+         auto compress_slices = [&]() {
+            for (size_t n = next++; n < slices_to_compress.size(); n = next++) {
+               try {
+                  compress_slice(slices_to_compress[n], log);
+               } catch (...) {
+                  std::scoped_lock lock(failure_mtx);
+                  if (!failed_slice || slices_to_compress[n] < *failed_slice) {
+                     failed_slice = slices_to_compress[n];
+                     failure = std::current_exception();
+                  }
+               }
+            }
+         };
+
+         const size_t num_threads = std::clamp<size_t>(_compression.threads, 1, slices_to_compress.size());
+         std::vector<std::thread> threads;
+         for (size_t i = 1; i < num_threads; ++i) {
+            threads.emplace_back([&]() {
+               fc::set_thread_name( "trace-cmp" );
+               compress_slices();
+            });
+         }
+         compress_slices();
+         for (auto& t : threads)
+            t.join();
+
+         if (failure) {
+            // retry from the first slice that failed on the next lib, compressing a slice again is harmless
+            _last_compressed_slice = *failed_slice == 0 ? std::optional<uint32_t>{} : std::optional<uint32_t>{*failed_slice - 1};
+            std::rethrow_exception(failure);
+         }
+      }
+   }
 
-            log(std::string("Attempting compression of slice: ") + std::to_string(slice_to_compress));
+   void slice_directory::compress_slice(uint32_t slice_to_compress, const log_handler& log) const {
+      fc::cfile trace;
+      const bool dont_open_file = false;
+      const bool trace_found = find_trace_slice(slice_to_compress, open_state::read, trace, dont_open_file);
 
-            if (trace_found) {
-               auto compressed_path = trace.get_file_path();
-               compressed_path.replace_extension(_compressed_trace_ext);
+      log(std::string("Attempting compression of slice: ") + std::to_string(slice_to_compress));
 
-               log(std::string("Compressing: ") + trace.get_file_path().generic_string());
-               compressed_file::process(trace.get_file_path(), compressed_path.generic_string(), _compression_seek_point_stride);
+      if (trace_found) {
+         const auto compressed_dir = _compression.cold_dir.empty() ? _slice_dir : _compression.cold_dir;
+         const auto compressed_path = compressed_dir / make_filename(_trace_prefix, _compressed_trace_ext, slice_to_compress, _width);
+         // readers only find the compressed file once it is complete
+         auto tmp_path = compressed_path;
+         tmp_path += ".tmp";
 
-               // after compression is complete, delete the old uncompressed file
-               log(std::string("Removing: ") + trace.get_file_path().generic_string());
-               std::filesystem::remove(trace.get_file_path());
-            }
-         });
+         log(std::string("Compressing: ") + trace.get_file_path().generic_string() + " to " + compressed_path.generic_string());
+         compressed_file::process(trace.get_file_path(), tmp_path, _compression_seek_point_stride, _compression.codec);
+         std::filesystem::rename(tmp_path, compressed_path);
+
+         // after compression is complete, delete the old uncompressed file
+         log(std::string("Removing: ") + trace.get_file_path().generic_string());
+         std::filesystem::remove(trace.get_file_path());
       }
    }
 }
@@ -1,5 +1,6 @@
 #include <boost/test/unit_test.hpp>
 #include <list>
+#include <numeric>
 
 #include <eosio/trace_api/compressed_file.hpp>
 #include <eosio/trace_api/test_common.hpp>
@@ -201,4 +202,64 @@ BOOST_FIXTURE_TEST_CASE_TEMPLATE(blob_access_no_seek_points, T, test_types, temp
 }
 
 
+BOOST_FIXTURE_TEST_CASE_TEMPLATE(zstd_random_access_test, T, test_types, temp_file_fixture) {
+   if (!is_supported(compression_codec::zstd))
+      return;
+
+   // generate a large dataset where ever 8 bytes is the offset to that 8 bytes of data
+   auto data = std::vector<T>(128);
+   std::generate(data.begin(), data.end(), [offset=0ULL]() mutable {
+      auto result = offset;
+      offset+=sizeof(T);
+      return convert_to<T>(result);
+   });
+
+   auto uncompressed_filename = create_temp_file(data.data(), data.size() * sizeof(T));
+   auto compressed_filename = create_temp_file(nullptr, 0);
+
+   BOOST_TEST(compressed_file::process(uncompressed_filename, compressed_filename, 512, compression_codec::zstd));
+
+   // test that you can read all of the offsets from the compressed form by opening and seeking to them
+   for (size_t i = 0; i < data.size(); i++) {
+      const auto& entry = data.at(i);
+      auto compf = compressed_file(compressed_filename);
+      compf.open();
+      T value;
+      compf.seek((long)i * sizeof(T));
+      compf.read(reinterpret_cast<char*>(&value), sizeof(T));
+      BOOST_TEST(value == entry);
+      compf.close();
+   }
+
+   // and sequentially across all of the frames
+   auto compf = compressed_file(compressed_filename);
+   compf.open();
+   for( const auto& entry : data ) {
+      T value;
+      compf.read(reinterpret_cast<char*>(&value), sizeof(value));
+      BOOST_TEST(value == entry);
+   }
+   compf.close();
+}
+
+BOOST_FIXTURE_TEST_CASE(zstd_read_past_end, temp_file_fixture) {
+   if (!is_supported(compression_codec::zstd))
+      return;
+
+   auto data = std::vector<uint64_t>(128);
+   std::iota(data.begin(), data.end(), 0);
+   auto uncompressed_filename = create_temp_file(data.data(), data.size() * sizeof(uint64_t));
+   auto compressed_filename = create_temp_file(nullptr, 0);
+
+   BOOST_TEST(compressed_file::process(uncompressed_filename, compressed_filename, 256, compression_codec::zstd));
+
+   auto compf = compressed_file(compressed_filename);
+   compf.open();
+   compf.seek((data.size() - 1) * sizeof(uint64_t));
+   uint64_t value[2];
+   // the seek point map that follows the frames must not be decompressed
+   BOOST_REQUIRE_THROW(compf.read(reinterpret_cast<char*>(value), sizeof(value)), std::ios_base::failure);
+   compf.close();
+}
+
 BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
@@ -127,8 +127,9 @@ struct extraction_test_fixture {
       extraction_test_fixture& fixture;
    };
 
-   extraction_test_fixture()
-   : extraction_impl(mock_logfile_provider_type(*this), exception_handler{} )
+   explicit extraction_test_fixture( uint32_t max_queued_blocks = 0 )
+   : extraction_impl(mock_logfile_provider_type(*this), exception_handler{}, max_queued_blocks,
+                     [this](uint32_t block_num, fc::microseconds, uint32_t) { appended_blocks.push_back(block_num); } )
    {
    }
 
@@ -140,14 +141,26 @@ struct extraction_test_fixture {
       extraction_impl.signal_accepted_block(bsp->block, bsp->id);
    }
 
+   void signal_irreversible_block( uint32_t block_num ) {
+      extraction_impl.signal_irreversible_block(block_num);
+   }
+
    // fixture data and methods
    uint32_t max_lib = 0;
+   std::vector<uint32_t> appended_blocks;
    std::vector<data_log_entry> data_log = {};
    std::unordered_map<uint32_t, std::vector<chain::transaction_id_type>> id_log;
 
    chain_extraction_impl_type<mock_logfile_provider_type> extraction_impl;
 };
 
+struct threaded_extraction_test_fixture : extraction_test_fixture {
+   threaded_extraction_test_fixture()
+   : extraction_test_fixture(2)
+   {
+   }
+};
+
 
 BOOST_AUTO_TEST_SUITE(block_extraction)
 
@@ -420,4 +433,42 @@ BOOST_AUTO_TEST_SUITE(block_extraction)
       BOOST_REQUIRE_EQUAL(std::get<block_trace_v2>(data_log.at(0)), expected_block_trace);
    }
 
+   BOOST_FIXTURE_TEST_CASE(threaded_writes_in_block_order, threaded_extraction_test_fixture)
+   {
+      std::vector<chain::transaction_id_type> trx_ids;
+      chain::block_id_type previous;
+      for( uint32_t block_num = 1; block_num <= 10; ++block_num ) {
+         extraction_impl.signal_block_start( block_num );
+         auto act = make_transfer_action( "alice"_n, "bob"_n, "0.0001 SYS"_t, std::to_string(block_num) );
+         auto ptrx = make_packed_trx( { act } );
+         signal_applied_transaction(
+               make_transaction_trace( ptrx.id(), block_num, block_num, chain::transaction_receipt_header::executed,
+                     { make_action_trace( block_num, act, "eosio.token"_n ) } ),
+               std::make_shared<packed_transaction>(ptrx) );
+
+         auto bsp = make_block_state( previous, block_num, block_num, "bp.one"_n, { chain::packed_transaction(ptrx) } );
+         signal_accepted_block( bsp );
+         signal_irreversible_block( block_num );
+         previous = bsp->id;
+         trx_ids.push_back( ptrx.id() );
+      }
+
+      // waits for the writer thread
+      extraction_impl.stop();
+
+      BOOST_REQUIRE_EQUAL(max_lib, 10u);
+      BOOST_REQUIRE_EQUAL(data_log.size(), 10u);
+      BOOST_REQUIRE_EQUAL(appended_blocks.size(), 10u);
+      for( uint32_t i = 0; i < data_log.size(); ++i ) {
+         BOOST_REQUIRE(std::holds_alternative<block_trace_v2>(data_log.at(i)));
+         const auto& bt = std::get<block_trace_v2>(data_log.at(i));
+         BOOST_REQUIRE_EQUAL(bt.number, i + 1);
+         BOOST_REQUIRE_EQUAL(appended_blocks.at(i), i + 1);
+         const auto& traces = std::get<std::vector<transaction_trace_v3>>(bt.transactions);
+         BOOST_REQUIRE_EQUAL(traces.size(), 1u);
+         BOOST_REQUIRE(traces.at(0).id == trx_ids.at(i));
+         BOOST_REQUIRE_EQUAL(id_log.at(i + 1).size(), 1u);
+      }
+   }
+
 BOOST_AUTO_TEST_SUITE_END()
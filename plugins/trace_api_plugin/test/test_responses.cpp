@@ -2,6 +2,9 @@
 
 #include <fc/variant_object.hpp>
 
+#include <map>
+#include <sstream>
+
 #include <eosio/trace_api/request_handler.hpp>
 #include <eosio/trace_api/test_common.hpp>
 
@@ -28,6 +31,28 @@ struct response_test_fixture {
       get_block_t get_block(uint32_t height) {
          return fixture.mock_get_block(height);
       }
+
+      /**
+       * Sequential reader of the blocks in [start_block, end_block), reads each block with get_block
+       */
+      struct mock_block_range_reader {
+         get_block_t next() {
+            while (next_block < end_block) {
+               if (auto data = fixture.mock_get_block(next_block++))
+                  return data;
+            }
+            return {};
+         }
+
+         response_test_fixture& fixture;
+         uint32_t next_block;
+         uint32_t end_block;
+      };
+
+      mock_block_range_reader read_block_range(uint32_t start_block, uint32_t end_block) {
+         return mock_block_range_reader{fixture, start_block, end_block};
+      }
+
       response_test_fixture& fixture;
    };
 
@@ -72,6 +97,15 @@ struct response_test_fixture {
       return response_impl.get_block_trace( block_height );
    }
 
+   // all pieces of an export concatenated
+   std::string export_blocks( uint32_t start_block, uint32_t end_block, export_filter filter, export_format format, size_t chunk_size ) {
+      auto exporter = response_impl.export_blocks( start_block, end_block, std::move(filter), format, chunk_size );
+      std::string result, chunk;
+      while (exporter(chunk))
+         result += chunk;
+      return result + chunk;
+   }
+
    // fixture data and methods
    std::function<get_block_t(uint32_t)> mock_get_block;
    std::function<std::tuple<fc::variant, std::optional<fc::variant>>(const action_trace_v0&)> mock_data_handler_v0 = default_mock_data_handler_v0;
@@ -952,4 +986,87 @@ BOOST_AUTO_TEST_SUITE(trace_responses)
 
    }
 
+   BOOST_FIXTURE_TEST_CASE(export_blocks_filtered, response_test_fixture)
+   {
+      auto make_block = [](uint32_t number, chain::name account, chain::name action) {
+         auto action_trace = action_trace_v0 {
+            number,
+            account, account, action,
+            {{ "alice"_n, "active"_n }},
+            { 0x00, 0x01, 0x02, 0x03 }
+         };
+         auto transaction_trace = transaction_trace_v1 { {
+            fc::sha256::hash(std::to_string(number)),
+            {
+               action_trace
+            }},
+            fc::enum_type<uint8_t, chain::transaction_receipt_header::status_enum>{chain::transaction_receipt_header::status_enum::executed},
+            10,
+            5,
+            std::vector<chain::signature_type>{ chain::signature_type() },
+            { chain::time_point_sec(), 1, 0, 100, 50, 0 }
+         };
+         return block_trace_v1 {
+            {
+               fc::sha256::hash(std::to_string(number)),
+               number,
+               "0000000000000000000000000000000000000000000000000000000000000000"_h,
+               chain::block_timestamp_type(0),
+               "bp.one"_n
+            },
+            "0000000000000000000000000000000000000000000000000000000000000000"_h,
+            "0000000000000000000000000000000000000000000000000000000000000000"_h,
+            0,
+            {
+               transaction_trace
+            }
+         };
+      };
+
+      // blocks 1 to 5, block 3 missing, even blocks for "token"_n, odd ones for "other"_n
+      std::map<uint32_t, block_trace_v1> blocks;
+      for (uint32_t number : {1u, 2u, 4u, 5u}) {
+         blocks.emplace(number, make_block(number, number % 2 ? "other"_n : "token"_n, number % 2 ? "noop"_n : "transfer"_n));
+      }
+      mock_get_block = [&blocks]( uint32_t height ) -> get_block_t {
+         auto itr = blocks.find(height);
+         if (itr == blocks.end())
+            return {};
+         return std::make_tuple(data_log_entry(itr->second), height <= 2);
+      };
+
+      // every block, one line per block, in pieces of at least a block
+      auto ndjson = export_blocks(1, 6, {}, export_format::ndjson, 1);
+      std::vector<uint32_t> numbers;
+      std::stringstream lines(ndjson);
+      for (std::string line; std::getline(lines, line);) {
+         auto block = fc::json::from_string(line);
+         numbers.push_back(block["number"].as_uint64());
+         BOOST_TEST(to_kv(block) == to_kv(get_block_trace(numbers.back())), boost::test_tools::per_element());
+      }
+      BOOST_TEST(numbers == std::vector<uint32_t>({1, 2, 4, 5}), boost::test_tools::per_element());
+
+      // blocks without a selected action are skipped
+      ndjson = export_blocks(1, 6, export_filter({"token"_n}, {"transfer"_n}), export_format::ndjson, 1024 * 1024);
+      BOOST_REQUIRE_EQUAL(std::count(ndjson.begin(), ndjson.end(), '\n'), 2);
+      BOOST_REQUIRE_EQUAL(fc::json::from_string(ndjson.substr(0, ndjson.find('\n')))["number"].as_uint64(), 2u);
+      BOOST_REQUIRE(export_blocks(1, 6, export_filter({"token"_n}, {"noop"_n}), export_format::ndjson, 1024).empty());
+
+      // binary records are the packed block traces
+      auto binary = export_blocks(2, 5, {}, export_format::binary, 1);
+      fc::datastream<const char*> ds(binary.data(), binary.size());
+      for (uint32_t number : {2u, 4u}) {
+         uint32_t size = 0;
+         uint8_t irreversible = 0;
+         fc::raw::unpack(ds, size);
+         fc::raw::unpack(ds, irreversible);
+         BOOST_REQUIRE_EQUAL(size, fc::raw::pack_size(data_log_entry(blocks.at(number))));
+         data_log_entry entry;
+         fc::raw::unpack(ds, entry);
+         BOOST_REQUIRE_EQUAL(std::get<block_trace_v1>(entry).number, number);
+         BOOST_REQUIRE_EQUAL(int(irreversible), number <= 2 ? 1 : 0);
+      }
+      BOOST_REQUIRE_EQUAL(ds.remaining(), 0u);
+   }
+
 BOOST_AUTO_TEST_SUITE_END()
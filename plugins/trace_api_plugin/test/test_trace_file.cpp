@@ -782,6 +782,45 @@ BOOST_AUTO_TEST_SUITE(slice_tests)
       BOOST_REQUIRE_EQUAL(files.size(), 0u);
    }
 
+   BOOST_FIXTURE_TEST_CASE(slice_dir_compress_to_cold_dir, test_fixture)
+   {
+      fc::temp_directory tempdir;
+      fc::temp_directory cold_tempdir;
+      const uint32_t width = 10;
+      const uint32_t min_uncompressed_blocks = 5;
+      const auto cold_dir = cold_tempdir.path() / "cold";
+      slice_directory sd(tempdir.path(), width, std::optional<uint32_t>(), std::optional<uint32_t>(min_uncompressed_blocks), 8,
+                         slice_compression_options{ .codec = compression_codec::zlib, .threads = 3, .cold_dir = cold_dir });
+      fc::cfile file;
+
+      std::set<std::filesystem::path> files;
+      std::set<std::filesystem::path> cold_files;
+      for (int i = 0; i < 7 ; i++) {
+         BOOST_REQUIRE(!sd.find_or_create_index_slice(i, open_state::read, file));
+         files.insert(file.get_file_path().filename());
+         BOOST_REQUIRE(create_non_empty_trace_slice(sd, i, file));
+         auto compressed_trace_name = file.get_file_path().filename();
+         compressed_trace_name.replace_extension(".clog");
+         cold_files.insert(compressed_trace_name);
+      }
+
+      // a single maintenance pass compresses the whole backlog of slices, in parallel, into the cold directory
+      sd.run_maintenance_tasks(75, {});
+      verify_directory_contents(tempdir.path(), files);
+      verify_directory_contents(cold_dir, cold_files);
+
+      // readers find the compressed slices in the cold directory
+      for (uint32_t i = 0; i < 7 ; i++) {
+         BOOST_REQUIRE(!sd.find_trace_slice(i, open_state::read, file));
+         auto ctrace = sd.find_compressed_trace_slice(i);
+         BOOST_REQUIRE(ctrace);
+         BOOST_REQUIRE(ctrace->get_file_path().parent_path() == cold_dir);
+         uint8_t which = 0;
+         ctrace->read(reinterpret_cast<char*>(&which), sizeof(which));
+         BOOST_REQUIRE_EQUAL(which, uint8_t(0x7F));
+      }
+   }
+
    BOOST_FIXTURE_TEST_CASE(store_provider_write_read_v1, test_fixture)
    {
       fc::temp_directory tempdir;
@@ -1067,4 +1106,57 @@ BOOST_AUTO_TEST_SUITE(slice_tests)
    }
 
 
+   BOOST_FIXTURE_TEST_CASE(test_read_block_range, test_fixture)
+   {
+      fc::temp_directory tempdir;
+      const uint32_t width = 10;
+      store_provider sp(tempdir.path(), width, std::optional<uint32_t>(), std::optional<uint32_t>(), 0);
+
+      // slices 0 to 3, block 17 missing and block 22 rewritten by a fork
+      std::vector<uint32_t> expected;
+      for (uint32_t number = 5; number < 35; ++number) {
+         if (number == 17)
+            continue;
+         auto bt = block_trace1_v2;
+         bt.number = number;
+         sp.append(bt);
+         if (number == 22) {
+            bt.id = block_trace2_v2.id;
+            sp.append(bt);
+         }
+         expected.push_back(number);
+      }
+      sp.append_lib(25);
+
+      // compress slice 1, the reader reads compressed and uncompressed slices alike
+      const auto slice_1 = tempdir.path() / "trace_0000000010-0000000020.log";
+      auto compressed_slice_1 = slice_1;
+      compressed_slice_1.replace_extension(".clog");
+      BOOST_REQUIRE(compressed_file::process(slice_1, compressed_slice_1, 64));
+      std::filesystem::remove(slice_1);
+
+      auto read_all = [&](uint32_t start_block, uint32_t end_block) {
+         std::vector<uint32_t> numbers;
+         auto reader = sp.read_block_range(start_block, end_block);
+         while (auto block = reader.next()) {
+            const auto& bt = std::get<block_trace_v2>(std::get<0>(*block));
+            BOOST_REQUIRE_EQUAL(std::get<1>(*block), bt.number >= 20 && bt.number <= 25);
+            BOOST_REQUIRE(bt.id == (bt.number == 22 ? block_trace2_v2.id : block_trace1_v2.id));
+            numbers.push_back(bt.number);
+         }
+         return numbers;
+      };
+
+      // the range ends at the first missing slice
+      BOOST_REQUIRE(read_all(0, 1000) == expected);
+      BOOST_REQUIRE(read_all(12, 23) == std::vector<uint32_t>({12, 13, 14, 15, 16, 18, 19, 20, 21, 22}));
+      BOOST_REQUIRE(read_all(17, 18).empty());
+
+      // slices pruned before the range are skipped
+      for (const char* prefix : {"trace_", "trace_index_"}) {
+         std::filesystem::remove(tempdir.path() / (std::string(prefix) + "0000000000-0000000010.log"));
+      }
+      BOOST_REQUIRE(read_all(0, 15) == std::vector<uint32_t>({10, 11, 12, 13, 14}));
+   }
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -68,6 +68,84 @@ namespace {
       }
    }
 
+   /**
+    * Produces the next piece of a streamed response on the http thread pool while the current one is being written,
+    * so reading and formatting a bulk export overlaps sending it. A piece whose production has not started by the
+    * time it is needed, e.g. because all http threads are busy, is produced inline instead.
+    */
+   class readahead_producer : public std::enable_shared_from_this<readahead_producer> {
+   public:
+      using producer = std::function<bool(std::string&)>;
+      using poster = std::function<void(std::function<void()>)>;
+
+      readahead_producer(producer produce, poster post)
+      :_produce(std::move(produce))
+      ,_post(std::move(post))
+      {}
+
+      bool next(std::string& chunk) {
+         std::unique_lock lock(_mtx);
+         if (_state == state::idle || _state == state::queued) {
+            _state = state::running;
+            lock.unlock();
+            produce();
+            lock.lock();
+         }
+         _cond.wait(lock, [this]() { return _state == state::done; });
+         _state = state::idle;
+         if (_failure) {
+            std::rethrow_exception(std::exchange(_failure, {}));
+         }
+         chunk = std::move(_chunk);
+         const bool more = _more;
+         if (more) {
+            _state = state::queued;
+            lock.unlock();
+            _post([self = shared_from_this()]() {
+               std::unique_lock lock(self->_mtx);
+               if (self->_state != state::queued) {
+                  return; // already produced by next()
+               }
+               self->_state = state::running;
+               lock.unlock();
+               self->produce();
+            });
+         }
+         return more;
+      }
+
+   private:
+      enum class state { idle, queued, running, done };
+
+      void produce() {
+         std::string chunk;
+         bool more = false;
+         std::exception_ptr failure;
+         try {
+            more = _produce(chunk);
+         } catch (...) {
+            failure = std::current_exception();
+         }
+         {
+            std::scoped_lock lock(_mtx);
+            _chunk = std::move(chunk);
+            _more = more;
+            _failure = failure;
+            _state = state::done;
+         }
+         _cond.notify_all();
+      }
+
+      producer _produce;
+      poster _post;
+      std::mutex _mtx;
+      std::condition_variable _cond;
+      state _state = state::idle;
+      std::string _chunk;
+      bool _more = false;
+      std::exception_ptr _failure;
+   };
+
    template<typename Store>
    struct shared_store_provider {
       explicit shared_store_provider(const std::shared_ptr<Store>& store)
@@ -87,6 +165,10 @@ namespace {
          return store->get_block(height);
       }
 
+      block_range_reader read_block_range(uint32_t start_block, uint32_t end_block) {
+         return store->read_block_range(start_block, end_block);
+      }
+
       void append_trx_ids(block_trxs_entry tt){
          store->append_trx_ids(std::move(tt));
       }
@@ -113,6 +195,17 @@ struct trace_api_common_impl {
       cfg_options("trace-minimum-uncompressed-irreversible-history-blocks", boost::program_options::value<int32_t>()->default_value(-1),
                   "Number of blocks to ensure are uncompressed past LIB. Compressed \"slice\" files are still accessible but may carry a performance loss on retrieval\n"
                   "A value of -1 indicates that automatic compression of \"slice\" files will be turned off.");
+      cfg_options("trace-write-queue-size", bpo::value<uint32_t>()->default_value(4),
+                  "Maximum number of blocks waiting for their traces to be converted and written to the \"slice\" files by a dedicated thread. "
+                  "When full, block processing waits for the writes. 0 converts and writes the traces on the main thread.");
+      cfg_options("trace-compression-codec", bpo::value<std::string>()->default_value("zlib"),
+                  "Codec used to compress \"slice\" files, zlib or zstd. zstd requires a build with ENABLE_ZSTD. "
+                  "Slice files already compressed with either codec remain readable.");
+      cfg_options("trace-compression-threads", bpo::value<uint32_t>()->default_value(1),
+                  "Number of \"slice\" files compressed in parallel when more than one is due for compression.");
+      cfg_options("trace-cold-dir", bpo::value<std::filesystem::path>(),
+                  "If set, compressed \"slice\" files are moved to this directory, e.g. on cheaper storage, and read from it "
+                  "(absolute path or relative to application data dir). Defaults to the trace directory.");
    }
 
    void plugin_initialize(const appbase::variables_map& options) {
@@ -126,6 +219,30 @@ struct trace_api_common_impl {
 
       slice_stride = options.at("trace-slice-stride").as<uint32_t>();
 
+      const auto codec = options.at("trace-compression-codec").as<std::string>();
+      if (codec == "zlib")
+         compression.codec = compression_codec::zlib;
+      else if (codec == "zstd")
+         compression.codec = compression_codec::zstd;
+      else
+         EOS_THROW(chain::plugin_config_exception, "\"trace-compression-codec\" must be zlib or zstd, not ${c}", ("c", codec));
+      EOS_ASSERT(is_supported(compression.codec), chain::plugin_config_exception,
+                 "\"trace-compression-codec\" zstd requires a build with ENABLE_ZSTD");
+
+      compression.threads = options.at("trace-compression-threads").as<uint32_t>();
+      EOS_ASSERT(compression.threads > 0, chain::plugin_config_exception,
+                 "\"trace-compression-threads\" must be greater than 0");
+
+      if (options.count("trace-cold-dir")) {
+         auto cold_dir_option = options.at("trace-cold-dir").as<std::filesystem::path>();
+         if (cold_dir_option.is_relative())
+            compression.cold_dir = app().data_dir() / cold_dir_option;
+         else
+            compression.cold_dir = cold_dir_option;
+         if (auto resmon_plugin = app().find_plugin<resource_monitor_plugin>())
+           resmon_plugin->monitor_directory(compression.cold_dir);
+      }
+
       const int32_t blocks = options.at("trace-minimum-irreversible-history-blocks").as<int32_t>();
       EOS_ASSERT(blocks >= -1, chain::plugin_config_exception,
                  "\"trace-minimum-irreversible-history-blocks\" must be greater to or equal to -1.");
@@ -146,7 +263,8 @@ struct trace_api_common_impl {
          slice_stride,
          minimum_irreversible_history_blocks,
          minimum_uncompressed_irreversible_history_blocks,
-         compression_seek_point_stride
+         compression_seek_point_stride,
+         compression
       );
    }
 
@@ -166,6 +284,7 @@ struct trace_api_common_impl {
 
    std::optional<uint32_t> minimum_irreversible_history_blocks;
    std::optional<uint32_t> minimum_uncompressed_irreversible_history_blocks;
+   slice_compression_options compression;
 
    static constexpr int32_t manual_slice_file_value = -1;
    static constexpr uint32_t compression_seek_point_stride = 6 * 1024 * 1024; // 6 MiB strides for clog seek points
@@ -336,6 +455,80 @@ struct trace_api_rpc_plugin_impl : public std::enable_shared_from_this<trace_api
              http_plugin::handle_exception("trace_api", "get_transaction", body, cb);
           }
       }});
+
+      http.add_async_stream_handler("/v1/trace_api/export_blocks",
+            api_category::trace_api,
+            [wthis=weak_from_this()](std::string, std::string body, url_response_callback cb, url_stream_callback stream)
+      {
+         auto that = wthis.lock();
+         if (!that) {
+            return;
+         }
+
+         struct export_request {
+            uint32_t start_block_num = 0;
+            uint32_t end_block_num = 0;
+            export_format format = export_format::ndjson;
+            export_filter filter;
+         };
+         std::string error;
+         auto request = ([&body, &error]() -> std::optional<export_request> {
+            try {
+               const auto input = fc::json::from_string(body).get_object();
+               const auto start_block_num = input["start_block_num"].as_uint64();
+               const auto end_block_num = input["end_block_num"].as_uint64();
+               if (end_block_num > std::numeric_limits<uint32_t>::max() || start_block_num >= end_block_num) {
+                  error = "start_block_num must be less than end_block_num";
+                  return {};
+               }
+               export_request result{.start_block_num = static_cast<uint32_t>(start_block_num),
+                                     .end_block_num = static_cast<uint32_t>(end_block_num)};
+               if (input.contains("format")) {
+                  const auto& format = input["format"].get_string();
+                  if (format == "binary") {
+                     result.format = export_format::binary;
+                  } else if (format != "ndjson") {
+                     error = "format must be ndjson or binary";
+                     return {};
+                  }
+               }
+               std::vector<chain::name> accounts, actions;
+               if (input.contains("accounts")) {
+                  accounts = input["accounts"].as<std::vector<chain::name>>();
+               }
+               if (input.contains("actions")) {
+                  actions = input["actions"].as<std::vector<chain::name>>();
+               }
+               result.filter = export_filter(std::move(accounts), std::move(actions));
+               return result;
+            } catch (...) {
+               error = "Bad or missing start_block_num or end_block_num";
+               return {};
+            }
+         })();
+
+         if (!request) {
+            error_results results{400, error};
+            cb( 400, fc::variant( results ));
+            return;
+         }
+
+         try {
+            auto exporter = that->req_handler->export_blocks(request->start_block_num, request->end_block_num,
+                                                             std::move(request->filter), request->format, export_chunk_size);
+            // exporter reads through req_handler, keep it alive with the producer
+            auto producer = std::make_shared<readahead_producer>([that, exporter=std::move(exporter)](std::string& chunk) {
+               return exporter(chunk);
+            }, [](std::function<void()> f) {
+               app().get_plugin<http_plugin>().post_http_thread_pool(std::move(f), api_category::trace_api);
+            });
+            stream( 200,
+                    request->format == export_format::binary ? "application/octet-stream" : "application/x-ndjson",
+                    [producer](std::string& chunk) { return producer->next(chunk); } );
+         } catch (...) {
+            http_plugin::handle_exception("trace_api", "export_blocks", body, cb);
+         }
+      });
    }
 
    void plugin_shutdown() {
@@ -345,11 +538,14 @@ struct trace_api_rpc_plugin_impl : public std::enable_shared_from_this<trace_api
 
    using request_handler_t = request_handler<shared_store_provider<store_provider>, abi_data_handler::shared_provider>;
    std::shared_ptr<request_handler_t> req_handler;
+
+   static constexpr size_t export_chunk_size = 256 * 1024; // size of the pieces of an export_blocks response
 };
 
 struct trace_api_plugin_impl {
-   explicit trace_api_plugin_impl( const std::shared_ptr<trace_api_common_impl>& common )
-   :common(common) {}
+   explicit trace_api_plugin_impl( const std::shared_ptr<trace_api_common_impl>& common, trace_api_plugin& plugin )
+   :common(common)
+   ,plugin(plugin) {}
 
    void plugin_initialize(const appbase::variables_map& options) {
       ilog("initializing trace api plugin");
@@ -358,7 +554,17 @@ struct trace_api_plugin_impl {
          app().quit();
          throw yield_exception("shutting down");
       };
-      extraction = std::make_shared<chain_extraction_t>(shared_store_provider<store_provider>(common->store), log_exceptions_and_shutdown);
+      const uint32_t write_queue_size = options.at("trace-write-queue-size").as<uint32_t>();
+      extraction = std::make_shared<chain_extraction_t>(shared_store_provider<store_provider>(common->store), log_exceptions_and_shutdown,
+                                                        write_queue_size,
+                                                        [this](uint32_t block_num, fc::microseconds append_time, uint32_t queued_blocks) {
+         std::lock_guard g(plugin.update_append_metrics_mtx);
+         if (plugin.update_append_metrics) {
+            plugin.update_append_metrics({.block_num      = block_num,
+                                          .append_time_us = append_time.count(),
+                                          .queued_blocks  = queued_blocks});
+         }
+      });
 
       auto& chain = app().find_plugin<chain_plugin>()->chain();
 
@@ -399,10 +605,13 @@ struct trace_api_plugin_impl {
    }
 
    void plugin_shutdown() {
+      // the block traces still queued are written before maintenance stops
+      extraction->stop();
       common->plugin_shutdown();
    }
 
    std::shared_ptr<trace_api_common_impl> common;
+   trace_api_plugin&                      plugin;
 
    using chain_extraction_t = chain_extraction_impl_type<shared_store_provider<store_provider>>;
    std::shared_ptr<chain_extraction_t> extraction;
@@ -428,7 +637,7 @@ void trace_api_plugin::plugin_initialize(const appbase::variables_map& options)
    auto common = std::make_shared<trace_api_common_impl>();
    common->plugin_initialize(options);
 
-   my = std::make_shared<trace_api_plugin_impl>(common);
+   my = std::make_shared<trace_api_plugin_impl>(common, *this);
    my->plugin_initialize(options);
 
    rpc = std::make_shared<trace_api_rpc_plugin_impl>(common);
@@ -450,6 +659,11 @@ void trace_api_plugin::handle_sighup() {
    fc::logger::update( logger_name, _log );
 }
 
+void trace_api_plugin::register_update_append_metrics(std::function<void(append_metrics)>&& fun) {
+   std::lock_guard g(update_append_metrics_mtx);
+   update_append_metrics = std::move(fun);
+}
+
 trace_api_rpc_plugin::trace_api_rpc_plugin() = default;
 
 trace_api_rpc_plugin::~trace_api_rpc_plugin() = default;
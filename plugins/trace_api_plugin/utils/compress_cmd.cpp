@@ -78,6 +78,8 @@ namespace {
       opts("seek-point-stride,s", bpo::value<uint32_t>()->default_value(512),
            "the number of bytes between seek points in a compressed trace.  "
            "A smaller stride may degrade compression efficiency but increase read efficiency");
+      opts("codec,c", bpo::value<std::string>()->default_value("zlib"),
+           "the codec to compress with, zlib or zstd (if built with ENABLE_ZSTD)");
 
       if (global_args.count("help")) {
          print_help_text(std::cout, vis_desc);
@@ -104,8 +106,18 @@ namespace {
             auto input_path = validate_input_path(vmap);
             auto output_path = validate_output_path(vmap, input_path);
             auto seek_point_stride = vmap.at("seek-point-stride").as<uint32_t>();
+            auto codec_name = vmap.at("codec").as<std::string>();
+            compression_codec codec = compression_codec::zlib;
+            if (codec_name == "zstd") {
+               codec = compression_codec::zstd;
+            } else if (codec_name != "zlib") {
+               throw std::logic_error("Unrecognized codec: " + codec_name);
+            }
+            if (!is_supported(codec)) {
+               throw std::logic_error(codec_name + " compression requires a build with ENABLE_ZSTD");
+            }
 
-            if (!compressed_file::process(input_path, output_path, seek_point_stride)) {
+            if (!compressed_file::process(input_path, output_path, seek_point_stride, codec)) {
                throw std::runtime_error("Unexpected compression failure");
             }
          } else {
@@ -2,7 +2,11 @@
 #include <eosio/chain/abi_serializer.hpp>
 #include <eosio/chain/block_log.hpp>
 #include <eosio/chain/config.hpp>
+#include <eosio/chain/controller.hpp>
 #include <eosio/chain/fork_database.hpp>
+#include <eosio/chain/protocol_feature_manager.hpp>
+#include <eosio/chain/snapshot.hpp>
+#include <eosio/chain/transaction_metadata.hpp>
 #include <memory>
 
 #include <fc/bitutil.hpp>
@@ -13,7 +17,10 @@
 #include <boost/exception/diagnostic_information.hpp>
 #include <boost/program_options.hpp>
 
+#include <algorithm>
 #include <chrono>
+#include <iomanip>
+#include <map>
 
 #ifndef _WIN32
 #define FOPEN(p, m) fopen(p, m)
@@ -105,6 +112,18 @@ void blocklog_actions::setup(CLI::App& app) {
    // subcommand - vacuum
    sub->add_subcommand("vacuum", "Vacuum a pruned blocks.log in to an un-pruned blocks.log")->callback([err_guard]() { err_guard(&blocklog_actions::do_vacuum); });
 
+   // subcommand - replay
+   auto* replay = sub->add_subcommand("replay", "Replay blocks of blocks.log on top of a snapshot and report the time spent applying each block. "
+          "Must give 'snapshot'. The blocks from the one following the snapshot through 'last' are replayed, in a temporary state directory. "
+          "Time is split into block header, recovery of the transaction signature keys, transactions outside of their actions, actions, and the rest of applying the block. "
+          "With eos-vm-oc the blocks are first replayed untimed, so that no contract is compiled while timing.")->callback([err_guard]() { err_guard(&blocklog_actions::replay); });
+   replay->add_option("--snapshot,-s", opt->snapshot_file, "The snapshot to start the replay from.")->required();
+   replay->add_option("--last,-l", opt->last_block, "The last block number to replay.");
+   replay->add_option("--output-file,-o", opt->output_file, "The file to write per block timings to, as CSV.  If not specified then only the summary is printed.");
+   replay->add_option("--db-size", opt->db_size, "Maximum size (in MiB) of the chain state database")->capture_default_str();
+   replay->add_option("--wasm-runtime", opt->wasm_runtime, "Override the default WASM runtime (\"eos-vm\", \"eos-vm-jit\" or \"eos-vm-oc\").");
+   replay->add_option("--perf-control-fifo", opt->perf_control_fifo, "Control fifo of 'perf record --control fifo:<fifo> --delay=-1': recording is enabled for the replayed blocks only.");
+
    // subcommand - genesis
    auto* genesis = sub->add_subcommand("genesis", "Extract genesis_state from blocks.log as JSON")->callback([err_guard]() { err_guard(&blocklog_actions::do_genesis); });
    genesis->add_option("--output-file,-o", opt->output_file, "The file to write the output to (absolute or relative path).  If not specified then output is to stdout.");
@@ -358,4 +377,216 @@ int blocklog_actions::split_blocks() {
 int blocklog_actions::merge_blocks() {
    block_log::merge_blocklogs(opt->blocks_dir, opt->output_dir);
    return 0;
-}
\ No newline at end of file
+}
+
+namespace {
+   /**
+    * Time spent applying one block, in microseconds. The transaction and action times are those measured by the chain
+    * for the transaction and action traces.
+    */
+   struct replayed_block {
+      uint32_t block_num    = 0;
+      uint32_t trxs         = 0; ///< including the implicit onblock transaction
+      uint32_t actions      = 0;
+      int64_t  total_us     = 0; ///< header validation and push_block
+      int64_t  header_us    = 0; ///< block header state, including the producer signature
+      int64_t  recovery_us  = 0; ///< recovery of the keys of the transaction signatures, on the chain thread pool
+      int64_t  trx_us       = 0; ///< transactions outside of their actions: authorization, resource billing, undo sessions
+      int64_t  action_us    = 0; ///< actions, including host functions and their database access
+      int64_t  other_us     = 0; ///< block start and finalization, commit to the fork database
+   };
+
+   int64_t percentile(const std::vector<int64_t>& sorted, uint32_t p) {
+      if(sorted.empty())
+         return 0;
+      return sorted[std::min<size_t>(sorted.size() - 1, sorted.size() * p / 100)];
+   }
+}
+
+int blocklog_actions::replay() {
+   if(!std::filesystem::exists(opt->snapshot_file)) {
+      std::cerr << "cannot load snapshot, " << opt->snapshot_file << " does not exist" << std::endl;
+      return -1;
+   }
+
+   chain_id_type chain_id = chain_id_type::empty_chain_id();
+   {
+      auto infile = std::ifstream(opt->snapshot_file, (std::ios::in | std::ios::binary));
+      istream_snapshot_reader reader(infile);
+      reader.validate();
+      chain_id = controller::extract_chain_id(reader);
+   }
+
+   fc::temp_directory dir;
+   controller::config cfg;
+   cfg.blocks_dir = dir.path() / "blocks";
+   cfg.state_dir = dir.path() / "state";
+   cfg.state_size = opt->db_size * 1024 * 1024;
+   cfg.contracts_console = false;
+   cfg.eosvmoc_tierup = wasm_interface::vm_oc_enable::oc_none; // compiling in the background would skew the timings
+   if(!opt->wasm_runtime.empty()) {
+      std::istringstream ss(opt->wasm_runtime);
+      ss >> cfg.wasm_runtime;
+      EOS_ASSERT(!ss.fail(), plugin_config_exception, "unknown --wasm-runtime '${r}'", ("r", opt->wasm_runtime));
+   }
+
+   block_log blocks(opt->blocks_dir, opt->blog_conf);
+   std::unique_ptr<controller> control;
+   auto start_controller = [&]() {
+      auto infile = std::ifstream(opt->snapshot_file, (std::ios::in | std::ios::binary));
+      auto reader = std::make_shared<istream_snapshot_reader>(infile);
+      protocol_feature_set pfs = initialize_protocol_features( std::filesystem::path("protocol_features"), false );
+      control = std::make_unique<controller>(cfg, std::move(pfs), chain_id);
+      control->add_indices();
+      control->startup([]() {}, []() { return false; }, reader);
+   };
+   start_controller();
+
+   const uint32_t first_block = control->head_block_num() + 1;
+   const uint32_t last_block = std::min(opt->last_block, blocks.head() ? blocks.head()->block_num() : 0);
+   EOS_ASSERT(blocks.first_block_num() <= first_block && first_block <= last_block, block_log_exception,
+              "blocks.log does not contain blocks ${f} through ${l}", ("f", first_block)("l", last_block));
+
+   auto read_block = [&](uint32_t block_num) {
+      signed_block_ptr block = blocks.read_block_by_num(block_num);
+      EOS_ASSERT(block, block_log_exception, "block ${n} is missing from blocks.log", ("n", block_num));
+      return block;
+   };
+
+   const auto log_level = fc::logger::get(DEFAULT_LOGGER).get_log_level();
+   if(cfg.wasm_runtime == wasm_interface::vm_type::eos_vm_oc) {
+      // eos-vm-oc compiles each contract on its first execution; replay once untimed so that the timed replay finds
+      // every contract in the code cache, which is kept while the rest of the state is started over from the snapshot
+      ilog("compiling the contracts of blocks ${f} through ${l}", ("f", first_block)("l", last_block));
+      fc::logger::get(DEFAULT_LOGGER).set_log_level(fc::log_level::warn);
+      for(uint32_t block_num = first_block; block_num <= last_block; ++block_num) {
+         signed_block_ptr block = read_block(block_num);
+         controller::block_report br;
+         control->push_block(br, control->create_block_state(block->calculate_id(), block), [](const branch_type&) {},
+                             [](const transaction_id_type&) { return transaction_metadata_ptr{}; });
+      }
+      fc::logger::get(DEFAULT_LOGGER).set_log_level(log_level);
+      control.reset();
+
+      std::filesystem::remove_all(cfg.blocks_dir);
+      for(const auto& entry : std::filesystem::directory_iterator(cfg.state_dir)) {
+         if(entry.path().filename() != "code_cache.bin")
+            std::filesystem::remove_all(entry.path());
+      }
+      start_controller();
+   }
+
+   replayed_block current;
+   auto c = control->applied_transaction.connect([&](std::tuple<const transaction_trace_ptr&, const packed_transaction_ptr&> t) {
+      const auto& trace = std::get<0>(t);
+      ++current.trxs;
+      current.trx_us += trace->elapsed.count();
+      for(const auto& at : trace->action_traces) {
+         ++current.actions;
+         current.action_us += at.elapsed.count();
+      }
+   });
+
+   std::ofstream output_blocks;
+   if(!opt->output_file.empty()) {
+      output_blocks.open(opt->output_file.c_str());
+      EOS_ASSERT(!output_blocks.fail(), block_log_exception, "Unable to open file '${f}'", ("f", opt->output_file));
+      output_blocks << "block_num,trxs,actions,total_us,header_us,recovery_us,trx_us,action_us,other_us\n";
+   }
+
+   std::ofstream perf_control;
+   if(!opt->perf_control_fifo.empty()) {
+      perf_control.open(opt->perf_control_fifo.c_str());
+      EOS_ASSERT(!perf_control.fail(), block_log_exception, "Unable to open perf control fifo '${f}'", ("f", opt->perf_control_fifo));
+   }
+
+   ilog("replaying blocks ${f} through ${l}", ("f", first_block)("l", last_block));
+   fc::logger::get(DEFAULT_LOGGER).set_log_level(fc::log_level::warn);
+
+   std::vector<replayed_block> replayed;
+   replayed.reserve(last_block - first_block + 1);
+   if(perf_control.is_open())
+      perf_control << "enable" << std::endl;
+   const auto start = std::chrono::steady_clock::now();
+   for(uint32_t block_num = first_block; block_num <= last_block; ++block_num) {
+      signed_block_ptr block = read_block(block_num);
+      const auto id = block->calculate_id();
+
+      current = replayed_block{ .block_num = block_num };
+      const auto block_start = std::chrono::steady_clock::now();
+      auto bsp = control->create_block_state(id, block);
+      const auto header_done = std::chrono::steady_clock::now();
+
+      // recover the keys up front, as nodeos has done for transactions it received before the block, instead of
+      // overlapping the recovery with the transactions applied first
+      std::map<transaction_id_type, transaction_metadata_ptr> recovered;
+      {
+         std::vector<std::pair<transaction_id_type, recover_keys_future>> futures;
+         for(const auto& receipt : block->transactions) {
+            if(std::holds_alternative<packed_transaction>(receipt.trx)) {
+               const auto& pt = std::get<packed_transaction>(receipt.trx);
+               futures.emplace_back(pt.id(), transaction_metadata::start_recover_keys(packed_transaction_ptr(block, &pt), control->get_thread_pool(),
+                                                                                      chain_id, fc::microseconds::maximum(),
+                                                                                      transaction_metadata::trx_type::input));
+            }
+         }
+         for(auto& [trx_id, fut] : futures)
+            recovered.emplace(trx_id, fut.get());
+      }
+      const auto recovery_done = std::chrono::steady_clock::now();
+
+      controller::block_report br;
+      control->push_block(br, bsp, [](const branch_type&) {}, [&](const transaction_id_type& trx_id) {
+         auto itr = recovered.find(trx_id);
+         return itr == recovered.end() ? transaction_metadata_ptr{} : itr->second;
+      });
+      const auto block_done = std::chrono::steady_clock::now();
+
+      current.total_us    = std::chrono::duration_cast<std::chrono::microseconds>(block_done - block_start).count();
+      current.header_us   = std::chrono::duration_cast<std::chrono::microseconds>(header_done - block_start).count();
+      current.recovery_us = std::chrono::duration_cast<std::chrono::microseconds>(recovery_done - header_done).count();
+      current.other_us    = current.total_us - current.header_us - current.recovery_us - current.trx_us;
+      current.trx_us   -= current.action_us;
+      replayed.push_back(current);
+   }
+   const auto replay_us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+   if(perf_control.is_open())
+      perf_control << "disable" << std::endl;
+   fc::logger::get(DEFAULT_LOGGER).set_log_level(log_level);
+
+   replayed_block totals;
+   std::vector<int64_t> block_us;
+   block_us.reserve(replayed.size());
+   for(const auto& b : replayed) {
+      if(output_blocks.is_open()) {
+         output_blocks << b.block_num << ',' << b.trxs << ',' << b.actions << ',' << b.total_us << ',' << b.header_us << ','
+                       << b.recovery_us << ',' << b.trx_us << ',' << b.action_us << ',' << b.other_us << '\n';
+      }
+      totals.trxs        += b.trxs;
+      totals.actions     += b.actions;
+      totals.total_us    += b.total_us;
+      totals.header_us   += b.header_us;
+      totals.recovery_us += b.recovery_us;
+      totals.trx_us      += b.trx_us;
+      totals.action_us   += b.action_us;
+      totals.other_us    += b.other_us;
+      block_us.push_back(b.total_us);
+   }
+   std::sort(block_us.begin(), block_us.end());
+
+   auto share = [&](int64_t us) { return totals.total_us ? 100.0 * us / totals.total_us : 0.0; };
+   auto per_second = [&](uint64_t n) { return replay_us ? n * 1'000'000.0 / replay_us : 0.0; };
+   std::cout << std::fixed << std::setprecision(1)
+             << "blocks:        " << replayed.size() << " (" << first_block << " through " << last_block << ")\n"
+             << "transactions:  " << totals.trxs << "\n"
+             << "actions:       " << totals.actions << "\n"
+             << "elapsed:       " << replay_us / 1000 << " ms\n"
+             << "throughput:    " << per_second(replayed.size()) << " blocks/s, " << per_second(totals.trxs) << " trx/s, "
+                                  << per_second(totals.actions) << " actions/s\n"
+             << "block time:    p50 " << percentile(block_us, 50) << " us, p90 " << percentile(block_us, 90) << " us, p99 "
+                                  << percentile(block_us, 99) << " us, max " << (block_us.empty() ? 0 : block_us.back()) << " us\n"
+             << "time split:    header " << share(totals.header_us) << "%, key recovery " << share(totals.recovery_us) << "%, transactions " << share(totals.trx_us) << "%, actions "
+                                  << share(totals.action_us) << "%, other " << share(totals.other_us) << "%" << std::endl;
+
+   return 0;
+}
@@ -11,6 +11,10 @@ struct blocklog_options {
    uint32_t last_block = std::numeric_limits<uint32_t>::max();
    std::string output_dir = "";
    uint32_t stride = 100000;
+   std::string snapshot_file = "";
+   uint64_t db_size = 65536ull;
+   std::string wasm_runtime = "";
+   std::string perf_control_fifo = "";
 
    // flags
    bool no_pretty_print = false;
@@ -37,6 +41,7 @@ protected:
    int do_vacuum();
    int do_genesis();
    int read_log();
+   int replay();
 
    int split_blocks();
    int merge_blocks();
@@ -0,0 +1,226 @@
+#include "state_history.hpp"
+#include <eosio/state_history/compression.hpp>
+#include <eosio/state_history/log.hpp>
+
+#include <fc/io/fstream.hpp>
+#include <fc/io/raw.hpp>
+
+#include <boost/iostreams/device/array.hpp>
+#include <boost/iostreams/stream_buffer.hpp>
+
+#include <atomic>
+#include <fstream>
+#include <regex>
+#include <thread>
+
+using namespace eosio;
+using namespace eosio::chain;
+
+namespace {
+
+// trace_history.log, chain_state_history.log and their partitions, e.g. chain_state_history-1000001-2000000.log
+const std::regex log_file_pattern(R"((trace_history|chain_state_history)(-\d+-\d+)?\.log)");
+
+std::vector<std::filesystem::path> find_logs(const std::filesystem::path& dir) {
+   std::vector<std::filesystem::path> result;
+   for (const auto& entry : std::filesystem::directory_iterator(dir)) {
+      if (entry.is_regular_file() && std::regex_match(entry.path().filename().string(), log_file_pattern))
+         result.push_back(entry.path());
+   }
+   std::sort(result.begin(), result.end());
+   return result;
+}
+
+bool is_chain_state_log(const std::filesystem::path& log_file) {
+   return log_file.filename().string().starts_with("chain_state_history");
+}
+
+// call f with a streambuf of the decompressed entry at pos
+template <typename F>
+void read_entry(detail::state_history_log_data& data, uint64_t pos, F&& f) {
+   locked_decompress_stream entry{std::unique_lock<std::mutex>()};
+   data.ro_stream_at(pos, entry);
+   std::visit(overloaded{
+      [&](std::vector<char>& buf) {
+         bio::array_source       src(buf.data(), buf.size());
+         bio::stream_buffer<bio::array_source> sb(src);
+         f(sb);
+      },
+      [&](std::unique_ptr<bio::filtering_istreambuf>& buf) { f(*buf); }
+   }, entry.buf);
+}
+
+// fc::raw stream over an entry as it is decompressed, so that it need not be held in memory whole
+struct streambuf_reader {
+   std::streambuf& in;
+
+   bool read(char* d, size_t n) {
+      EOS_ASSERT(in.sgetn(d, n) == static_cast<std::streamsize>(n), plugin_exception, "truncated state history log entry");
+      return true;
+   }
+   bool get(char& c) { return read(&c, 1); }
+   bool get(unsigned char& c) { return read(reinterpret_cast<char*>(&c), 1); }
+};
+
+// rewrites every entry of log_file compressed with compression, replacing log_file and its index
+void recompress_log(const std::filesystem::path& log_file, const state_history::compression_config& compression) {
+   detail::state_history_log_data data(log_file);
+   EOS_ASSERT(!data.is_currently_pruned(), plugin_exception,
+              "${f} is pruned, recompressing pruned logs is not supported", ("f", log_file.string()));
+
+   const auto name    = log_file.stem().string();
+   const auto tmp_dir = log_file.parent_path() / (name + ".recompress");
+   std::filesystem::remove_all(tmp_dir);
+   std::filesystem::create_directories(tmp_dir);
+   {
+      state_history_log out(name.c_str(), tmp_dir, {}, compression);
+      block_id_type     prev_id;
+      std::vector<char> chunk(1024 * 1024);
+      for (uint64_t pos = 0; pos < data.size();) {
+         const uint64_t payload_size = data.payload_size_at(pos);
+         state_history_log_header header;
+         header.block_id = data.block_id_at(pos);
+         read_entry(data, pos, [&](std::streambuf& in) {
+            out.pack_and_write_entry(header, prev_id, [&](auto& buf) {
+               while (auto n = in.sgetn(chunk.data(), chunk.size()))
+                  bio::write(buf, chunk.data(), n);
+            });
+         });
+         prev_id = header.block_id;
+         pos += sizeof(state_history_log_header) + payload_size + sizeof(uint64_t);
+      }
+   }
+
+   auto index_file = log_file;
+   index_file.replace_extension(".index");
+   std::filesystem::rename(tmp_dir / log_file.filename(), log_file);
+   std::filesystem::rename(tmp_dir / index_file.filename(), index_file);
+   std::filesystem::remove_all(tmp_dir);
+}
+
+} // namespace
+
+void state_history_actions::setup(CLI::App& app) {
+   // callback helper with error code handling
+   auto err_guard = [this](int (state_history_actions::*fun)()) {
+      try {
+         int rc = (this->*fun)();
+         if(rc) throw(CLI::RuntimeError(rc));
+      } catch(...) {
+         print_exception();
+         throw(CLI::RuntimeError(-1));
+      }
+   };
+
+   auto* sub = app.add_subcommand("state-history", "State history log utility");
+   sub->require_subcommand();
+   sub->fallthrough();
+
+   // fallthrough options
+   sub->add_option("--state-history-dir", opt->state_history_dir, "The location of the state history logs, e.g. the state-history or retained directory (absolute path or relative to the current directory).")->capture_default_str();
+   sub->add_option("--zstd-dictionary", opt->zstd_dictionary, "zstd dictionary needed to read entries compressed with it, and used to compress chain state entries by recompress.");
+
+   // subcommand - recompress
+   auto* recompress = sub->add_subcommand("recompress", "Recompress all state history logs of 'state-history-dir' with the given codec, one log per thread. nodeos must not be running on the directory.")->callback([err_guard]() { err_guard(&state_history_actions::recompress); });
+   recompress->add_option("--compression", opt->compression, "Codec to compress the entries with, zlib or zstd.")->capture_default_str();
+   recompress->add_option("--compression-level", opt->compression_level, "Compression level, 0 for the default level of the codec.")->capture_default_str();
+   recompress->add_option("--threads", opt->threads, "Number of logs to recompress in parallel.")->capture_default_str();
+
+   // subcommand - train dictionary
+   auto* train = sub->add_subcommand("train-dictionary", "Train a zstd dictionary on the rows of chain_state_history.log of 'state-history-dir', for state-history-zstd-dictionary of nodeos.")->callback([err_guard]() { err_guard(&state_history_actions::train_dictionary); });
+   train->add_option("--output-file,-o", opt->output_file, "The file to write the dictionary to.")->required();
+   train->add_option("--max-samples", opt->max_samples, "Maximum number of rows to train on.")->capture_default_str();
+   train->add_option("--max-sample-bytes", opt->max_sample_bytes, "Maximum total size in bytes of the rows to train on.")->capture_default_str();
+   train->add_option("--max-size", opt->max_dictionary_size, "Maximum size of the dictionary in bytes.")->capture_default_str();
+}
+
+int state_history_actions::recompress() {
+   state_history::compression_config compression;
+   compression.codec = state_history::compression_codec_from_string(opt->compression);
+   compression.level = opt->compression_level;
+   EOS_ASSERT(state_history::is_supported(compression.codec), plugin_config_exception,
+              "${c} compression requires a build with ENABLE_ZSTD", ("c", opt->compression));
+   state_history::zstd_dictionary_ptr dictionary;
+   if (!opt->zstd_dictionary.empty())
+      dictionary = state_history::load_zstd_dictionary(opt->zstd_dictionary);
+
+   auto logs = find_logs(opt->state_history_dir);
+   if (logs.empty()) {
+      std::cerr << "no state history logs found in " << opt->state_history_dir << std::endl;
+      return -1;
+   }
+
+   std::atomic<size_t>             next = 0;
+   std::mutex                      mtx;
+   std::exception_ptr              failure;
+   std::vector<std::thread>        threads;
+   const uint32_t num_threads = std::clamp<uint32_t>(opt->threads, 1, logs.size());
+   for (uint32_t i = 0; i < num_threads; ++i) {
+      threads.emplace_back([&]() {
+         for (size_t n = next++; n < logs.size(); n = next++) {
+            try {
+               auto conf = compression;
+               // as in nodeos, the dictionary is only used for chain state entries
+               if (conf.codec == state_history::compression_codec::zstd && is_chain_state_log(logs[n]))
+                  conf.dictionary = dictionary;
+               ilog("recompressing ${f} with ${c}", ("f", logs[n].string())("c", opt->compression));
+               recompress_log(logs[n], conf);
+            } catch (...) {
+               std::lock_guard g(mtx);
+               if (!failure)
+                  failure = std::current_exception();
+               next = logs.size();
+            }
+         }
+      });
+   }
+   for (auto& t : threads)
+      t.join();
+   if (failure)
+      std::rethrow_exception(failure);
+   return 0;
+}
+
+int state_history_actions::train_dictionary() {
+   if (!opt->zstd_dictionary.empty())
+      state_history::load_zstd_dictionary(opt->zstd_dictionary);
+
+   const std::filesystem::path log_file = std::filesystem::path(opt->state_history_dir) / "chain_state_history.log";
+   detail::state_history_log_data data(log_file);
+
+   // a chain state entry is a vector of table deltas, each a vector of (present, row) pairs, see create_deltas.cpp;
+   // the first entry holds the whole chain state, it is read row by row only as far as the samples go
+   std::vector<bytes> samples;
+   uint64_t           sample_bytes = 0;
+   auto enough = [&]() { return samples.size() >= opt->max_samples || sample_bytes >= opt->max_sample_bytes; };
+   for (uint64_t pos = 0; pos < data.size() && !enough();) {
+      const uint64_t payload_size = data.payload_size_at(pos);
+      read_entry(data, pos, [&](std::streambuf& in) {
+         streambuf_reader ds{in};
+         fc::unsigned_int num_tables;
+         fc::raw::unpack(ds, num_tables);
+         for (uint32_t t = 0; t < num_tables.value && !enough(); ++t) {
+            fc::unsigned_int version, num_rows;
+            std::string      name;
+            fc::raw::unpack(ds, version);
+            fc::raw::unpack(ds, name);
+            fc::raw::unpack(ds, num_rows);
+            for (uint32_t r = 0; r < num_rows.value && !enough(); ++r) {
+               bool present;
+               fc::raw::unpack(ds, present);
+               fc::raw::unpack(ds, samples.emplace_back());
+               sample_bytes += samples.back().size();
+            }
+         }
+      });
+      pos += sizeof(state_history_log_header) + payload_size + sizeof(uint64_t);
+   }
+
+   auto dict = state_history::train_zstd_dictionary(samples, opt->max_dictionary_size);
+   std::ofstream out(opt->output_file, std::ios::binary);
+   out.write(dict.data(), dict.size());
+   EOS_ASSERT(out.good(), plugin_exception, "unable to write ${f}", ("f", opt->output_file));
+   ilog("wrote ${s} byte zstd dictionary ${id} trained on ${n} rows to ${f}",
+        ("s", dict.size())("id", state_history::zstd_dictionary(dict).id())("n", samples.size())("f", opt->output_file));
+   return 0;
+}
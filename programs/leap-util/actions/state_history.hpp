@@ -0,0 +1,24 @@
+#include "subcommand.hpp"
+
+struct state_history_options {
+   std::string state_history_dir = "state-history";
+   std::string compression = "zstd";
+   int compression_level = 0;
+   std::string zstd_dictionary = "";
+   uint32_t threads = 4;
+
+   std::string output_file = "";
+   uint32_t max_samples = 100000;
+   uint64_t max_sample_bytes = 128 * 1024 * 1024;
+   uint32_t max_dictionary_size = 112640;
+};
+
+class state_history_actions : public sub_command<state_history_options> {
+public:
+   state_history_actions() : sub_command() {}
+   void setup(CLI::App& app);
+
+   // callbacks
+   int recompress();
+   int train_dictionary();
+};
\ No newline at end of file
@@ -62,6 +62,15 @@ try:
     blockNum=100
     Print("Wait till we at least get to block %d" % (blockNum))
     node0.waitForBlock(blockNum, blockType=BlockType.lib)
+
+    Print("Create a snapshot to replay blocks from")
+    ret=node0.createSnapshot()
+    assert ret is not None, "Snapshot creation failed"
+    snapshotFile=ret["payload"]["snapshot_name"]
+    snapshotHeadBlockNum=ret["payload"]["head_block_num"]
+    replayBlocks=5
+    node0.waitForBlock(snapshotHeadBlockNum+replayBlocks, blockType=BlockType.lib)
+
     info=node0.getInfo(exitOnError=True)
     headBlockNum=info["head_block_num"]
     lib=info["last_irreversible_block_num"]
@@ -117,6 +126,25 @@ try:
     duplicateIndexStr=duplicateIndexFile.read()
     assert blockIndexStr==duplicateIndexStr, "Generated file \%%s\" didn't match original \"%s\"" % (duplicateIndexFileName, blockIndexFileName)
 
+    Print("Replay %d blocks following the snapshot" % (replayBlocks))
+    replayFileName=os.path.join(blockLogDir, "replay.csv")
+    lastReplayBlockNum=snapshotHeadBlockNum+replayBlocks
+    output=Utils.processLeapUtilCmd("block-log replay --blocks-dir %s --snapshot %s --last %d --output-file %s" %
+                                    (blockLogDir, snapshotFile, lastReplayBlockNum, replayFileName), "block-log replay", silentErrors=False)
+    assert output is not None, "block-log replay failed"
+    for expectedStr in ["blocks:        %d (%d through %d)" % (replayBlocks, snapshotHeadBlockNum+1, lastReplayBlockNum), "time split:"]:
+        assert output.find(expectedStr) != -1, "Couldn't find \"%s\" in:\n\"%s\"\n" % (expectedStr, output)
+    with open(replayFileName) as replayFile:
+        rows=[line.rstrip("\n").split(",") for line in replayFile]
+    expectedColumns=["block_num", "trxs", "actions", "total_us", "header_us", "recovery_us", "trx_us", "action_us", "other_us"]
+    assert rows[0]==expectedColumns, "Unexpected columns %s in \"%s\"" % (rows[0], replayFileName)
+    assert len(rows)==replayBlocks+1, "Expected %d blocks in \"%s\" but got %d" % (replayBlocks, replayFileName, len(rows)-1)
+    for i, row in enumerate(rows[1:]):
+        assert len(row)==len(expectedColumns), "Unexpected row %s in \"%s\"" % (row, replayFileName)
+        assert int(row[0])==snapshotHeadBlockNum+1+i, "Unexpected block number in row %s of \"%s\"" % (row, replayFileName)
+        assert int(row[1])>=1, "Every block has at least the onblock transaction, row %s of \"%s\"" % (row, replayFileName)
+    os.remove(replayFileName)
+
     try:
         Print("Head block num %d will not be in block log (it will be in reversible DB), so --trim will throw an exception" % (headBlockNum))
         output=cluster.getBlockLog(0, blockLogAction=BlockLogAction.trim, first=0, last=headBlockNum, throwException=True)
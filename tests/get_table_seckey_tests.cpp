@@ -98,4 +98,84 @@ BOOST_FIXTURE_TEST_CASE( get_table_next_key_test, validating_tester ) try {
 
 } FC_LOG_AND_RETHROW() /// get_table_next_key_test
 
+BOOST_FIXTURE_TEST_CASE( get_table_cursor_test, validating_tester ) try {
+   create_account("test"_n);
+
+   // setup contract and abi
+   set_code( "test"_n, test_contracts::get_table_seckey_test_wasm() );
+   set_abi( "test"_n, test_contracts::get_table_seckey_test_abi() );
+   produce_block();
+
+   // rows 0-4 share secondary key "a", paging with next_key would return them again on every page
+   for (uint64_t i = 0; i < 5; ++i)
+      push_action("test"_n, "addnumobj"_n, "test"_n, mutable_variant_object()("input", i)("nm", "a"));
+   push_action("test"_n, "addnumobj"_n, "test"_n, mutable_variant_object()("input", 5)("nm", "b"));
+   push_action("test"_n, "addnumobj"_n, "test"_n, mutable_variant_object()("input", 6)("nm", "c"));
+   produce_block();
+
+   chain_apis::read_only plugin(*(this->control), {}, fc::microseconds::maximum(), fc::microseconds::maximum(), {});
+   chain_apis::read_only::get_table_rows_params params{};
+   params.json = true;
+   params.code = "test"_n;
+   params.scope = "test";
+   params.table = "numobjs"_n;
+   params.key_type = "name";
+   params.index_position = "6";
+   params.limit = 2;
+
+   auto read_all_pages = [&](bool reverse) {
+      params.reverse = reverse;
+      params.cursor.clear();
+      std::vector<uint64_t> keys;
+      for (;;) {
+         auto res = get_table_rows_full(plugin, params, fc::time_point::maximum());
+         for (const auto& row : res.rows)
+            keys.push_back(row["key"].as_uint64());
+         BOOST_REQUIRE_EQUAL(res.more, res.next_cursor.has_value());
+         if (!res.more)
+            break;
+         params.cursor = *res.next_cursor;
+      }
+      return keys;
+   };
+
+   BOOST_REQUIRE(read_all_pages(false) == std::vector<uint64_t>({0, 1, 2, 3, 4, 5, 6}));
+   BOOST_REQUIRE(read_all_pages(true) == std::vector<uint64_t>({6, 5, 4, 3, 2, 1, 0}));
+
+   // a cursor resumes within the remaining bounds
+   params.reverse = false;
+   params.cursor.clear();
+   params.upper_bound = "a";
+   auto res = get_table_rows_full(plugin, params, fc::time_point::maximum());
+   BOOST_REQUIRE(res.next_cursor);
+   params.cursor = *res.next_cursor;
+   params.limit = 10;
+   res = get_table_rows_full(plugin, params, fc::time_point::maximum());
+   BOOST_REQUIRE_EQUAL(res.rows.size(), 3u);
+   BOOST_REQUIRE(!res.more);
+   BOOST_REQUIRE(!res.stats);
+
+   // cursors only resume the index and direction they were returned for
+   params.reverse = true;
+   BOOST_CHECK_THROW(plugin.get_table_rows(params, fc::time_point::maximum()), contract_table_query_exception);
+   params.reverse = false;
+   params.index_position = "primary";
+   params.key_type = "i64";
+   params.upper_bound.clear();
+   BOOST_CHECK_THROW(plugin.get_table_rows(params, fc::time_point::maximum()), contract_table_query_exception);
+   params.cursor = "not a cursor";
+   BOOST_CHECK_THROW(plugin.get_table_rows(params, fc::time_point::maximum()), contract_table_query_exception);
+
+   // binary rows and stats
+   params.cursor.clear();
+   params.json = false;
+   params.show_stats = true;
+   res = get_table_rows_full(plugin, params, fc::time_point::maximum());
+   BOOST_REQUIRE_EQUAL(res.rows.size(), 7u);
+   BOOST_REQUIRE(res.rows[0].is_string());
+   BOOST_REQUIRE(res.stats);
+   BOOST_REQUIRE_EQUAL(res.stats->rows, 7u);
+
+} FC_LOG_AND_RETHROW() /// get_table_cursor_test
+
 BOOST_AUTO_TEST_SUITE_END()
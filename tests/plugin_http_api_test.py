@@ -1134,6 +1134,31 @@ class PluginHttpTest(unittest.TestCase):
         ret_json = self.nodeos.processUrllibRequest(resource, command, payload, endpoint=endpoint)
         self.assertIn("trxs", ret_json["payload"])
 
+        # get_intrinsic_profile with empty parameter
+        command = "get_intrinsic_profile"
+        ret_json = self.nodeos.processUrllibRequest(resource, command, endpoint=endpoint)
+        self.assertIn("block_num", ret_json["payload"])
+        self.assertIn("entries", ret_json["payload"])
+        # get_intrinsic_profile with invalid parameter
+        ret_json = self.nodeos.processUrllibRequest(resource, command, self.http_post_invalid_param, endpoint=endpoint)
+        self.assertEqual(ret_json["code"], 400)
+        self.assertEqual(ret_json["error"]["code"], 3200006)
+
+        # get_oc_profile with empty parameter
+        command = "get_oc_profile"
+        ret_json = self.nodeos.processUrllibRequest(resource, command, endpoint=endpoint)
+        self.assertIn("running", ret_json["payload"])
+        self.assertIn("folded_stacks", ret_json["payload"])
+        # get_oc_profile with invalid parameter
+        ret_json = self.nodeos.processUrllibRequest(resource, command, self.http_post_invalid_param, endpoint=endpoint)
+        self.assertEqual(ret_json["code"], 400)
+        self.assertEqual(ret_json["error"]["code"], 3200006)
+
+        # stop_oc_profile with empty parameter
+        command = "stop_oc_profile"
+        ret_json = self.nodeos.processUrllibRequest(resource, command, endpoint=endpoint)
+        self.assertEqual(ret_json["payload"]["result"], "ok")
+
     # test all wallet api
     def test_WalletApi(self) :
         endpoint = self.base_wallet_cmd_str
@@ -23,11 +23,13 @@
 #include <eosio/chain/global_property_object.hpp>
 #include <eosio/chain/generated_transaction_object.hpp>
 #include <eosio/chain/wasm_interface.hpp>
+#include <eosio/chain/webassembly/intrinsic_profiler.hpp>
 #include <eosio/chain/resource_limits.hpp>
 
 #include <fc/crypto/digest.hpp>
 #include <fc/crypto/sha256.hpp>
 #include <fc/exception/exception.hpp>
+#include <fc/scoped_exit.hpp>
 #include <fc/variant_object.hpp>
 
 #include <Inline/BasicTypes.h>
@@ -2250,6 +2252,42 @@ BOOST_FIXTURE_TEST_CASE(db_notify_tests, validating_tester) {
    BOOST_TEST_REQUIRE(push_action( action({},"notifier"_n, name(), {}),"notifier"_n.to_uint64_t() ) == "");
 }
 
+// Lookups of tables and rows are memoized per action, they must follow the rows and tables stored and removed by the action.
+BOOST_FIXTURE_TEST_CASE(db_lookup_memo_tests, validating_tester) {
+   create_accounts( {"memo"_n} );
+   const char memo[] = R"=====(
+(module
+ (func $db_store_i64 (import "env" "db_store_i64") (param i64 i64 i64 i64 i32 i32) (result i32))
+ (func $db_find_i64 (import "env" "db_find_i64") (param i64 i64 i64 i64) (result i32))
+ (func $db_remove_i64 (import "env" "db_remove_i64") (param i32))
+ (func $eosio_assert (import "env" "eosio_assert") (param i32 i32))
+ (memory 1)
+ (func (export "apply") (param i64 i64 i64)
+  (call $eosio_assert (i32.eq (call $db_find_i64 (get_local 0) (i64.const 0) (i64.const 0) (i64.const 5)) (i32.const -1)) (i32.const 0))
+  (call $eosio_assert (i32.eq (call $db_store_i64 (i64.const 0) (i64.const 0) (get_local 0) (i64.const 5) (i32.const 0) (i32.const 0)) (i32.const 0)) (i32.const 32))
+  (call $eosio_assert (i32.eq (call $db_find_i64 (get_local 0) (i64.const 0) (i64.const 0) (i64.const 5)) (i32.const 0)) (i32.const 64))
+  (call $eosio_assert (i32.eq (call $db_find_i64 (get_local 0) (i64.const 0) (i64.const 0) (i64.const 6)) (i32.const -2)) (i32.const 96))
+  (call $db_remove_i64 (i32.const 0))
+  (call $eosio_assert (i32.eq (call $db_find_i64 (get_local 0) (i64.const 0) (i64.const 0) (i64.const 5)) (i32.const -1)) (i32.const 128))
+  (call $eosio_assert (i32.eq (call $db_store_i64 (i64.const 0) (i64.const 0) (get_local 0) (i64.const 6) (i32.const 0) (i32.const 0)) (i32.const 1)) (i32.const 160))
+  (call $eosio_assert (i32.eq (call $db_find_i64 (get_local 0) (i64.const 0) (i64.const 0) (i64.const 6)) (i32.const 1)) (i32.const 192))
+  (call $eosio_assert (i32.eq (call $db_find_i64 (get_local 0) (i64.const 0) (i64.const 0) (i64.const 5)) (i32.const -3)) (i32.const 224))
+ )
+ (data (i32.const 0) "memo: no table yet")
+ (data (i32.const 32) "memo: stored")
+ (data (i32.const 64) "memo: found stored")
+ (data (i32.const 96) "memo: not stored")
+ (data (i32.const 128) "memo: table removed")
+ (data (i32.const 160) "memo: stored again")
+ (data (i32.const 192) "memo: found stored again")
+ (data (i32.const 224) "memo: removed row")
+)
+)=====";
+   set_code("memo"_n, memo);
+
+   BOOST_TEST_REQUIRE(push_action( action({},"memo"_n, name(), {}),"memo"_n.to_uint64_t() ) == "");
+}
+
 /*************************************************************************************
  * multi_index_tests test case
  *************************************************************************************/
@@ -2403,6 +2441,40 @@ BOOST_FIXTURE_TEST_CASE(crypto_tests, validating_tester) { try {
    BOOST_REQUIRE_EQUAL( validate(), true );
 } FC_LOG_AND_RETHROW() }
 
+/*************************************************************************************
+ * intrinsic_profiler_tests test case
+ *************************************************************************************/
+BOOST_FIXTURE_TEST_CASE(intrinsic_profiler_tests, validating_tester) { try {
+   produce_block();
+   create_account("testapi"_n );
+   produce_block();
+   set_code("testapi"_n, test_contracts::test_api_wasm() );
+   produce_block();
+
+   webassembly::intrinsic_profiler::set_enabled(true);
+   auto disable = fc::make_scoped_exit([]() { webassembly::intrinsic_profiler::set_enabled(false); });
+
+   // test_sha256 hashes 4 messages, each time it is applied
+   CALL_TEST_FUNCTION( *this, "test_crypto", "test_sha256", {} );
+   auto profile = webassembly::intrinsic_profiler::take();
+   auto sha256 = std::find_if(profile.begin(), profile.end(), [](const auto& e) {
+      return e.contract == "testapi"_n && e.intrinsic == "sha256";
+   });
+   BOOST_REQUIRE(sha256 != profile.end());
+   BOOST_TEST(sha256->calls >= 4u);
+   BOOST_TEST(sha256->calls % 4 == 0u);
+   BOOST_TEST(sha256->cycles > 0u);
+   BOOST_TEST(std::is_sorted(profile.begin(), profile.end(), [](const auto& a, const auto& b) { return a.cycles > b.cycles; }));
+
+   // taking resets the counts
+   BOOST_TEST(webassembly::intrinsic_profiler::take().empty());
+
+   // nothing is counted while disabled
+   webassembly::intrinsic_profiler::set_enabled(false);
+   CALL_TEST_FUNCTION( *this, "test_crypto", "test_sha256", {} );
+   BOOST_TEST(webassembly::intrinsic_profiler::take().empty());
+} FC_LOG_AND_RETHROW() }
+
 /*************************************************************************************
  * memory_tests test case
  *************************************************************************************/
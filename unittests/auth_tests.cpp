@@ -327,6 +327,30 @@ BOOST_AUTO_TEST_CASE(link_then_update_auth) { try {
 
 } FC_LOG_AND_RETHROW() }
 
+BOOST_AUTO_TEST_CASE(update_auth_within_block) { try {
+   validating_tester chain;
+
+   chain.create_account(name("alice"));
+   chain.produce_block();
+
+   const auto new_priv_key = chain.get_private_key(name("alice"), "new");
+   const auto new_pub_key = new_priv_key.get_public_key();
+
+   // Satisfied by the active key, the outcome is remembered for the rest of the block
+   chain.push_dummy(name("alice"), "1");
+
+   // Update "active" auth public key in the same block
+   chain.set_authority(name("alice"), name("active"), authority{new_pub_key}, name("owner"),
+                       { permission_level{"alice"_n, name("owner")} }, { chain.get_private_key(name("alice"), "owner") });
+
+   // A remembered outcome of the previous "active" auth must not be used
+   BOOST_CHECK_THROW(chain.push_dummy(name("alice"), "2"), unsatisfied_authorization);
+   chain.push_reqauth(name("alice"), { permission_level{"alice"_n, name("active")} }, { new_priv_key });
+
+   chain.produce_block();
+
+} FC_LOG_AND_RETHROW() }
+
 BOOST_AUTO_TEST_CASE(create_account) {
 try {
    validating_tester chain;
@@ -776,6 +776,71 @@ static const char memory_growth_memset_test[] = R"=====(
 )
 )=====";
 
+static const char memory_dirty_pages_wast[] = R"=====(
+(module
+ (export "apply" (func $apply))
+ (import "env" "eosio_assert" (func $eosio_assert (param i32 i32)))
+ (import "env" "read_action_data" (func $read_action_data (param i32 i32) (result i32)))
+ (memory $0 32)
+ (data (i32.const 16) "d")
+ (func $apply (param $0 i64)(param $1 i64)(param $2 i64)
+   ;; data segment, a page written by wasm code and a page written by a host function must all be reset
+   (call $eosio_assert (i32.eq (i32.load8_u offset=16 (i32.const 0)) (i32.const 100)) (i32.const 0))
+   (call $eosio_assert (i64.eqz (i64.load offset=1310720 (i32.const 0))) (i32.const 0))
+   (call $eosio_assert (i64.eqz (i64.load offset=1638400 (i32.const 0))) (i32.const 0))
+   (i32.store8 offset=16 (i32.const 0) (i32.const 0))
+   (i64.store offset=1310720 (i32.const 0) (i64.const -1))
+   (drop (call $read_action_data (i32.const 1638400) (i32.const 8)))
+ )
+)
+)=====";
+
+static const char memory_intrinsics_constant_length_wast[] = R"=====(
+(module
+ (export "apply" (func $apply))
+ (import "env" "eosio_assert" (func $eosio_assert (param i32 i32)))
+ (import "env" "memcpy" (func $memcpy (param i32 i32 i32) (result i32)))
+ (import "env" "memmove" (func $memmove (param i32 i32 i32) (result i32)))
+ (import "env" "memset" (func $memset (param i32 i32 i32) (result i32)))
+ (import "env" "memcmp" (func $memcmp (param i32 i32 i32) (result i32)))
+ (memory $0 1)
+ (data (i32.const 0) "0123456789abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ+-0123456789abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ+-")
+ (data (i32.const 1024) "ZZZZZZZZZZZZZZZZZZZZZZZZZZZZZZZZZZZZZZZZZZZZZZZ")
+ (func $apply (param $0 i64)(param $1 i64)(param $2 i64)
+   ;; action 1: overlapping memcpy, actions 2, 3 and 4: out of bounds memcpy, memset and memmove
+   (if (i64.eq (get_local $2) (i64.const 1)) (then (drop (call $memcpy (i32.const 100) (i32.const 90) (i32.const 16))) (return)))
+   (if (i64.eq (get_local $2) (i64.const 2)) (then (drop (call $memcpy (i32.const 65530) (i32.const 0) (i32.const 16))) (return)))
+   (if (i64.eq (get_local $2) (i64.const 3)) (then (drop (call $memset (i32.const 65530) (i32.const 0) (i32.const 16))) (return)))
+   (if (i64.eq (get_local $2) (i64.const 4)) (then (drop (call $memmove (i32.const 0) (i32.const 65530) (i32.const 16))) (return)))
+
+   ;; every access width is taken by one of the lengths, the destination is returned and the byte past it is untouched
+   (call $eosio_assert (i32.eq (call $memcpy (i32.const 256) (i32.const 0) (i32.const 1)) (i32.const 256)) (i32.const 0))
+   (call $eosio_assert (i32.eqz (call $memcmp (i32.const 256) (i32.const 0) (i32.const 1))) (i32.const 0))
+   (call $eosio_assert (i32.eqz (i32.load8_u offset=257 (i32.const 0))) (i32.const 0))
+   (drop (call $memcpy (i32.const 300) (i32.const 1) (i32.const 31)))
+   (call $eosio_assert (i32.eqz (call $memcmp (i32.const 300) (i32.const 1) (i32.const 31))) (i32.const 0))
+   (call $eosio_assert (i32.eqz (i32.load8_u offset=331 (i32.const 0))) (i32.const 0))
+   (drop (call $memcpy (i32.const 400) (i32.const 3) (i32.const 64)))
+   (call $eosio_assert (i32.eqz (call $memcmp (i32.const 400) (i32.const 3) (i32.const 64))) (i32.const 0))
+   (call $eosio_assert (i32.eqz (i32.load8_u offset=464 (i32.const 0))) (i32.const 0))
+   (drop (call $memcpy (i32.const 600) (i32.const 0) (i32.const 65)))
+   (call $eosio_assert (i32.eqz (call $memcmp (i32.const 600) (i32.const 0) (i32.const 65))) (i32.const 0))
+
+   (call $eosio_assert (i32.eq (call $memset (i32.const 512) (i32.const 0x15a) (i32.const 47)) (i32.const 512)) (i32.const 0))
+   (call $eosio_assert (i32.eqz (call $memcmp (i32.const 512) (i32.const 1024) (i32.const 47))) (i32.const 0))
+   (call $eosio_assert (i32.eqz (i32.load8_u offset=559 (i32.const 0))) (i32.const 0))
+
+   ;; overlapping memmove, forwards and backwards
+   (drop (call $memcpy (i32.const 2048) (i32.const 0) (i32.const 64)))
+   (call $eosio_assert (i32.eq (call $memmove (i32.const 2049) (i32.const 2048) (i32.const 40)) (i32.const 2049)) (i32.const 0))
+   (call $eosio_assert (i32.eqz (call $memcmp (i32.const 2049) (i32.const 0) (i32.const 40))) (i32.const 0))
+   (drop (call $memcpy (i32.const 3072) (i32.const 0) (i32.const 64)))
+   (drop (call $memmove (i32.const 3072) (i32.const 3075) (i32.const 40)))
+   (call $eosio_assert (i32.eqz (call $memcmp (i32.const 3072) (i32.const 3) (i32.const 40))) (i32.const 0))
+ )
+)
+)=====";
+
 static const char large_maligned_host_ptr[] = R"=====(
 (module
  (export "apply" (func $$apply))
@@ -838,6 +903,32 @@ static const char depth_assert_intrinsic[] = R"=====(
 )
 )=====";
 
+static const char depth_assert_memcpy[] = R"=====(
+(module
+ (import "env" "memcpy" (func $$memcpy (param i32 i32 i32) (result i32)))
+ (memory $$0 1)
+ (export "apply" (func $$apply))
+ (func $$apply (param $$0 i64) (param $$1 i64) (param $$2 i64)
+  (if (i64.eq (get_global $$depth) (i64.const 1)) (then
+    (drop (call $$memcpy (i32.const 64) (i32.const 0) (i32.const 16)))
+    (return)
+  ))
+  (set_global $$depth
+   (i64.sub
+    (get_global $$depth)
+    (i64.const 1)
+   )
+  )
+  (call $$apply
+   (get_local $$0)
+   (get_local $$1)
+   (get_local $$2)
+  )
+ )
+ (global $$depth (mut i64) (i64.const ${MAX_DEPTH}))
+)
+)=====";
+
 static const char depth_assert_wasm_float[] = R"=====(
 (module
  (export "apply" (func $$apply))
@@ -0,0 +1,102 @@
+#ifdef EOSIO_EOS_VM_OC_RUNTIME_ENABLED
+
+#include <eosio/chain/webassembly/eos-vm-oc/profiler.hpp>
+#include <eosio/testing/tester.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <signal.h>
+
+using namespace eosio;
+using namespace eosio::chain;
+using namespace eosio::testing;
+
+static const char busy_loop_wast[] = R"=====(
+(module
+ (export "apply" (func $apply))
+ (func $apply (param $0 i64) (param $1 i64) (param $2 i64)
+  (local $i i32)
+  (set_local $i (i32.const 10000000))
+  (loop $l
+   (set_local $i (i32.sub (get_local $i) (i32.const 1)))
+   (br_if $l (get_local $i))
+  )
+ )
+)
+)=====";
+
+BOOST_AUTO_TEST_SUITE(eosvmoc_profiler_tests)
+
+BOOST_AUTO_TEST_CASE( samples_contract_code ) { try {
+   validating_tester chain;
+   // with OC tierup the action may run before its code is compiled, only OC as the runtime samples deterministically
+   if (chain.get_config().wasm_runtime != wasm_interface::vm_type::eos_vm_oc)
+      return;
+
+   chain.create_accounts({"busy"_n});
+   chain.set_code("busy"_n, busy_loop_wast);
+   chain.produce_block();
+
+   eosvmoc::profiler::clear();
+   eosvmoc::profiler::start(100);
+
+   auto run_busy = [&]() {
+      signed_transaction trx;
+      trx.actions.emplace_back(vector<permission_level>{{"busy"_n, config::active_name}}, "busy"_n, ""_n, bytes{});
+      chain.set_transaction_headers(trx);
+      trx.sign(chain.get_private_key("busy"_n, "active"), chain.control->get_chain_id());
+      chain.push_transaction(trx);
+      chain.produce_block();
+   };
+   run_busy();
+
+   eosvmoc::profiler::stop();
+   const eosvmoc::profiler::profile p = eosvmoc::profiler::get();
+   BOOST_CHECK(!p.running);
+   BOOST_REQUIRE_GT(p.total_samples, 0u);
+
+   // the action has no imports, so its apply is the first wasm function
+   const digest_type code_hash = chain.control->db().get<account_metadata_object, by_name>("busy"_n).code_hash;
+   const std::string busy_apply = "busy;" + code_hash.str() + ";wasm-function[0] ";
+   BOOST_CHECK(std::any_of(p.folded_stacks.begin(), p.folded_stacks.end(), [&](const std::string& s) {
+      return s.starts_with(busy_apply);
+   }));
+
+   // stopped, nothing more is sampled
+   run_busy();
+   BOOST_CHECK_EQUAL(eosvmoc::profiler::get().total_samples, p.total_samples);
+
+   eosvmoc::profiler::clear();
+   BOOST_CHECK_EQUAL(eosvmoc::profiler::get().total_samples, 0u);
+} FC_LOG_AND_RETHROW() }
+
+namespace {
+volatile sig_atomic_t previous_handler_calls = 0;
+void counting_sigprof_handler(int) { ++previous_handler_calls; }
+}
+
+BOOST_AUTO_TEST_CASE( forwards_to_previous_sigprof_handler ) { try {
+   struct sigaction counting = {}, original;
+   counting.sa_handler = counting_sigprof_handler;
+   sigemptyset(&counting.sa_mask);
+   sigaction(SIGPROF, &counting, &original);
+
+   // a SIGPROF taken outside of OC code goes to the handler installed before the profiler's
+   eosvmoc::profiler::start(1000000);
+   previous_handler_calls = 0;
+   raise(SIGPROF);
+   BOOST_CHECK_EQUAL(previous_handler_calls, 1);
+
+   // a profiler installing its handler after a start is forwarded to again on the next start
+   sigaction(SIGPROF, &counting, nullptr);
+   eosvmoc::profiler::start(1000000);
+   raise(SIGPROF);
+   BOOST_CHECK_EQUAL(previous_handler_calls, 2);
+
+   eosvmoc::profiler::stop();
+   eosvmoc::profiler::clear();
+   sigaction(SIGPROF, &original, nullptr);
+} FC_LOG_AND_RETHROW() }
+
+BOOST_AUTO_TEST_SUITE_END()
+
+#endif
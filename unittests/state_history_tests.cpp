@@ -4,6 +4,7 @@
 #include <contracts.hpp>
 #include <test_contracts.hpp>
 #include <eosio/state_history/create_deltas.hpp>
+#include <eosio/state_history/filter.hpp>
 #include <eosio/state_history/log.hpp>
 #include <eosio/state_history/trace_converter.hpp>
 #include <eosio/testing/tester.hpp>
@@ -16,6 +17,8 @@
 #include <eosio/ship_protocol.hpp>
 #include <boost/iostreams/device/back_inserter.hpp>
 #include <boost/iostreams/copy.hpp>
+#include <boost/iostreams/device/array.hpp>
+#include <boost/iostreams/stream_buffer.hpp>
 
 using namespace eosio::chain;
 using namespace eosio::testing;
@@ -851,4 +854,74 @@ BOOST_AUTO_TEST_CASE(test_corrupted_log_recovery) {
    BOOST_CHECK(get_decompressed_entry(new_chain.chain_state_log,10).size());
 }
 
+
+BOOST_AUTO_TEST_CASE(test_filtered_entries) {
+   fc::temp_directory   state_history_dir;
+   state_history_tester chain(state_history_dir.path(), eosio::state_history_log_config{});
+   chain.produce_block();
+
+   chain.create_account("tester"_n);
+   chain.set_code("tester"_n, test_contracts::get_table_test_wasm());
+   chain.set_abi("tester"_n, test_contracts::get_table_test_abi());
+   chain.produce_block();
+
+   chain.push_action("tester"_n, "addhashobj"_n, "tester"_n, mutable_variant_object()("hashinput", "hello"));
+   chain.push_action("tester"_n, "addnumobj"_n, "tester"_n, mutable_variant_object()("input", 2));
+   chain.produce_block();
+   const auto block_num = chain.control->head_block_num();
+
+   eosio::state_history::get_blocks_request_v1 req;
+   req.contracts = {"tester"_n};
+   req.tables    = {"numobjs"_n};
+   req.actions   = {"addnumobj"_n};
+   eosio::state_history::entry_filter filter(req);
+   BOOST_REQUIRE(!filter.empty());
+
+   // only the rows of numobjs and its secondary indices are left
+   auto deltas_entry    = get_decompressed_entry(chain.chain_state_log, block_num);
+   auto filtered_deltas = filter.filter_deltas({deltas_entry.data(), deltas_entry.size()});
+   BOOST_CHECK_LT(filtered_deltas.size(), deltas_entry.size());
+
+   std::vector<eosio::state_history::table_delta> deltas;
+   fc::datastream<const char*>                    ds(filtered_deltas.data(), filtered_deltas.size());
+   fc::raw::unpack(ds, deltas);
+   std::map<std::string, size_t> rows_by_table;
+   for (const auto& delta : deltas) {
+      BOOST_CHECK(delta.name.starts_with("contract_"));
+      for (const auto& row : delta.rows.obj) {
+         uint64_t code, table;
+         memcpy(&code, row.second.data() + 1, sizeof(code));
+         memcpy(&table, row.second.data() + 1 + 2 * sizeof(uint64_t), sizeof(table));
+         BOOST_CHECK_EQUAL(name(code), "tester"_n);
+         BOOST_CHECK_EQUAL(name(table & ~uint64_t(0xf)), "numobjs"_n);
+      }
+      rows_by_table[delta.name] = delta.rows.obj.size();
+   }
+   BOOST_CHECK_EQUAL(rows_by_table["contract_table"], 4u);
+   BOOST_CHECK_EQUAL(rows_by_table["contract_row"], 1u);
+
+   // only the transaction calling addnumobj is left, and it still parses
+   auto traces_entry    = get_decompressed_entry(chain.traces_log, block_num);
+   auto filtered_traces = filter.filter_traces({traces_entry.data(), traces_entry.size()});
+
+   std::vector<eosio::ship_protocol::transaction_trace> traces;
+   eosio::input_stream traces_bin{filtered_traces.data(), filtered_traces.data() + filtered_traces.size()};
+   BOOST_REQUIRE_NO_THROW(from_bin(traces, traces_bin));
+   BOOST_REQUIRE_EQUAL(traces.size(), 1u);
+   const auto& action_traces = std::get<eosio::ship_protocol::transaction_trace_v0>(traces[0]).action_traces;
+   BOOST_REQUIRE_EQUAL(action_traces.size(), 1u);
+   std::visit([](const auto& at) { BOOST_CHECK_EQUAL(at.act.name.to_string(), "addnumobj"); }, action_traces[0]);
+
+   // entries filtered as they are read give the same result as the ones filtered in memory
+   auto filter_stream = [&](const bytes& entry, bool is_deltas) {
+      boost::iostreams::stream_buffer<boost::iostreams::array_source> in(entry.data(), entry.size());
+      return is_deltas ? filter.filter_deltas(in) : filter.filter_traces(in);
+   };
+   BOOST_CHECK(filter_stream(deltas_entry, true) == filtered_deltas);
+   BOOST_CHECK(filter_stream(traces_entry, false) == filtered_traces);
+
+   // a request without filters leaves the entries alone
+   BOOST_CHECK(eosio::state_history::entry_filter(eosio::state_history::get_blocks_request_v1{}).empty());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
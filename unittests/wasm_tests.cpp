@@ -1473,6 +1473,62 @@ BOOST_FIXTURE_TEST_CASE( mem_growth_memset, validating_tester ) try {
    }
 } FC_LOG_AND_RETHROW()
 
+/**
+ * memcpy, memmove and memset of constant lengths behave the same however a runtime calls them
+ */
+BOOST_FIXTURE_TEST_CASE( memory_intrinsics_constant_length, validating_tester ) try {
+   produce_blocks(2);
+
+   create_accounts( {"memops"_n} );
+   produce_block();
+
+   set_code("memops"_n, memory_intrinsics_constant_length_wast);
+   produce_blocks(1);
+
+   BOOST_CHECK_EQUAL( push_action( action({}, "memops"_n, name(), {}), "memops"_n.to_uint64_t() ), success() );
+   BOOST_CHECK_EQUAL( push_action( action({}, "memops"_n, name(1), {}), "memops"_n.to_uint64_t() ),
+                      error("memcpy can only accept non-aliasing pointers") );
+
+   // the inline accesses fault as the intrinsics' own pointer checks do
+   for(uint64_t oob : {2, 3, 4}) {
+      signed_transaction trx;
+      trx.actions.emplace_back(vector<permission_level>{{"memops"_n,config::active_name}}, "memops"_n, name(oob), bytes{});
+      set_transaction_headers(trx);
+      trx.sign(get_private_key( "memops"_n, "active" ), control->get_chain_id());
+      BOOST_CHECK_EXCEPTION(push_transaction(trx), wasm_execution_error, fc_exception_message_is("access violation"));
+   }
+   produce_block();
+
+   BOOST_REQUIRE_EQUAL( validate(), true );
+} FC_LOG_AND_RETHROW()
+
+/**
+ * Prove that pages of a larger initial memory, written by wasm code or by host functions, are wiped between runs
+ */
+BOOST_FIXTURE_TEST_CASE( mem_dirty_pages_reset, validating_tester ) try {
+   produce_blocks(2);
+
+   create_accounts( {"dirty"_n} );
+   produce_block();
+
+   set_code("dirty"_n, memory_dirty_pages_wast);
+   produce_blocks(1);
+
+   for (uint64_t i = 1; i <= 5; i++) {
+      signed_transaction trx;
+      action act;
+      act.account = "dirty"_n;
+      act.name = ""_n;
+      act.authorization = vector<permission_level>{{"dirty"_n,config::active_name}};
+      act.data = fc::raw::pack(i);
+      trx.actions.push_back(act);
+      set_transaction_headers(trx);
+      trx.sign(get_private_key( "dirty"_n, "active" ), control->get_chain_id());
+      push_transaction(trx);
+   }
+   produce_blocks(1);
+} FC_LOG_AND_RETHROW()
+
 INCBIN(fuzz1, "fuzz1.wasm");
 INCBIN(fuzz2, "fuzz2.wasm");
 INCBIN(fuzz3, "fuzz3.wasm");
@@ -1734,6 +1790,17 @@ BOOST_DATA_TEST_CASE( depth_tests, bdata::make({setup_policy::preactivate_featur
    t.set_code("depth"_n, intrinsic_depth_one_over.c_str());
    BOOST_CHECK_THROW(pushit(), wasm_execution_error);
 
+   //same with a constant length memcpy, which OC emits inline, as the intrinsic
+   string memcpy_depth_okay = fc::format_string(depth_assert_memcpy, fc::mutable_variant_object()
+                                              ("MAX_DEPTH", eosio::chain::wasm_constraints::maximum_call_depth));
+   t.set_code("depth"_n, memcpy_depth_okay.c_str());
+   pushit();
+
+   string memcpy_depth_one_over = fc::format_string(depth_assert_memcpy, fc::mutable_variant_object()
+                                              ("MAX_DEPTH", eosio::chain::wasm_constraints::maximum_call_depth+1));
+   t.set_code("depth"_n, memcpy_depth_one_over.c_str());
+   BOOST_CHECK_THROW(pushit(), wasm_execution_error);
+
    //add a float operation in the mix to ensure any injected softfloat call doesn't count against limit
    string wasm_float_depth_okay = fc::format_string(depth_assert_wasm_float, fc::mutable_variant_object()
                                               ("MAX_DEPTH", eosio::chain::wasm_constraints::maximum_call_depth));